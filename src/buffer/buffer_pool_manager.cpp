@@ -13,20 +13,43 @@
 #include "buffer/buffer_pool_manager.h"
 
 #include <algorithm>
+#include <cstring>
 #include <list>
-#include <mutex>  // NOLINT
-#include <unordered_map>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
 #include <vector>
 
 namespace bustub {
 
-BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
-  // std::lock_guard<std::mutex> guardo(latch);
+BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager,
+                                     ReplacerPolicy replacer_policy)
+    : BufferPoolManager(pool_size, 1, 0, disk_manager, log_manager, replacer_policy) {}
+
+BufferPoolManager::BufferPoolManager(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                                     DiskManager *disk_manager, LogManager *log_manager, ReplacerPolicy replacer_policy)
+    : pool_size_(pool_size),
+      num_instances_(num_instances),
+      instance_index_(instance_index),
+      next_page_id_(static_cast<page_id_t>(instance_index)),
+      disk_manager_(disk_manager),
+      log_manager_(log_manager),
+      page_table_(pool_size) {
+  BUSTUB_ASSERT(num_instances > 0, "A standalone buffer pool is a parallel buffer pool with a single instance.");
+  BUSTUB_ASSERT(instance_index < num_instances, "The instance index must be smaller than the number of instances.");
 
   // We allocate a consecutive memory space for the buffer pool.
   pages_ = new Page[pool_size_];
-  replacer_ = new LRUReplacer();
+  switch (replacer_policy) {
+    case ReplacerPolicy::LRU:
+      replacer_ = new LRUReplacer(pool_size);
+      break;
+    case ReplacerPolicy::CLOCK:
+      replacer_ = new ClockReplacer(pool_size);
+      break;
+    case ReplacerPolicy::LRU_K:
+      replacer_ = new LRUKReplacer(pool_size);
+      break;
+  }
 
   // Initially, every page is in the free list.
   for (size_t i = 0; i < pool_size_; ++i) {
@@ -35,94 +58,121 @@ BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager
 }
 
 BufferPoolManager::~BufferPoolManager() {
+  StopPrefetchThreads();
+  StopBackgroundWriter();
   delete[] pages_;
   delete replacer_;
 }
 
-Page *BufferPoolManager::FetchPage(page_id_t page_id) {
-  std::lock_guard<std::mutex> guardo(latch_);
-  // 1.     Search the page table for the requested page (P).
-  // 1.1    If P exists, pin it and return it immediately.
-  Page *page = nullptr;
+Page *BufferPoolManager::FetchPage(page_id_t page_id, BufferAccessStrategy *strategy) {
+  // 0.     If the requested page (P) is resident, pin it without taking the latch.
+  Page *page = PinResidentPage(page_id);
+  if (page != nullptr) {
+    return page;
+  }
+
+  std::unique_lock<std::mutex> guardo(latch_);
+  // 1.     Search the page table for P again, now that nobody can change it.
+  // 1.1    If P exists, pin it and return it as soon as no other thread is reading it in anymore.
   frame_id_t frame_id;
-  if (page_table_.count(page_id) > 0) {
-    frame_id = page_table_.at(page_id);
-    replacer_->Pin(frame_id);
+  if (page_table_.Find(page_id, &frame_id)) {
     page = &pages_[frame_id];
     page->pin_count_++;
+    page->io_cv_.wait(guardo, [page] { return !page->io_in_progress_; });
     return page;
   }
 
-  // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer.
-  //        Note that pages are always found from the free list first.
-  if (!free_list_.empty()) {
-    frame_id = free_list_.front();
-    free_list_.pop_front();
+  // 1.2    If P does not exist, find a replacement page (R) from either the strategy's ring, the free list or the
+  //        replacer. A ring frame is only reused if it still holds the page the ring put there and is unpinned.
+  //        Otherwise pages are always found from the free list first.
+  BufferAccessStrategy::RingSlot *slot = strategy == nullptr ? nullptr : strategy->NextSlot();
+  if (slot != nullptr && slot->owner_ == this && pages_[slot->frame_id_].page_id_ == slot->page_id_ &&
+      ClaimFrame(slot->frame_id_)) {
+    frame_id = slot->frame_id_;
+    replacer_->Remove(frame_id);
     page = &pages_[frame_id];
-  } else if (replacer_->Victim(&frame_id)) {
+  } else if (FindFreeFrame(&frame_id)) {
     page = &pages_[frame_id];
   } else {
     //    If no page can be replaced, return nullptr
     return page;
   }
 
-  // 2.     If R is dirty, write it back to the disk.
-  if (page->IsDirty()) {
-    disk_manager_->WritePage(page->GetPageId(), page->data_);
+  // 2.     Hand the frame over from R to P in the page table, and mark it as having I/O in progress.
+  page_id_t victim_page_id = ReserveFrame(frame_id, page_id);
+  if (slot != nullptr) {
+    slot->owner_ = this;
+    slot->frame_id_ = frame_id;
+    slot->page_id_ = page_id;
   }
 
-  // 3.     Delete R from the page table and insert P.
-  page_table_.erase(page->GetPageId());
-  page_table_[page_id] = frame_id;
-
-  // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
-  page->pin_count_ = 1;
-  page->is_dirty_ = false;
-  page->page_id_ = page_id;
+  // 3.     If R is dirty, write it back, and then read in P. Both transfers happen without holding the latch, so that
+  //        other threads can use the buffer pool meanwhile. P is read only once the last write of P has completed.
+  guardo.unlock();
+  if (victim_page_id != INVALID_PAGE_ID) {
+    WriteBackVictim(victim_page_id, page->data_);
+  }
+  WaitForBackgroundWrite(page_id);
   disk_manager_->ReadPage(page_id, page->data_);
+
+  // 4.     Wake up the threads that fetched P in the meantime, and return a pointer to P.
+  guardo.lock();
+  FinishIO(page);
   return page;
 }
 
 bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
-  // need to check whether page_id exists?
-  std::lock_guard<std::mutex> guardo(latch_);
-  frame_id_t frame_id = page_table_.at(page_id);
-  Page *page = &pages_[frame_id];
-  if (page == nullptr) {
-    return false;
+  // As long as the caller holds a pin, the frame of the page cannot change, so a lookup without the latch that finds
+  // the page is good. A miss may be spurious though, so confirm it under the latch.
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id) || pages_[frame_id].page_id_ != page_id) {
+    std::lock_guard<std::mutex> guardo(latch_);
+    if (!page_table_.Find(page_id, &frame_id)) {
+      return false;
+    }
   }
-  if (page->pin_count_ <= 0) {
+  Page *page = &pages_[frame_id];
+  int pin_count = page->pin_count_;
+  if (pin_count <= 0) {
     return false;
   }
-  page->pin_count_--;
-  if (!page->is_dirty_) {
-    page->is_dirty_ = is_dirty;
+  // Mark the page dirty before dropping the pin, so that whoever evicts the page afterwards sees the flag.
+  if (is_dirty) {
+    page->is_dirty_ = true;
   }
-  if (page->pin_count_ == 0) {
-    replacer_->Unpin(frame_id);
+  do {
+    if (pin_count <= 0) {
+      return false;
+    }
+  } while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count - 1));
+  if (pin_count == 1) {
+    MakeEvictable(frame_id);
   }
   return true;
 }
 
 bool BufferPoolManager::FlushPage(page_id_t page_id) {
-  std::lock_guard<std::mutex> guardo(latch_);
+  std::unique_lock<std::mutex> guardo(latch_);
   // Make sure you call DiskManager::WritePage!
-  if (page_table_.count(page_id) > 0) {
-    frame_id_t frame_id = page_table_.at(page_id);
-    Page *page = &pages_[frame_id];
-    // check whether page->page_id_ is invalid?
-    disk_manager_->WritePage(page_id, page->data_);
-    page->is_dirty_ = false;
-    return true;
+  // A page that is still being read in has no contents to flush yet, so wait for it first.
+  frame_id_t frame_id;
+  bool found = page_table_.Find(page_id, &frame_id);
+  while (found && pages_[frame_id].io_in_progress_) {
+    pages_[frame_id].io_cv_.wait(guardo);
+    found = page_table_.Find(page_id, &frame_id);
   }
-  return false;
+  if (!found) {
+    return false;
+  }
+  // Pin the page, so that it stays in its frame while it is written without the latch.
+  pages_[frame_id].pin_count_++;
+  guardo.unlock();
+  WriteBack(frame_id);
+  return true;
 }
 
 Page *BufferPoolManager::NewPage(page_id_t *page_id) {
-  std::lock_guard<std::mutex> guardo(latch_);
-  // 0.   Make sure you call DiskManager::AllocatePage!
-  *page_id = disk_manager_->AllocatePage();
-
+  std::unique_lock<std::mutex> guardo(latch_);
   // 1.   If all the pages in the buffer pool are pinned, return nullptr.
   Page *page = nullptr;
   if (free_list_.empty() && replacer_->Size() == 0) {
@@ -130,30 +180,28 @@ Page *BufferPoolManager::NewPage(page_id_t *page_id) {
   }
 
   // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
+  //      This still fails if every frame left in the replacer was pinned since it entered the replacer.
   frame_id_t frame_id;
-  if (free_list_.empty()) {
-    replacer_->Victim(&frame_id);
-    page = &pages_[frame_id];
-  } else {
-    frame_id = free_list_.front();
-    free_list_.pop_front();
-    page = &pages_[frame_id];
+  if (!FindFreeFrame(&frame_id)) {
+    return nullptr;
   }
+  page = &pages_[frame_id];
 
-  // 3.   Update P's metadata, zero out memory and add P to the page table.
-  // replace the old page id with the new page id
-  if (page->is_dirty_) {
-    disk_manager_->WritePage(page->page_id_, page->data_);
+  // 3.   Allocate the new page id and hand the frame over to it in the page table.
+  //      The page id is only allocated once a frame is available, so failed calls do not burn page ids.
+  *page_id = AllocatePage();
+  page_id_t victim_page_id = ReserveFrame(frame_id, *page_id);
+
+  // 4.   If P is dirty, write it back without holding the latch. Then zero out memory.
+  if (victim_page_id != INVALID_PAGE_ID) {
+    guardo.unlock();
+    WriteBackVictim(victim_page_id, page->data_);
+    guardo.lock();
   }
-  page_table_.erase(page->page_id_);
-  page_table_[*page_id] = frame_id;
-  // update P's meta data
-  page->page_id_ = *page_id;
-  page->pin_count_ = 1;
-  page->is_dirty_ = false;
-  page->ResetMemory();  // zero out memory??
+  page->ResetMemory();
+  FinishIO(page);
 
-  // 4.   Set the page ID output parameter. Return a pointer to P.
+  // 5.   Set the page ID output parameter. Return a pointer to P.
   return page;
 }
 
@@ -164,41 +212,383 @@ bool BufferPoolManager::DeletePage(page_id_t page_id) {
 
   // 1.   Search the page table for the requested page (P).
   // 1.   If P does not exist, return true.
-  if (page_table_.count(page_id) == 0) {
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id)) {
     return true;
   }
 
   // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
-  frame_id_t frame_id = page_table_.at(page_id);
+  //      Claiming the frame keeps it from being pinned without the latch while P is deleted.
   Page *page = &pages_[frame_id];
-  if (page->pin_count_ != 0) {
+  if (!ClaimFrame(frame_id)) {
     return false;
   }
 
   // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
-  page_table_.erase(page_id);
-  replacer_->Pin(frame_id);
-  page->pin_count_ = 0;
+  page_table_.Erase(page_id);
+  replacer_->Remove(frame_id);
+  page->version_.fetch_add(2);
   page->page_id_ = INVALID_PAGE_ID;
   page->is_dirty_ = false;
+  page->pin_count_ = 0;
   free_list_.push_back(frame_id);
   return true;
 }
 
+page_id_t BufferPoolManager::AllocatePage() {
+  const page_id_t next_page_id = next_page_id_.fetch_add(static_cast<page_id_t>(num_instances_));
+  BUSTUB_ASSERT(next_page_id % static_cast<page_id_t>(num_instances_) == static_cast<page_id_t>(instance_index_),
+                "allocated pages must belong to this instance");
+  return next_page_id;
+}
+
 void BufferPoolManager::FlushAllPages() {
-  std::lock_guard<std::mutex> guardo(latch_);
-  // not sure?
-  page_id_t page_id;
-  for (auto kv : page_table_) {
-    page_id = kv.first;
-    if (page_table_.count(page_id) > 0) {
-      frame_id_t frame_id = page_table_.at(page_id);
+  // Walk the frames rather than the page table, which may change while we wait for a frame's I/O. Each page is pinned
+  // under the latch and written without it, so that a checkpoint does not stall the fetches of other threads.
+  for (size_t i = 0; i < pool_size_; i++) {
+    std::unique_lock<std::mutex> guardo(latch_);
+    Page *page = &pages_[i];
+    page->io_cv_.wait(guardo, [page] { return !page->io_in_progress_; });
+    if (page->page_id_ == INVALID_PAGE_ID) {
+      continue;
+    }
+    page->pin_count_++;
+    guardo.unlock();
+    WriteBack(static_cast<frame_id_t>(i));
+  }
+}
+
+Page *BufferPoolManager::FindResidentPage(page_id_t page_id) {
+  frame_id_t frame_id;
+  return page_table_.Find(page_id, &frame_id) ? &pages_[frame_id] : nullptr;
+}
+
+ReadPageGuard BufferPoolManager::FetchPageRead(page_id_t page_id, BufferAccessStrategy *strategy) {
+  Page *page = FetchPage(page_id, strategy);
+  if (page != nullptr) {
+    page->RLatch();
+  }
+  return ReadPageGuard(this, page);
+}
+
+WritePageGuard BufferPoolManager::FetchPageWrite(page_id_t page_id) {
+  Page *page = FetchPage(page_id);
+  if (page != nullptr) {
+    page->WLatch();
+  }
+  return WritePageGuard(this, page);
+}
+
+void BufferPoolManager::RunPrefetchThreads(size_t num_threads) {
+  if (enable_prefetch_) {
+    return;
+  }
+  enable_prefetch_ = true;
+  for (size_t i = 0; i < num_threads; i++) {
+    prefetch_threads_.push_back(new std::thread(&BufferPoolManager::RunPrefetch, this));
+  }
+}
+
+void BufferPoolManager::StopPrefetchThreads() {
+  {
+    std::lock_guard<std::mutex> guard(prefetch_latch_);
+    if (!enable_prefetch_) {
+      return;
+    }
+    enable_prefetch_ = false;
+    prefetch_queue_.clear();
+  }
+  prefetch_cv_.notify_all();
+  for (auto *thread : prefetch_threads_) {
+    thread->join();
+    delete thread;
+  }
+  prefetch_threads_.clear();
+}
+
+bool BufferPoolManager::PrefetchPage(page_id_t page_id) {
+  {
+    std::lock_guard<std::mutex> guard(prefetch_latch_);
+    if (!enable_prefetch_ || page_id == INVALID_PAGE_ID || prefetch_queue_.size() >= PREFETCH_QUEUE_SIZE) {
+      return false;
+    }
+    prefetch_queue_.push_back(page_id);
+  }
+  prefetch_cv_.notify_one();
+  return true;
+}
+
+void BufferPoolManager::PrefetchRange(page_id_t first_page_id, size_t num_pages) {
+  for (size_t i = 0; i < num_pages; i++) {
+    if (!PrefetchPage(first_page_id + static_cast<page_id_t>(i))) {
+      return;
+    }
+  }
+}
+
+void BufferPoolManager::RunPrefetch() {
+  while (true) {
+    page_id_t page_id;
+    {
+      std::unique_lock<std::mutex> guard(prefetch_latch_);
+      prefetch_cv_.wait(guard, [this] { return !enable_prefetch_ || !prefetch_queue_.empty(); });
+      if (!enable_prefetch_) {
+        return;
+      }
+      page_id = prefetch_queue_.front();
+      prefetch_queue_.pop_front();
+    }
+    ReadAhead(page_id);
+  }
+}
+
+bool BufferPoolManager::ReadAhead(page_id_t page_id) {
+  // 1.   Give up right away if P is resident, or if it does not exist yet: a page that was neither allocated by this
+  //      instance nor ever written would only take a frame away from a real page. Also give up if P is still being
+  //      written back, rather than waiting for the disk to have its latest contents.
+  //      The size of the file is asked for before taking the latch, since it takes a system call.
+  if (page_id >= next_page_id_ && page_id >= disk_manager_->GetNumPages()) {
+    return false;
+  }
+  std::unique_lock<std::mutex> guardo(latch_);
+  frame_id_t frame_id;
+  if (page_table_.Find(page_id, &frame_id) || (free_list_.empty() && replacer_->Size() == 0)) {
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> write_guard(write_latch_);
+    if (pages_being_written_.count(page_id) > 0) {
+      return false;
+    }
+  }
+  if (!FindFreeFrame(&frame_id)) {
+    return false;
+  }
+
+  // 2.   Reserve the frame for P, then write back the victim and read P without holding the latch. A FetchPage of P
+  //      in the meantime waits for the read instead of issuing its own.
+  Page *page = &pages_[frame_id];
+  page_id_t victim_page_id = ReserveFrame(frame_id, page_id);
+  guardo.unlock();
+  if (victim_page_id != INVALID_PAGE_ID) {
+    WriteBackVictim(victim_page_id, page->data_);
+  }
+  disk_manager_->ReadPage(page_id, page->data_);
+
+  // 3.   Drop the reservation's pin: P stays unpinned, so it can be evicted again if nobody fetches it.
+  guardo.lock();
+  FinishIO(page);
+  if (--page->pin_count_ == 0) {
+    replacer_->Unpin(frame_id);
+  }
+  return true;
+}
+
+void BufferPoolManager::RunBackgroundWriter(size_t num_clean_frames) {
+  if (enable_bg_writer_) {
+    return;
+  }
+  num_clean_frames_ = num_clean_frames;
+  enable_bg_writer_ = true;
+  bg_writer_thread_ = new std::thread(&BufferPoolManager::RunBackgroundWrite, this);
+}
+
+void BufferPoolManager::StopBackgroundWriter() {
+  {
+    std::lock_guard<std::mutex> guard(bg_writer_latch_);
+    if (!enable_bg_writer_) {
+      return;
+    }
+    enable_bg_writer_ = false;
+  }
+  bg_writer_cv_.notify_all();
+  bg_writer_thread_->join();
+  delete bg_writer_thread_;
+  bg_writer_thread_ = nullptr;
+}
+
+void BufferPoolManager::RunBackgroundWrite() {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> guard(bg_writer_latch_);
+      bg_writer_cv_.wait_for(guard, bg_writer_interval, [this] { return !enable_bg_writer_; });
+      if (!enable_bg_writer_) {
+        return;
+      }
+    }
+    WriteBackDirtyVictims();
+  }
+}
+
+size_t BufferPoolManager::WriteBackDirtyVictims() {
+  // 1.   Mark the dirty pages among the next victims clean, and copy them. The flag is cleared before the copy: a page
+  //      can be pinned without the latch and modified while it is copied, and its unpin then marks it dirty again
+  //      rather than having that flag cleared after the fact.
+  std::vector<page_id_t> page_ids;
+  std::vector<char> data;
+  {
+    std::lock_guard<std::mutex> guardo(latch_);
+    for (frame_id_t frame_id : replacer_->PeekVictims(num_clean_frames_)) {
       Page *page = &pages_[frame_id];
-      // check whether page->page_id_ is invalid?
-      disk_manager_->WritePage(page_id, page->data_);
-      page->is_dirty_ = false;
+      if (!page->is_dirty_ || page->pin_count_ > 0) {
+        continue;
+      }
+      {
+        std::lock_guard<std::mutex> write_guard(write_latch_);
+        if (!pages_being_written_.insert(page->page_id_).second) {
+          continue;
+        }
+        if (!page->is_dirty_.exchange(false)) {
+          pages_being_written_.erase(page->page_id_);
+          continue;
+        }
+      }
+      page_ids.push_back(page->page_id_);
+      data.insert(data.end(), page->data_, page->data_ + PAGE_SIZE);
     }
   }
+
+  // 2.   Write the copies without holding latch_.
+  for (size_t i = 0; i < page_ids.size(); i++) {
+    disk_manager_->WritePage(page_ids[i], &data[i * PAGE_SIZE]);
+  }
+  if (!page_ids.empty()) {
+    {
+      std::lock_guard<std::mutex> write_guard(write_latch_);
+      for (page_id_t page_id : page_ids) {
+        pages_being_written_.erase(page_id);
+      }
+    }
+    write_cv_.notify_all();
+    num_background_writes_ += page_ids.size();
+  }
+  return page_ids.size();
+}
+
+void BufferPoolManager::WriteBack(frame_id_t frame_id) {
+  Page *page = &pages_[frame_id];
+  // Clear the flag before the write: a page that is modified meanwhile is marked dirty again by its unpin.
+  page->is_dirty_ = false;
+  WaitForBackgroundWrite(page->page_id_);
+  disk_manager_->WritePage(page->page_id_, page->data_);
+  if (--page->pin_count_ == 0) {
+    MakeEvictable(frame_id);
+  }
+}
+
+page_id_t BufferPoolManager::ReserveFrame(frame_id_t frame_id, page_id_t page_id) {
+  Page *page = &pages_[frame_id];
+  BUSTUB_ASSERT(page->pin_count_ == RESERVED_PIN_COUNT, "The frame must be claimed before it is handed over.");
+  page_id_t victim_page_id = INVALID_PAGE_ID;
+  if (page->is_dirty_) {
+    // Until the victim is on disk, a fetch of it must not read it back. Registering it as being written makes the
+    // fetch wait. In the rare case that an older copy of the victim is still being written, wait for that first, so
+    // that the writes reach the disk in order.
+    victim_page_id = page->page_id_;
+    std::unique_lock<std::mutex> write_guard(write_latch_);
+    write_cv_.wait(write_guard, [&] { return pages_being_written_.count(victim_page_id) == 0; });
+    pages_being_written_.insert(victim_page_id);
+  }
+  if (page->page_id_ != INVALID_PAGE_ID) {
+    page_table_.Erase(page->page_id_);
+  }
+  page_table_.Insert(page_id, frame_id);
+  page->page_id_ = page_id;
+  page->is_dirty_ = false;
+  page->io_in_progress_ = true;
+  // Optimistic readers of the frame's old page must fail to validate from now on, and readers of the new page must
+  // not start before FinishIO.
+  page->version_.fetch_add(1);
+  // Publish the frame last: a thread that pins it without the latch from now on sees the new page and waits for the
+  // I/O to finish.
+  page->pin_count_ = 1;
+  return victim_page_id;
+}
+
+Page *BufferPoolManager::PinResidentPage(page_id_t page_id) {
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id)) {
+    return nullptr;
+  }
+  Page *page = &pages_[frame_id];
+  int pin_count = page->pin_count_;
+  do {
+    if (pin_count == RESERVED_PIN_COUNT) {
+      return nullptr;
+    }
+  } while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count + 1));
+  // The pin keeps the frame from being handed over, so it can be checked now: the entry may have been stale, and the
+  // page may still be being read in.
+  if (page->page_id_ == page_id && !page->io_in_progress_) {
+    return page;
+  }
+  if (--page->pin_count_ == 0) {
+    MakeEvictable(frame_id);
+  }
+  return nullptr;
+}
+
+bool BufferPoolManager::ClaimFrame(frame_id_t frame_id) {
+  int pin_count = 0;
+  return pages_[frame_id].pin_count_.compare_exchange_strong(pin_count, RESERVED_PIN_COUNT);
+}
+
+bool BufferPoolManager::FindFreeFrame(frame_id_t *frame_id) {
+  if (!free_list_.empty()) {
+    *frame_id = free_list_.front();
+    free_list_.pop_front();
+    // A free frame holds no page, so it can only have been pinned by a PinResidentPage that followed a stale page
+    // table entry, which drops its pin right away.
+    while (!ClaimFrame(*frame_id)) {
+      std::this_thread::yield();
+    }
+    return true;
+  }
+  // A frame stays in the replacer when it is pinned without the latch, and MakeEvictable may put a frame into the
+  // replacer just after it has been pinned again or freed. Skip such frames: their last unpin puts them back, and a
+  // free frame is on the free list. Pages only change frames under the latch, so the check of the page id is good.
+  while (replacer_->Victim(frame_id)) {
+    if (pages_[*frame_id].page_id_ != INVALID_PAGE_ID && ClaimFrame(*frame_id)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void BufferPoolManager::MakeEvictable(frame_id_t frame_id) {
+  // The frame may have been pinned again, handed over to another page or freed since its pin count dropped to zero.
+  // This does not take latch_, so that a hit does not serialize on it, and the frame may still change between the
+  // check and the replacer call: FindFreeFrame skips the victims that turn out to be pinned or free.
+  Page *page = &pages_[frame_id];
+  if (page->pin_count_ == 0 && page->page_id_ != INVALID_PAGE_ID) {
+    // Pinning reports the access to replacers that keep an access history. Fetches do not report it themselves,
+    // since hits do not take the latch.
+    replacer_->Pin(frame_id);
+    replacer_->Unpin(frame_id);
+  }
+}
+
+void BufferPoolManager::FinishIO(Page *page) {
+  page->version_.fetch_add(1);
+  page->io_in_progress_ = false;
+  page->io_cv_.notify_all();
+}
+
+void BufferPoolManager::WriteBackVictim(page_id_t page_id, const char *data) {
+  disk_manager_->WritePage(page_id, data);
+  {
+    std::lock_guard<std::mutex> write_guard(write_latch_);
+    pages_being_written_.erase(page_id);
+  }
+  write_cv_.notify_all();
+  num_foreground_writes_++;
+  // The background writer is falling behind, wake it up rather than waiting for its next round.
+  bg_writer_cv_.notify_one();
+}
+
+void BufferPoolManager::WaitForBackgroundWrite(page_id_t page_id) {
+  std::unique_lock<std::mutex> write_guard(write_latch_);
+  write_cv_.wait(write_guard, [&] { return pages_being_written_.count(page_id) == 0; });
 }
 
 }  // namespace bustub
@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// clock_replacer.cpp
+//
+// Identification: src/buffer/clock_replacer.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/clock_replacer.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+ClockReplacer::ClockReplacer(size_t num_pages) : num_pages_(num_pages), states_(num_pages) {
+  for (auto &state : states_) {
+    state.store(NOT_PRESENT);
+  }
+}
+
+ClockReplacer::~ClockReplacer() = default;
+
+bool ClockReplacer::Victim(frame_id_t *frame_id) {
+  // Two full sweeps are enough to clear every reference bit and come back to a frame. We only give up earlier if the
+  // replacer is empty, and later if other threads keep pinning the frames we are about to take.
+  for (size_t i = 0; i < 2 * num_pages_ && size_.load() > 0; i++) {
+    auto current = static_cast<frame_id_t>(clock_hand_.fetch_add(1) % num_pages_);
+    uint8_t state = states_[current].load();
+    if (state == REFERENCED) {
+      states_[current].compare_exchange_strong(state, PRESENT);
+    } else if (state == PRESENT && states_[current].compare_exchange_strong(state, NOT_PRESENT)) {
+      size_--;
+      *frame_id = current;
+      return true;
+    }
+  }
+  *frame_id = -1;
+  return false;
+}
+
+void ClockReplacer::Pin(frame_id_t frame_id) {
+  if (static_cast<size_t>(frame_id) >= num_pages_) {
+    return;
+  }
+  if (states_[frame_id].exchange(NOT_PRESENT) != NOT_PRESENT) {
+    size_--;
+  }
+}
+
+void ClockReplacer::Unpin(frame_id_t frame_id) {
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < num_pages_, "Frame id out of range.");
+  // Count the frame before publishing it so that a concurrent Pin or Victim never drives size_ below zero.
+  size_++;
+  if (states_[frame_id].exchange(REFERENCED) != NOT_PRESENT) {
+    size_--;
+  }
+}
+
+std::vector<frame_id_t> ClockReplacer::PeekVictims(size_t num_frames) {
+  // The clock hand takes the frames it finds without a reference bit first, so list those before the others.
+  std::vector<frame_id_t> frame_ids;
+  std::vector<frame_id_t> referenced;
+  const size_t hand = clock_hand_.load();
+  for (size_t i = 0; i < num_pages_ && frame_ids.size() < num_frames; i++) {
+    auto frame_id = static_cast<frame_id_t>((hand + i) % num_pages_);
+    uint8_t state = states_[frame_id].load();
+    if (state == PRESENT) {
+      frame_ids.push_back(frame_id);
+    } else if (state == REFERENCED) {
+      referenced.push_back(frame_id);
+    }
+  }
+  for (size_t i = 0; i < referenced.size() && frame_ids.size() < num_frames; i++) {
+    frame_ids.push_back(referenced[i]);
+  }
+  return frame_ids;
+}
+
+size_t ClockReplacer::Size() { return size_.load(); }
+
+}  // namespace bustub
@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.cpp
+//
+// Identification: src/buffer/lru_k_replacer.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/lru_k_replacer.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k) : k_(k), frames_(num_pages) {
+  BUSTUB_ASSERT(k > 0, "LRU-K needs to remember at least one access.");
+}
+
+LRUKReplacer::~LRUKReplacer() = default;
+
+std::set<LRUKReplacer::Key> *LRUKReplacer::EvictionSet(frame_id_t frame_id) {
+  return frames_[frame_id].history_.size() < k_ ? &young_frames_ : &old_frames_;
+}
+
+void LRUKReplacer::MakeUnevictable(frame_id_t frame_id) {
+  FrameInfo &frame = frames_[frame_id];
+  if (frame.evictable_) {
+    EvictionSet(frame_id)->erase(EvictionKey(frame_id));
+    frame.evictable_ = false;
+  }
+}
+
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  std::set<Key> *eviction_set = !young_frames_.empty() ? &young_frames_ : &old_frames_;
+  if (eviction_set->empty()) {
+    *frame_id = -1;
+    return false;
+  }
+  *frame_id = eviction_set->begin()->second;
+  eviction_set->erase(eviction_set->begin());
+  frames_[*frame_id] = FrameInfo{};
+  return true;
+}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "Frame id out of range.");
+  MakeUnevictable(frame_id);
+  FrameInfo &frame = frames_[frame_id];
+  frame.history_.push_back(current_timestamp_++);
+  if (frame.history_.size() > k_) {
+    frame.history_.pop_front();
+  }
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  BUSTUB_ASSERT(static_cast<size_t>(frame_id) < frames_.size(), "Frame id out of range.");
+  FrameInfo &frame = frames_[frame_id];
+  if (frame.evictable_) {
+    return;
+  }
+  // A frame that is unpinned without ever being pinned (e.g. by a caller that does not report accesses) counts as
+  // accessed now, so that it still has a position in the eviction order.
+  if (frame.history_.empty()) {
+    frame.history_.push_back(current_timestamp_++);
+  }
+  frame.evictable_ = true;
+  EvictionSet(frame_id)->insert(EvictionKey(frame_id));
+}
+
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  if (static_cast<size_t>(frame_id) >= frames_.size()) {
+    return;
+  }
+  MakeUnevictable(frame_id);
+  frames_[frame_id] = FrameInfo{};
+}
+
+std::vector<frame_id_t> LRUKReplacer::PeekVictims(size_t num_frames) {
+  std::lock_guard<std::mutex> guard(latch_);
+  std::vector<frame_id_t> frame_ids;
+  for (const auto *eviction_set : {&young_frames_, &old_frames_}) {
+    for (auto it = eviction_set->begin(); it != eviction_set->end() && frame_ids.size() < num_frames; ++it) {
+      frame_ids.push_back(it->second);
+    }
+  }
+  return frame_ids;
+}
+
+size_t LRUKReplacer::Size() {
+  std::lock_guard<std::mutex> guard(latch_);
+  return young_frames_.size() + old_frames_.size();
+}
+
+}  // namespace bustub
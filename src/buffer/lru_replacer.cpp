@@ -11,40 +11,92 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/lru_replacer.h"
-#include <algorithm>
 
 namespace bustub {
 
 LRUReplacer::LRUReplacer() = default;
 
+LRUReplacer::LRUReplacer(size_t num_pages) : nodes_(num_pages) {}
+
 LRUReplacer::~LRUReplacer() = default;
 
+void LRUReplacer::Unlink(frame_id_t frame_id) {
+  Node &node = nodes_[frame_id];
+  if (node.prev_ == INVALID_FRAME_ID) {
+    head_ = node.next_;
+  } else {
+    nodes_[node.prev_].next_ = node.next_;
+  }
+  if (node.next_ == INVALID_FRAME_ID) {
+    tail_ = node.prev_;
+  } else {
+    nodes_[node.next_].prev_ = node.prev_;
+  }
+  node = Node{};
+  size_--;
+}
+
 bool LRUReplacer::Victim(frame_id_t *frame_id) {
   std::lock_guard<std::mutex> guardo(this->latch);
-  if (!my_list.empty()) {
-    *frame_id = my_list.front();
-    my_list.remove(*frame_id);
-    return true;
+  if (head_ == INVALID_FRAME_ID) {
+    *frame_id = -1;
+    return false;
   }
-  *frame_id = -1;
-  return false;
+  *frame_id = head_;
+  Unlink(head_);
+  return true;
 }
 
 void LRUReplacer::Pin(frame_id_t frame_id) {
   std::lock_guard<std::mutex> guardo(this->latch);
-  my_list.remove(frame_id);
+  if (static_cast<size_t>(frame_id) < nodes_.size() && nodes_[frame_id].in_list_) {
+    Unlink(frame_id);
+  }
+}
+
+void LRUReplacer::Remove(frame_id_t frame_id) {
+  // the frame may be pinned, or never have been unpinned, in which case it is not in the list
+  std::lock_guard<std::mutex> guardo(this->latch);
+  if (static_cast<size_t>(frame_id) < nodes_.size() && nodes_[frame_id].in_list_) {
+    Unlink(frame_id);
+  }
 }
 
 void LRUReplacer::Unpin(frame_id_t frame_id) {
   std::lock_guard<std::mutex> guardo(this->latch);
-  if (std::find(my_list.begin(), my_list.end(), frame_id) == my_list.end()) {
-    my_list.push_back(frame_id);
+  if (static_cast<size_t>(frame_id) >= nodes_.size()) {
+    nodes_.resize(frame_id + 1);
+  }
+  Node &node = nodes_[frame_id];
+  // Unpinning a frame that is already in the list does not refresh its position.
+  if (node.in_list_) {
+    return;
+  }
+  node.in_list_ = true;
+  node.prev_ = tail_;
+  node.next_ = INVALID_FRAME_ID;
+  if (tail_ == INVALID_FRAME_ID) {
+    head_ = frame_id;
+  } else {
+    nodes_[tail_].next_ = frame_id;
+  }
+  tail_ = frame_id;
+  size_++;
+}
+
+std::vector<frame_id_t> LRUReplacer::PeekVictims(size_t num_frames) {
+  std::lock_guard<std::mutex> guardo(this->latch);
+  std::vector<frame_id_t> frame_ids;
+  for (frame_id_t frame_id = head_; frame_id != INVALID_FRAME_ID && frame_ids.size() < num_frames;
+       frame_id = nodes_[frame_id].next_) {
+    frame_ids.push_back(frame_id);
   }
+  return frame_ids;
 }
 
 size_t LRUReplacer::Size() {
   std::lock_guard<std::mutex> guardo(this->latch);
-  return my_list.size();
+  return size_;
 }
 
 }  // namespace bustub
@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.cpp
+//
+// Identification: src/buffer/page_table.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_table.h"
+
+namespace bustub {
+
+PageTable::PageTable(size_t capacity) {
+  // Keep the table at most half full, so that probe sequences stay short.
+  num_bits_ = 1;
+  while ((static_cast<size_t>(1) << num_bits_) < 2 * capacity) {
+    num_bits_++;
+  }
+  mask_ = (static_cast<size_t>(1) << num_bits_) - 1;
+  slots_ = std::vector<std::atomic<uint64_t>>(mask_ + 1);
+  for (auto &slot : slots_) {
+    slot.store(EMPTY_SLOT, std::memory_order_relaxed);
+  }
+}
+
+size_t PageTable::HomeSlot(page_id_t page_id) const {
+  // Page ids are mostly consecutive, so scatter them with a multiplicative (Fibonacci) hash.
+  return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(page_id)) * 0x9E3779B97F4A7C15ULL) >>
+                             (64 - num_bits_));
+}
+
+size_t PageTable::FindSlot(page_id_t page_id) const {
+  size_t index = HomeSlot(page_id);
+  while (true) {
+    uint64_t slot = slots_[index].load(std::memory_order_acquire);
+    if (slot == EMPTY_SLOT || PageIdOf(slot) == page_id) {
+      return index;
+    }
+    index = (index + 1) & mask_;
+  }
+}
+
+bool PageTable::Find(page_id_t page_id, frame_id_t *frame_id) const {
+  uint64_t slot = slots_[FindSlot(page_id)].load(std::memory_order_acquire);
+  if (slot == EMPTY_SLOT || PageIdOf(slot) != page_id) {
+    return false;
+  }
+  *frame_id = FrameIdOf(slot);
+  return true;
+}
+
+void PageTable::Insert(page_id_t page_id, frame_id_t frame_id) {
+  BUSTUB_ASSERT(page_id != INVALID_PAGE_ID, "Cannot map an invalid page id.");
+  slots_[FindSlot(page_id)].store(Pack(page_id, frame_id), std::memory_order_release);
+}
+
+void PageTable::Erase(page_id_t page_id) {
+  size_t hole = FindSlot(page_id);
+  if (slots_[hole].load(std::memory_order_relaxed) == EMPTY_SLOT) {
+    return;
+  }
+  // Move every following entry of the cluster whose probe sequence passes the hole into it, so that no probe
+  // sequence is cut short by the empty slot the erase leaves behind.
+  size_t index = hole;
+  while (true) {
+    index = (index + 1) & mask_;
+    uint64_t slot = slots_[index].load(std::memory_order_relaxed);
+    if (slot == EMPTY_SLOT) {
+      break;
+    }
+    size_t home = HomeSlot(PageIdOf(slot));
+    // The entry can stay if its home lies cyclically in (hole, index].
+    bool stays = hole <= index ? (hole < home && home <= index) : (hole < home || home <= index);
+    if (!stays) {
+      slots_[hole].store(slot, std::memory_order_release);
+      hole = index;
+    }
+  }
+  slots_[hole].store(EMPTY_SLOT, std::memory_order_release);
+}
+
+}  // namespace bustub
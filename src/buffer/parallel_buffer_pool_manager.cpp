@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.cpp
+//
+// Identification: src/buffer/parallel_buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+namespace bustub {
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                                                     LogManager *log_manager, ReplacerPolicy replacer_policy)
+    : BufferPoolManager(0, disk_manager, log_manager) {
+  BUSTUB_ASSERT(num_instances > 0, "A parallel buffer pool needs at least one instance.");
+  // Allocate and create individual BufferPoolManagers.
+  instances_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; i++) {
+    instances_.push_back(new BufferPoolManager(pool_size, static_cast<uint32_t>(num_instances),
+                                               static_cast<uint32_t>(i), disk_manager, log_manager,
+                                               replacer_policy));
+  }
+}
+
+ParallelBufferPoolManager::~ParallelBufferPoolManager() {
+  // The prefetch threads call into the instances, so they must be gone before the instances are.
+  StopPrefetchThreads();
+  for (auto *instance : instances_) {
+    delete instance;
+  }
+}
+
+size_t ParallelBufferPoolManager::GetPoolSize() {
+  size_t pool_size = 0;
+  for (auto *instance : instances_) {
+    pool_size += instance->GetPoolSize();
+  }
+  return pool_size;
+}
+
+BufferPoolManager *ParallelBufferPoolManager::GetInstance(page_id_t page_id) {
+  // Page ids are handed out round robin by the instances themselves, so the remainder is a perfectly balanced hash.
+  return instances_[static_cast<size_t>(page_id) % instances_.size()];
+}
+
+Page *ParallelBufferPoolManager::FetchPage(page_id_t page_id, BufferAccessStrategy *strategy) {
+  return GetInstance(page_id)->FetchPage(page_id, strategy);
+}
+
+bool ParallelBufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
+  return GetInstance(page_id)->UnpinPage(page_id, is_dirty);
+}
+
+bool ParallelBufferPoolManager::FlushPage(page_id_t page_id) { return GetInstance(page_id)->FlushPage(page_id); }
+
+Page *ParallelBufferPoolManager::NewPage(page_id_t *page_id) {
+  // Start at a different instance on every call so that new pages are spread evenly, and give every instance one
+  // chance before giving up.
+  const size_t num_instances = instances_.size();
+  const size_t start = next_instance_.fetch_add(1) % num_instances;
+  for (size_t i = 0; i < num_instances; i++) {
+    Page *page = instances_[(start + i) % num_instances]->NewPage(page_id);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  return nullptr;
+}
+
+bool ParallelBufferPoolManager::DeletePage(page_id_t page_id) { return GetInstance(page_id)->DeletePage(page_id); }
+
+void ParallelBufferPoolManager::FlushAllPages() {
+  for (auto *instance : instances_) {
+    instance->FlushAllPages();
+  }
+}
+
+Page *ParallelBufferPoolManager::FindResidentPage(page_id_t page_id) {
+  return GetInstance(page_id)->FindResidentPage(page_id);
+}
+
+void ParallelBufferPoolManager::RunBackgroundWriter(size_t num_clean_frames) {
+  for (auto *instance : instances_) {
+    instance->RunBackgroundWriter(num_clean_frames);
+  }
+}
+
+void ParallelBufferPoolManager::StopBackgroundWriter() {
+  for (auto *instance : instances_) {
+    instance->StopBackgroundWriter();
+  }
+}
+
+size_t ParallelBufferPoolManager::GetNumForegroundWrites() {
+  size_t num_writes = 0;
+  for (auto *instance : instances_) {
+    num_writes += instance->GetNumForegroundWrites();
+  }
+  return num_writes;
+}
+
+size_t ParallelBufferPoolManager::GetNumBackgroundWrites() {
+  size_t num_writes = 0;
+  for (auto *instance : instances_) {
+    num_writes += instance->GetNumBackgroundWrites();
+  }
+  return num_writes;
+}
+
+bool ParallelBufferPoolManager::ReadAhead(page_id_t page_id) { return GetInstance(page_id)->ReadAhead(page_id); }
+
+}  // namespace bustub
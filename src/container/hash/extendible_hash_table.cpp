@@ -0,0 +1,309 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table.cpp
+//
+// Identification: src/container/hash/extendible_hash_table.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/rid.h"
+#include "container/hash/extendible_hash_table.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+EXTENDIBLE_HASH_TABLE_TYPE::ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                                                const KeyComparator &comparator, HashFunction<KeyType> hash_fn)
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  // new pages are zeroed: a directory of global depth 0
+  BasicPageGuard directory_guard = buffer_pool_manager_->NewPageGuarded(&directory_page_id_);
+  if (!directory_guard.IsValid()) {
+    throw std::bad_alloc();
+  }
+  auto *directory = directory_guard.AsMut<HashTableDirectoryPage>();
+  directory->SetPageId(directory_page_id_);
+  page_id_t bucket_page_id;
+  BasicPageGuard bucket_guard = buffer_pool_manager_->NewPageGuarded(&bucket_page_id);
+  if (!bucket_guard.IsValid()) {
+    throw std::bad_alloc();
+  }
+  bucket_guard.AsMut<HASH_TABLE_BUCKET_TYPE>()->Init();
+  directory->SetBucketPageId(0, bucket_page_id);
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key,
+                                          std::vector<ValueType> *result) {
+  const uint64_t hash = hash_fn_.GetHash(key);
+  ReadLatchGuard table_guard(&table_latch_);
+  // the directory only changes under the table latch in write mode, so it needs no page latch
+  BasicPageGuard directory_guard = buffer_pool_manager_->FetchPageBasic(directory_page_id_);
+  const auto *directory = directory_guard.As<HashTableDirectoryPage>();
+  ReadPageGuard guard = buffer_pool_manager_->FetchPageRead(directory->GetBucketPageId(directory->SlotOf(hash)));
+  directory_guard.Drop();
+  const auto *bucket = guard.As<HASH_TABLE_BUCKET_TYPE>();
+  bool found = bucket->GetValue(key, HashTag(hash), comparator_, result);
+  for (page_id_t page_id = bucket->GetNextPageId(); page_id != INVALID_PAGE_ID;) {
+    BasicPageGuard overflow_guard = buffer_pool_manager_->FetchPageBasic(page_id);
+    const auto *overflow = overflow_guard.As<HASH_TABLE_BUCKET_TYPE>();
+    found = overflow->GetValue(key, HashTag(hash), comparator_, result) || found;
+    page_id = overflow->GetNextPageId();
+  }
+  return found;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  const uint64_t hash = hash_fn_.GetHash(key);
+  {
+    ReadLatchGuard table_guard(&table_latch_);
+    BasicPageGuard directory_guard = buffer_pool_manager_->FetchPageBasic(directory_page_id_);
+    const auto *directory = directory_guard.As<HashTableDirectoryPage>();
+    const uint32_t slot = directory->SlotOf(hash);
+    const uint32_t local_depth = directory->GetLocalDepth(slot);
+    WritePageGuard guard = buffer_pool_manager_->FetchPageWrite(directory->GetBucketPageId(slot));
+    directory_guard.Drop();
+    ChainInsertResult result = ChainInsert(&guard, local_depth, key, value, hash);
+    if (result != ChainInsertResult::NEEDS_SPLIT) {
+      return result == ChainInsertResult::INSERTED;
+    }
+  }
+
+  // the bucket is full: split it under the table latch in write mode, which rechecks the bucket
+  WriteLatchGuard table_guard(&table_latch_);
+  return SplitInsert(key, value, hash);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <class Guard>
+typename EXTENDIBLE_HASH_TABLE_TYPE::ChainInsertResult EXTENDIBLE_HASH_TABLE_TYPE::ChainInsert(
+    Guard *guard, uint32_t local_depth, const KeyType &key, const ValueType &value, uint64_t hash) {
+  const uint8_t tag = HashTag(hash);
+  const auto *bucket = guard->template As<HASH_TABLE_BUCKET_TYPE>();
+  if (bucket->Find(key, value, tag, comparator_) >= 0) {
+    return ChainInsertResult::DUPLICATE;
+  }
+  // the pages after the first one with room are still checked for the pair
+  page_id_t room_page_id = bucket->IsFull() ? INVALID_PAGE_ID : guard->PageId();
+  page_id_t last_page_id = guard->PageId();
+  for (page_id_t page_id = bucket->GetNextPageId(); page_id != INVALID_PAGE_ID;) {
+    BasicPageGuard overflow_guard = buffer_pool_manager_->FetchPageBasic(page_id);
+    const auto *overflow = overflow_guard.As<HASH_TABLE_BUCKET_TYPE>();
+    if (overflow->Find(key, value, tag, comparator_) >= 0) {
+      return ChainInsertResult::DUPLICATE;
+    }
+    if (room_page_id == INVALID_PAGE_ID && !overflow->IsFull()) {
+      room_page_id = page_id;
+    }
+    last_page_id = page_id;
+    page_id = overflow->GetNextPageId();
+  }
+
+  if (room_page_id == guard->PageId()) {
+    guard->template AsMut<HASH_TABLE_BUCKET_TYPE>()->Append(key, value, tag);
+    return ChainInsertResult::INSERTED;
+  }
+  if (room_page_id != INVALID_PAGE_ID) {
+    BasicPageGuard room_guard = buffer_pool_manager_->FetchPageBasic(room_page_id);
+    room_guard.AsMut<HASH_TABLE_BUCKET_TYPE>()->Append(key, value, tag);
+    return ChainInsertResult::INSERTED;
+  }
+  if (local_depth < HashTableDirectoryPage::MAX_DEPTH && ShouldSplit(bucket, hash)) {
+    return ChainInsertResult::NEEDS_SPLIT;
+  }
+
+  page_id_t overflow_page_id;
+  BasicPageGuard overflow_guard = buffer_pool_manager_->NewPageGuarded(&overflow_page_id);
+  if (!overflow_guard.IsValid()) {
+    throw std::bad_alloc();
+  }
+  auto *overflow = overflow_guard.AsMut<HASH_TABLE_BUCKET_TYPE>();
+  overflow->Init();
+  overflow->Append(key, value, tag);
+  if (last_page_id == guard->PageId()) {
+    guard->template AsMut<HASH_TABLE_BUCKET_TYPE>()->SetNextPageId(overflow_page_id);
+  } else {
+    BasicPageGuard last_guard = buffer_pool_manager_->FetchPageBasic(last_page_id);
+    last_guard.AsMut<HASH_TABLE_BUCKET_TYPE>()->SetNextPageId(overflow_page_id);
+  }
+  return ChainInsertResult::INSERTED;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::ShouldSplit(const HASH_TABLE_BUCKET_TYPE *bucket, uint64_t hash) {
+  // the directory never looks past these bits of a hash, so no split separates the pairs that agree in them
+  const uint64_t mask = HashTableDirectoryPage::MAX_SLOTS - 1;
+  std::vector<uint32_t> group_sizes(HashTableDirectoryPage::MAX_SLOTS);
+  group_sizes[hash & mask]++;
+  uint32_t num_pairs = 1;
+  auto count = [&](const HASH_TABLE_BUCKET_TYPE *page) {
+    for (uint32_t i = 0; i < page->GetSize(); i++) {
+      group_sizes[hash_fn_.GetHash(page->KeyAt(i)) & mask]++;
+    }
+    num_pairs += page->GetSize();
+  };
+  count(bucket);
+  for (page_id_t page_id = bucket->GetNextPageId(); page_id != INVALID_PAGE_ID;) {
+    BasicPageGuard overflow_guard = buffer_pool_manager_->FetchPageBasic(page_id);
+    const auto *overflow = overflow_guard.As<HASH_TABLE_BUCKET_TYPE>();
+    count(overflow);
+    page_id = overflow->GetNextPageId();
+  }
+  const uint32_t largest_group = *std::max_element(group_sizes.begin(), group_sizes.end());
+  return 2 * (num_pairs - largest_group) >= BUCKET_ARRAY_SIZE;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::SplitInsert(const KeyType &key, const ValueType &value, uint64_t hash) {
+  BasicPageGuard directory_guard = buffer_pool_manager_->FetchPageBasic(directory_page_id_);
+  auto *directory = directory_guard.AsMut<HashTableDirectoryPage>();
+  while (true) {
+    const uint32_t slot = directory->SlotOf(hash);
+    const uint32_t local_depth = directory->GetLocalDepth(slot);
+    BasicPageGuard guard = buffer_pool_manager_->FetchPageBasic(directory->GetBucketPageId(slot));
+    ChainInsertResult result = ChainInsert(&guard, local_depth, key, value, hash);
+    if (result != ChainInsertResult::NEEDS_SPLIT) {
+      return result == ChainInsertResult::INSERTED;
+    }
+
+    // the bucket should split, so its local depth is below MAX_DEPTH, and so is the global depth if they are equal
+    page_id_t image_page_id;
+    BasicPageGuard image_guard = buffer_pool_manager_->NewPageGuarded(&image_page_id);
+    if (!image_guard.IsValid()) {
+      throw std::bad_alloc();
+    }
+    if (local_depth == directory->GetGlobalDepth()) {
+      directory->IncrGlobalDepth();
+    }
+    SplitBucket(guard.AsMut<HASH_TABLE_BUCKET_TYPE>(), image_guard.AsMut<HASH_TABLE_BUCKET_TYPE>(), local_depth);
+    directory->SplitBucket(slot, local_depth, image_page_id);
+    // all pairs may have gone to the same side, in which case the bucket of the pair splits again
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::SplitBucket(HASH_TABLE_BUCKET_TYPE *bucket, HASH_TABLE_BUCKET_TYPE *image,
+                                             uint32_t local_depth) {
+  const uint64_t split_bit = uint64_t{1} << local_depth;
+  std::vector<std::pair<uint64_t, MappingType>> stay_pairs;
+  std::vector<std::pair<uint64_t, MappingType>> image_pairs;
+  std::vector<page_id_t> free_page_ids;
+  auto collect = [&](const HASH_TABLE_BUCKET_TYPE *page) {
+    for (uint32_t i = 0; i < page->GetSize(); i++) {
+      const uint64_t pair_hash = hash_fn_.GetHash(page->KeyAt(i));
+      auto *pairs = (pair_hash & split_bit) != 0 ? &image_pairs : &stay_pairs;
+      pairs->emplace_back(pair_hash, MappingType(page->KeyAt(i), page->ValueAt(i)));
+    }
+  };
+  collect(bucket);
+  for (page_id_t page_id = bucket->GetNextPageId(); page_id != INVALID_PAGE_ID;) {
+    BasicPageGuard overflow_guard = buffer_pool_manager_->FetchPageBasic(page_id);
+    const auto *overflow = overflow_guard.As<HASH_TABLE_BUCKET_TYPE>();
+    collect(overflow);
+    free_page_ids.push_back(page_id);
+    page_id = overflow->GetNextPageId();
+  }
+  // the bucket is full, so both sides fit into its pages and the image
+  FillBucket(bucket, stay_pairs, &free_page_ids);
+  FillBucket(image, image_pairs, &free_page_ids);
+  for (page_id_t page_id : free_page_ids) {
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::FillBucket(HASH_TABLE_BUCKET_TYPE *bucket,
+                                            const std::vector<std::pair<uint64_t, MappingType>> &pairs,
+                                            std::vector<page_id_t> *free_page_ids) {
+  bucket->Init();
+  BasicPageGuard overflow_guard;
+  for (const auto &[pair_hash, pair] : pairs) {
+    if (bucket->IsFull()) {
+      BUSTUB_ASSERT(!free_page_ids->empty(), "the pages of a split bucket hold its pairs");
+      const page_id_t page_id = free_page_ids->back();
+      free_page_ids->pop_back();
+      bucket->SetNextPageId(page_id);
+      overflow_guard = buffer_pool_manager_->FetchPageBasic(page_id);
+      bucket = overflow_guard.AsMut<HASH_TABLE_BUCKET_TYPE>();
+      bucket->Init();
+    }
+    bucket->Append(pair.first, pair.second, HashTag(pair_hash));
+  }
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  const uint64_t hash = hash_fn_.GetHash(key);
+  ReadLatchGuard table_guard(&table_latch_);
+  BasicPageGuard directory_guard = buffer_pool_manager_->FetchPageBasic(directory_page_id_);
+  const auto *directory = directory_guard.As<HashTableDirectoryPage>();
+  WritePageGuard guard = buffer_pool_manager_->FetchPageWrite(directory->GetBucketPageId(directory->SlotOf(hash)));
+  directory_guard.Drop();
+  int index = guard.As<HASH_TABLE_BUCKET_TYPE>()->Find(key, value, HashTag(hash), comparator_);
+  if (index >= 0) {
+    guard.AsMut<HASH_TABLE_BUCKET_TYPE>()->RemoveAt(index);
+    return true;
+  }
+
+  // an overflow page that becomes empty is unlinked from the page before it, which is the bucket page if there is no
+  // previous guard
+  BasicPageGuard previous_guard;
+  for (page_id_t page_id = guard.As<HASH_TABLE_BUCKET_TYPE>()->GetNextPageId(); page_id != INVALID_PAGE_ID;) {
+    BasicPageGuard overflow_guard = buffer_pool_manager_->FetchPageBasic(page_id);
+    const auto *overflow = overflow_guard.As<HASH_TABLE_BUCKET_TYPE>();
+    index = overflow->Find(key, value, HashTag(hash), comparator_);
+    if (index >= 0) {
+      overflow_guard.AsMut<HASH_TABLE_BUCKET_TYPE>()->RemoveAt(index);
+      if (overflow->GetSize() == 0) {
+        auto *previous = previous_guard.IsValid() ? previous_guard.AsMut<HASH_TABLE_BUCKET_TYPE>()
+                                                  : guard.AsMut<HASH_TABLE_BUCKET_TYPE>();
+        previous->SetNextPageId(overflow->GetNextPageId());
+        overflow_guard.Drop();
+        buffer_pool_manager_->DeletePage(page_id);
+      }
+      return true;
+    }
+    page_id = overflow->GetNextPageId();
+    previous_guard = std::move(overflow_guard);
+  }
+  return false;
+}
+
+/*****************************************************************************
+ * GETGLOBALDEPTH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t EXTENDIBLE_HASH_TABLE_TYPE::GetGlobalDepth() {
+  ReadLatchGuard table_guard(&table_latch_);
+  BasicPageGuard directory_guard = buffer_pool_manager_->FetchPageBasic(directory_page_id_);
+  return directory_guard.As<HashTableDirectoryPage>()->GetGlobalDepth();
+}
+
+template class ExtendibleHashTable<int, int, IntComparator>;
+
+template class ExtendibleHashTable<GenericKey<4>, RID, GenericComparator<4>>;
+template class ExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>>;
+template class ExtendibleHashTable<GenericKey<16>, RID, GenericComparator<16>>;
+template class ExtendibleHashTable<GenericKey<32>, RID, GenericComparator<32>>;
+template class ExtendibleHashTable<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -10,8 +10,14 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
 #include <iostream>
+#include <mutex>  // NOLINT
+#include <new>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -26,21 +32,261 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                       const KeyComparator &comparator, size_t num_buckets,
                                       HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {}
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  header_page_id_ = CreateTable(num_buckets);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+page_id_t HASH_TABLE_TYPE::CreateTable(size_t num_buckets) {
+  size_t num_blocks = std::max<size_t>(1, (num_buckets + BLOCK_ARRAY_SIZE - 1) / BLOCK_ARRAY_SIZE);
+  if (num_blocks > HashTableHeaderPage::MAX_BLOCKS) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "hash table has more blocks than its header page holds");
+  }
+  page_id_t header_page_id;
+  BasicPageGuard header_guard = buffer_pool_manager_->NewPageGuarded(&header_page_id);
+  if (!header_guard.IsValid()) {
+    throw std::bad_alloc();
+  }
+  auto *header = header_guard.AsMut<HashTableHeaderPage>();
+  header->SetPageId(header_page_id);
+  header->SetSize(num_blocks * BLOCK_ARRAY_SIZE);
+  // a block is allocated by the first insert into it, so that a resize does not stall on allocating the new table
+  for (size_t i = 0; i < num_blocks; i++) {
+    header->AddBlockPageId(INVALID_PAGE_ID);
+  }
+  return header_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <class Guard, class MatchFunction>
+bool HASH_TABLE_TYPE::Probe(HashTableHeaderPage *header, const KeyType &key, uint64_t hash, MatchFunction &&on_match,
+                            size_t *empty_bucket, Guard *empty_guard, size_t *tombstone_bucket) {
+  const uint8_t tag = HASH_TABLE_BLOCK_TYPE::TagOf(hash);
+  const size_t num_buckets = header->GetSize();
+  const size_t num_blocks = header->NumBlocks();
+  *empty_bucket = num_buckets;
+  if (tombstone_bucket != nullptr) {
+    *tombstone_bucket = num_buckets;
+  }
+
+  size_t block_index = hash % num_buckets / BLOCK_ARRAY_SIZE;
+  slot_offset_t slot = hash % num_buckets % BLOCK_ARRAY_SIZE;
+  size_t probed = 0;
+  while (probed < num_buckets) {
+    page_id_t block_page_id = header->GetBlockPageId(block_index);
+    if (block_page_id == INVALID_PAGE_ID) {
+      if (empty_guard == nullptr) {
+        // all slots of a block that was never allocated are empty
+        *empty_bucket = block_index * BLOCK_ARRAY_SIZE + slot;
+        return true;
+      }
+      // the empty bucket is about to be written; a concurrent insert may have written the block since, so it is probed
+      AllocateBlock(header, block_index);
+      block_page_id = header->GetBlockPageId(block_index);
+    }
+    Guard guard = FetchBlock<Guard>(block_page_id);
+    for (; slot < BLOCK_ARRAY_SIZE && probed < num_buckets;) {
+      const size_t count = std::min({HASH_TABLE_BLOCK_TYPE::GROUP_SIZE, BLOCK_ARRAY_SIZE - slot, num_buckets - probed});
+      uint32_t empty;
+      uint32_t match = guard.template As<HASH_TABLE_BLOCK_TYPE>()->MatchTag(slot, tag, &empty);
+      empty &= (1U << count) - 1;
+      // the probe sequence ends at the first empty slot
+      const uint32_t probe_mask = empty != 0 ? (1U << __builtin_ctz(empty)) - 1 : (1U << count) - 1;
+      match &= probe_mask;
+      if (tombstone_bucket != nullptr && *tombstone_bucket == num_buckets) {
+        uint32_t ignored;
+        const uint32_t tombstones =
+            guard.template As<HASH_TABLE_BLOCK_TYPE>()->MatchTag(slot, HASH_TABLE_BLOCK_TYPE::TOMBSTONE_TAG, &ignored) &
+            probe_mask;
+        if (tombstones != 0) {
+          *tombstone_bucket = block_index * BLOCK_ARRAY_SIZE + slot + __builtin_ctz(tombstones);
+        }
+      }
+      for (; match != 0; match &= match - 1) {
+        if (!on_match(&guard, slot + __builtin_ctz(match))) {
+          return false;
+        }
+      }
+      if (empty != 0) {
+        *empty_bucket = block_index * BLOCK_ARRAY_SIZE + slot + __builtin_ctz(empty);
+        if (empty_guard != nullptr) {
+          *empty_guard = std::move(guard);
+        }
+        return true;
+      }
+      slot += count;
+      probed += count;
+    }
+    block_index = (block_index + 1) % num_blocks;
+    slot = 0;
+  }
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <class Guard>
+Guard HASH_TABLE_TYPE::FetchBlock(page_id_t block_page_id) {
+  if constexpr (std::is_same_v<Guard, ReadPageGuard>) {
+    return buffer_pool_manager_->FetchPageRead(block_page_id);
+  } else {
+    return buffer_pool_manager_->FetchPageWrite(block_page_id);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::HasPair(HashTableHeaderPage *header, const KeyType &key, uint64_t hash, const ValueType &value) {
+  size_t empty_bucket;
+  return !Probe<ReadPageGuard>(
+      header, key, hash,
+      [&](ReadPageGuard *guard, slot_offset_t slot) {
+        const auto *block = guard->As<HASH_TABLE_BLOCK_TYPE>();
+        return comparator_(block->KeyAt(slot), key) != 0 || !(block->ValueAt(slot) == value);
+      },
+      &empty_bucket);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::RemovePair(HashTableHeaderPage *header, const KeyType &key, uint64_t hash,
+                                 const ValueType &value) {
+  size_t empty_bucket;
+  return !Probe<WritePageGuard>(
+      header, key, hash,
+      [&](WritePageGuard *guard, slot_offset_t slot) {
+        const auto *block = guard->As<HASH_TABLE_BLOCK_TYPE>();
+        if (comparator_(block->KeyAt(slot), key) != 0 || !(block->ValueAt(slot) == value)) {
+          return true;
+        }
+        // the slot stays occupied as a tombstone, so that the probe sequences through it are not cut
+        guard->AsMut<HASH_TABLE_BLOCK_TYPE>()->Remove(slot);
+        return false;
+      },
+      &empty_bucket);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::AllocateBlock(HashTableHeaderPage *header, size_t block_index) {
+  page_id_t block_page_id;
+  BasicPageGuard guard = buffer_pool_manager_->NewPageGuarded(&block_page_id);
+  if (!guard.IsValid()) {
+    throw std::bad_alloc();
+  }
+  // new pages are zeroed, so all slots of the block start out empty
+  guard.SetDirty();
+  guard.Drop();
+  if (!header->ReplaceBlockPageId(block_index, INVALID_PAGE_ID, block_page_id)) {
+    buffer_pool_manager_->DeletePage(block_page_id);
+  }
+}
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) {
-  return false;
+  const uint64_t hash = hash_fn_.GetHash(key);
+  const size_t begin = result->size();
+  // the end of the values found in the old table; a pair that a migration moves in between is found in both tables
+  size_t old_end = begin;
+  auto collect = [&](ReadPageGuard *guard, slot_offset_t slot) {
+    const auto *block = guard->As<HASH_TABLE_BLOCK_TYPE>();
+    if (comparator_(block->KeyAt(slot), key) == 0) {
+      const ValueType value = block->ValueAt(slot);
+      if (std::find(result->begin() + begin, result->begin() + old_end, value) == result->begin() + old_end) {
+        result->push_back(value);
+      }
+    }
+    return true;
+  };
+  size_t empty_bucket;
+  ReadLatchGuard table_guard(&table_latch_);
+  // a migration writes a pair into the new table before it removes it from the old one, so probing the old table
+  // first finds every pair
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    BasicPageGuard old_header_guard = buffer_pool_manager_->FetchPageBasic(old_header_page_id_);
+    Probe<ReadPageGuard>(old_header_guard.AsMut<HashTableHeaderPage>(), key, hash, collect, &empty_bucket);
+    old_end = result->size();
+  }
+  BasicPageGuard header_guard = buffer_pool_manager_->FetchPageBasic(header_page_id_);
+  Probe<ReadPageGuard>(header_guard.AsMut<HashTableHeaderPage>(), key, hash, collect, &empty_bucket);
+  return result->size() > begin;
 }
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+  const uint64_t hash = hash_fn_.GetHash(key);
+  std::lock_guard<std::mutex> key_guard(key_latches_[hash % NUM_KEY_LATCHES]);
+  while (true) {
+    page_id_t old_header_page_id = INVALID_PAGE_ID;
+    page_id_t header_page_id = INVALID_PAGE_ID;
+    bool migrated = false;
+    bool unique = true;
+    bool inserted = false;
+    bool retry = false;
+    try {
+      ReadLatchGuard table_guard(&table_latch_);
+      old_header_page_id = old_header_page_id_;
+      header_page_id = header_page_id_;
+      migrated = TryMigrate();
+      if (old_header_page_id != INVALID_PAGE_ID) {
+        BasicPageGuard old_header_guard = buffer_pool_manager_->FetchPageBasic(old_header_page_id);
+        unique = !HasPair(old_header_guard.AsMut<HashTableHeaderPage>(), key, hash, value);
+      }
+      if (unique) {
+        BasicPageGuard header_guard = buffer_pool_manager_->FetchPageBasic(header_page_id);
+        auto *header = header_guard.AsMut<HashTableHeaderPage>();
+        const size_t num_buckets = header->GetSize();
+        size_t empty_bucket;
+        size_t tombstone_bucket;
+        // the block of the empty bucket stays latched, so that no concurrent write takes the bucket in between
+        WritePageGuard empty_guard;
+        unique = Probe<WritePageGuard>(
+            header, key, hash,
+            [&](WritePageGuard *guard, slot_offset_t slot) {
+              const auto *block = guard->As<HASH_TABLE_BLOCK_TYPE>();
+              return comparator_(block->KeyAt(slot), key) != 0 || !(block->ValueAt(slot) == value);
+            },
+            &empty_bucket, &empty_guard, &tombstone_bucket);
+        if (unique && tombstone_bucket < num_buckets) {
+          // the pair takes the first tombstone of its probe sequence, which is latched again if it is in another
+          // block; if a concurrent insert has taken it meanwhile, the insert probes again
+          WritePageGuard guard;
+          if (tombstone_bucket / BLOCK_ARRAY_SIZE == empty_bucket / BLOCK_ARRAY_SIZE) {
+            guard = std::move(empty_guard);
+          } else {
+            empty_guard.Drop();
+            guard = FetchBlock<WritePageGuard>(header->GetBlockPageId(tombstone_bucket / BLOCK_ARRAY_SIZE));
+          }
+          inserted = guard.AsMut<HASH_TABLE_BLOCK_TYPE>()->Reuse(tombstone_bucket % BLOCK_ARRAY_SIZE, key, value,
+                                                                 HASH_TABLE_BLOCK_TYPE::TagOf(hash));
+          retry = !inserted;
+        } else if (unique && empty_bucket < num_buckets &&
+                   static_cast<double>(num_occupied_ + 1) <= MAX_LOAD_FACTOR * num_buckets) {
+          empty_guard.AsMut<HASH_TABLE_BLOCK_TYPE>()->Insert(empty_bucket % BLOCK_ARRAY_SIZE, key, value,
+                                                             HASH_TABLE_BLOCK_TYPE::TagOf(hash));
+          num_occupied_++;
+          inserted = true;
+        }
+        if (inserted) {
+          num_pairs_++;
+        }
+      }
+    } catch (const std::bad_alloc &) {
+      // the buffer pool has no frame for the block page of the empty bucket
+      return false;
+    }
+    if (migrated) {
+      FinishResize(old_header_page_id);
+    }
+    if (!unique || inserted) {
+      return inserted;
+    }
+    if (!retry && !Grow(header_page_id)) {
+      return false;
+    }
+  }
 }
 
 /*****************************************************************************
@@ -48,21 +294,186 @@ bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+  const uint64_t hash = hash_fn_.GetHash(key);
+  page_id_t old_header_page_id = INVALID_PAGE_ID;
+  bool migrated = false;
+  bool removed = false;
+  {
+    ReadLatchGuard table_guard(&table_latch_);
+    old_header_page_id = old_header_page_id_;
+    migrated = TryMigrate();
+    if (old_header_page_id != INVALID_PAGE_ID) {
+      BasicPageGuard old_header_guard = buffer_pool_manager_->FetchPageBasic(old_header_page_id);
+      removed = RemovePair(old_header_guard.AsMut<HashTableHeaderPage>(), key, hash, value);
+    }
+    if (!removed) {
+      BasicPageGuard header_guard = buffer_pool_manager_->FetchPageBasic(header_page_id_);
+      removed = RemovePair(header_guard.AsMut<HashTableHeaderPage>(), key, hash, value);
+    }
+    if (removed) {
+      num_pairs_--;
+    }
+  }
+  if (migrated) {
+    FinishResize(old_header_page_id);
+  }
+  return removed;
 }
 
 /*****************************************************************************
  * RESIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Resize(size_t initial_size) {}
+void HASH_TABLE_TYPE::Resize(size_t initial_size) {
+  WriteLatchGuard table_guard(&table_latch_);
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    FreeOldTable();
+  }
+  StartResize(2 * initial_size);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::IsResizing() {
+  ReadLatchGuard table_guard(&table_latch_);
+  return old_header_page_id_ != INVALID_PAGE_ID;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::StartResize(size_t num_buckets) {
+  BasicPageGuard header_guard = buffer_pool_manager_->FetchPageBasic(header_page_id_);
+  // the table never shrinks, so that the pairs are sure to fit, and grows up to the blocks its header page holds
+  size_t size = header_guard.As<HashTableHeaderPage>()->GetSize();
+  header_guard.Drop();
+  const size_t max_size = HashTableHeaderPage::MAX_BLOCKS * BLOCK_ARRAY_SIZE;
+  if (num_buckets > size && size == max_size) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "hash table has more blocks than its header page holds");
+  }
+  // the ids only change once the new table exists, so that a failure leaves the table as it was
+  const page_id_t header_page_id = CreateTable(std::clamp(num_buckets, size, max_size));
+  old_header_page_id_ = header_page_id_;
+  header_page_id_ = header_page_id;
+  migrate_bucket_ = 0;
+  num_occupied_ = 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::Migrate(size_t num_groups) {
+  if (old_header_page_id_ == INVALID_PAGE_ID) {
+    return false;
+  }
+  BasicPageGuard old_header_guard = buffer_pool_manager_->FetchPageBasic(old_header_page_id_);
+  auto *old_header = old_header_guard.AsMut<HashTableHeaderPage>();
+  BasicPageGuard header_guard = buffer_pool_manager_->FetchPageBasic(header_page_id_);
+  auto *header = header_guard.AsMut<HashTableHeaderPage>();
+  const size_t old_num_buckets = old_header->GetSize();
+  for (; num_groups > 0 && migrate_bucket_ < old_num_buckets; num_groups--) {
+    // a group never spans two blocks, so that it takes a single page
+    const slot_offset_t begin = migrate_bucket_ % BLOCK_ARRAY_SIZE;
+    const slot_offset_t end = std::min(begin + HASH_TABLE_BLOCK_TYPE::GROUP_SIZE, BLOCK_ARRAY_SIZE);
+    const page_id_t old_block_page_id = old_header->GetBlockPageId(migrate_bucket_ / BLOCK_ARRAY_SIZE);
+    if (old_block_page_id == INVALID_PAGE_ID) {
+      migrate_bucket_ += BLOCK_ARRAY_SIZE - begin;
+      continue;
+    }
+    // the old block stays latched until its pairs are in the new table, so that no probe misses them in between
+    WritePageGuard old_guard = buffer_pool_manager_->FetchPageWrite(old_block_page_id);
+    for (slot_offset_t slot = begin; slot < end; slot++) {
+      const auto *old_block = old_guard.As<HASH_TABLE_BLOCK_TYPE>();
+      if (!old_block->IsReadable(slot)) {
+        continue;
+      }
+      // the pairs are distinct, so a pair goes to the end of its probe sequence without comparing keys
+      const KeyType key = old_block->KeyAt(slot);
+      const uint64_t hash = hash_fn_.GetHash(key);
+      size_t empty_bucket;
+      WritePageGuard empty_guard;
+      Probe<WritePageGuard>(
+          header, key, hash, [](WritePageGuard * /*guard*/, slot_offset_t /*slot*/) { return true; }, &empty_bucket,
+          &empty_guard);
+      assert(empty_bucket < header->GetSize());
+      empty_guard.AsMut<HASH_TABLE_BLOCK_TYPE>()->Insert(empty_bucket % BLOCK_ARRAY_SIZE, key,
+                                                         old_block->ValueAt(slot), HASH_TABLE_BLOCK_TYPE::TagOf(hash));
+      num_occupied_++;
+      empty_guard.Drop();
+      old_guard.AsMut<HASH_TABLE_BLOCK_TYPE>()->Remove(slot);
+    }
+    migrate_bucket_ += end - begin;
+  }
+  return migrate_bucket_ >= old_num_buckets;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::TryMigrate() {
+  // a write that finds another one migrating goes on with its own work rather than waiting for it
+  std::unique_lock<std::mutex> migrate_guard(migrate_latch_, std::try_to_lock);
+  try {
+    return migrate_guard.owns_lock() && Migrate(MIGRATE_GROUPS);
+  } catch (const std::bad_alloc &) {
+    // the pairs moved so far are in the new table; a later write moves the rest once a block page can be allocated
+    return false;
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::FreeOldTable() {
+  Migrate(SIZE_MAX);
+  BasicPageGuard old_header_guard = buffer_pool_manager_->FetchPageBasic(old_header_page_id_);
+  auto *old_header = old_header_guard.AsMut<HashTableHeaderPage>();
+  for (size_t i = 0; i < old_header->NumBlocks(); i++) {
+    if (old_header->GetBlockPageId(i) != INVALID_PAGE_ID) {
+      buffer_pool_manager_->DeletePage(old_header->GetBlockPageId(i));
+    }
+  }
+  old_header_guard.Drop();
+  buffer_pool_manager_->DeletePage(old_header_page_id_);
+  old_header_page_id_ = INVALID_PAGE_ID;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::FinishResize(page_id_t old_header_page_id) {
+  WriteLatchGuard table_guard(&table_latch_);
+  if (old_header_page_id_ == old_header_page_id) {
+    FreeOldTable();
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::Grow(page_id_t header_page_id) {
+  WriteLatchGuard table_guard(&table_latch_);
+  if (header_page_id_ != header_page_id) {
+    return true;
+  }
+  try {
+    // a resize moves MIGRATE_GROUPS per write, so it has hardly ever not finished yet when the new table fills up
+    if (old_header_page_id_ != INVALID_PAGE_ID) {
+      FreeOldTable();
+    } else {
+      BasicPageGuard header_guard = buffer_pool_manager_->FetchPageBasic(header_page_id_);
+      const size_t num_buckets = header_guard.As<HashTableHeaderPage>()->GetSize();
+      header_guard.Drop();
+      // a table whose occupied buckets are mostly tombstones is rebuilt at its size, which drops them, rather than
+      // doubled, so that inserts and removes that keep the number of pairs steady do not grow it forever
+      const bool mostly_tombstones = static_cast<double>(num_pairs_) < MAX_LOAD_FACTOR / 2 * num_buckets;
+      StartResize(mostly_tombstones ? num_buckets : 2 * num_buckets);
+    }
+  } catch (const Exception &) {
+    // the table has as many blocks as its header page holds
+    return false;
+  } catch (const std::bad_alloc &) {
+    // the buffer pool has no frame for a page of the new table
+    return false;
+  }
+  return true;
+}
 
 /*****************************************************************************
  * GETSIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 size_t HASH_TABLE_TYPE::GetSize() {
-  return 0;
+  ReadLatchGuard table_guard(&table_latch_);
+  BasicPageGuard header_guard = buffer_pool_manager_->FetchPageBasic(header_page_id_);
+  return header_guard.As<HashTableHeaderPage>()->GetSize();
 }
 
 template class LinearProbeHashTable<int, int, IntComparator>;
@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_access_strategy.h
+//
+// Identification: src/include/buffer/buffer_access_strategy.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+class BufferPoolManager;
+
+/**
+ * BufferAccessStrategy is a small private ring of frames for an access pattern that touches many pages once, such as
+ * a sequential scan of a large table (cf. PostgreSQL's BULKREAD strategy).
+ *
+ * A page that misses in the buffer pool while being fetched with a strategy is read into the next frame of the ring,
+ * as long as that frame still holds the page the ring put there and nobody has it pinned. Only when the ring is not
+ * full yet, or its frame has been taken over by somebody else, is a frame taken from the shared pool. A scan
+ * therefore recycles the same ring_size frames instead of evicting the whole working set of the pool.
+ *
+ * A strategy belongs to a single scan and must not be shared between threads. Pages that are already resident are
+ * fetched as usual and do not enter the ring. The scan must not keep more than ring_size pages pinned at a time.
+ */
+class BufferAccessStrategy {
+  friend class BufferPoolManager;
+
+ public:
+  /**
+   * Creates a new BufferAccessStrategy.
+   * @param ring_size the number of frames in the ring
+   */
+  explicit BufferAccessStrategy(size_t ring_size = BULKREAD_RING_SIZE) : ring_(ring_size) {
+    BUSTUB_ASSERT(ring_size > 0, "A ring needs at least one frame.");
+  }
+
+  DISALLOW_COPY(BufferAccessStrategy);
+
+  /** @return the number of frames in the ring */
+  size_t GetRingSize() const { return ring_.size(); }
+
+ private:
+  /** A frame of the ring, identified by the buffer pool instance that owns it and its frame id in that instance. */
+  struct RingSlot {
+    BufferPoolManager *owner_{nullptr};
+    frame_id_t frame_id_{-1};
+    /** The page the ring read into the frame; if the frame holds another page, it was taken over by the pool. */
+    page_id_t page_id_{INVALID_PAGE_ID};
+  };
+
+  /** @return the slot to use for the next miss, advancing the ring */
+  RingSlot *NextSlot() {
+    RingSlot *slot = &ring_[current_];
+    current_ = (current_ + 1) % ring_.size();
+    return slot;
+  }
+
+  /** The frames of the ring. */
+  std::vector<RingSlot> ring_;
+  /** The slot used by the next miss. */
+  size_t current_{0};
+};
+
+}  // namespace bustub
@@ -12,11 +12,20 @@
 
 #pragma once
 
+#include <condition_variable>  // NOLINT
+#include <deque>
 #include <list>
-#include <mutex>  // NOLINT
-#include <unordered_map>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <unordered_set>
+#include <vector>
 
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
 #include "buffer/lru_replacer.h"
+#include "buffer/page_guard.h"
+#include "buffer/page_table.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
@@ -25,34 +34,62 @@ namespace bustub {
 
 /**
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
+ *
+ * A BufferPoolManager can either be used on its own, or as one of the instances of a ParallelBufferPoolManager. In the
+ * latter case, the instance only ever allocates page ids that map back to itself, i.e. page ids that satisfy
+ * page_id % num_instances == instance_index.
  */
 class BufferPoolManager {
+  friend class ParallelBufferPoolManager;
+
  public:
   /**
    * Creates a new BufferPoolManager.
    * @param pool_size the size of the buffer pool
    * @param disk_manager the disk manager
    * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_policy the replacement policy used to pick victim frames
+   */
+  BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                    ReplacerPolicy replacer_policy = ReplacerPolicy::LRU);
+
+  /**
+   * Creates a new BufferPoolManager that is one instance of a ParallelBufferPoolManager.
+   * @param pool_size the size of the buffer pool
+   * @param num_instances the total number of instances in the parallel buffer pool
+   * @param instance_index the index of this instance in the parallel buffer pool
+   * @param disk_manager the disk manager
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_policy the replacement policy used to pick victim frames
    */
-  BufferPoolManager(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr);
+  BufferPoolManager(size_t pool_size, uint32_t num_instances, uint32_t instance_index, DiskManager *disk_manager,
+                    LogManager *log_manager = nullptr, ReplacerPolicy replacer_policy = ReplacerPolicy::LRU);
 
   /**
    * Destroys an existing BufferPoolManager.
    */
-  ~BufferPoolManager();
+  virtual ~BufferPoolManager();
 
   /** @return pointer to all the pages in the buffer pool */
   Page *GetPages() { return pages_; }
 
   /** @return size of the buffer pool */
-  size_t GetPoolSize() { return pool_size_; }
+  virtual size_t GetPoolSize() { return pool_size_; }
 
   /**
    * Fetch the requested page from the buffer pool.
    * @param page_id id of page to be fetched
    * @return the requested page
    */
-  Page *FetchPage(page_id_t page_id);
+  Page *FetchPage(page_id_t page_id) { return FetchPage(page_id, nullptr); }
+
+  /**
+   * Fetch the requested page from the buffer pool, reading it into a frame of the strategy's ring on a miss.
+   * @param page_id id of page to be fetched
+   * @param strategy the access strategy of the caller, nullptr to use the shared pool
+   * @return the requested page
+   */
+  virtual Page *FetchPage(page_id_t page_id, BufferAccessStrategy *strategy);
 
   /**
    * Unpin the target page from the buffer pool.
@@ -60,50 +97,276 @@ class BufferPoolManager {
    * @param is_dirty true if the page should be marked as dirty, false otherwise
    * @return false if the page pin count is <= 0 before this call, true otherwise
    */
-  bool UnpinPage(page_id_t page_id, bool is_dirty);
+  virtual bool UnpinPage(page_id_t page_id, bool is_dirty);
 
   /**
    * Flushes the target page to disk.
    * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
    * @return false if the page could not be found in the page table, true otherwise
    */
-  bool FlushPage(page_id_t page_id);
+  virtual bool FlushPage(page_id_t page_id);
 
   /**
    * Creates a new page in the buffer pool.
    * @param[out] page_id id of created page
    * @return nullptr if no new pages could be created, otherwise pointer to new page
    */
-  Page *NewPage(page_id_t *page_id);
+  virtual Page *NewPage(page_id_t *page_id);
 
   /**
    * Deletes a page from the buffer pool.
    * @param page_id id of page to be deleted
    * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
    */
-  bool DeletePage(page_id_t page_id);
+  virtual bool DeletePage(page_id_t page_id);
 
   /**
    * Flushes all the pages in the buffer pool to disk.
    */
-  void FlushAllPages();
+  virtual void FlushAllPages();
+
+  /**
+   * Looks up a resident page without pinning or latching it, for optimistic readers (see Page::ReadVersion). The
+   * frame may be handed over to another page at any time; the reader notices through the page version and the page id
+   * of the frame.
+   * @param page_id id of page to look up
+   * @return the frame of the page, or nullptr if the page is not resident
+   */
+  virtual Page *FindResidentPage(page_id_t page_id);
+
+  /**
+   * Fetch the requested page, pinned until the returned guard is dropped or destroyed.
+   * @param page_id id of page to be fetched
+   * @return a guard of the requested page, which guards nothing if the page could not be fetched
+   */
+  BasicPageGuard FetchPageBasic(page_id_t page_id) { return BasicPageGuard(this, FetchPage(page_id)); }
+
+  /**
+   * Fetch the requested page and latch it for reading. The latch and the pin are released when the returned guard is
+   * dropped or destroyed.
+   * @param page_id id of page to be fetched
+   * @param strategy the access strategy of the caller, nullptr to use the shared pool
+   * @return a guard of the requested page, which guards nothing if the page could not be fetched
+   */
+  ReadPageGuard FetchPageRead(page_id_t page_id, BufferAccessStrategy *strategy = nullptr);
+
+  /**
+   * Fetch the requested page and latch it for writing. The latch and the pin are released when the returned guard is
+   * dropped or destroyed.
+   * @param page_id id of page to be fetched
+   * @return a guard of the requested page, which guards nothing if the page could not be fetched
+   */
+  WritePageGuard FetchPageWrite(page_id_t page_id);
+
+  /**
+   * Creates a new page, pinned until the returned guard is dropped or destroyed.
+   * @param[out] page_id id of created page
+   * @return a guard of the new page, which guards nothing if no new page could be created
+   */
+  BasicPageGuard NewPageGuarded(page_id_t *page_id) { return BasicPageGuard(this, NewPage(page_id)); }
+
+  /**
+   * Start the background threads that serve PrefetchPage and PrefetchRange. Prefetch requests are ignored while the
+   * threads are not running.
+   * @param num_threads the number of prefetch threads, i.e. the number of reads that may be in flight at once
+   */
+  void RunPrefetchThreads(size_t num_threads);
+
+  /**
+   * Stop and join the prefetch threads. Requests that are still queued are dropped.
+   */
+  void StopPrefetchThreads();
+
+  /**
+   * Asks the prefetch threads to read a page into the buffer pool, without pinning it, so that a later FetchPage of
+   * the page does not have to wait for the disk. Prefetching is a hint: the request is dropped if the page is
+   * already resident, has never been written, no frame can be freed, or too many requests are queued already.
+   * @param page_id id of page to be prefetched
+   * @return true if the request was queued
+   */
+  bool PrefetchPage(page_id_t page_id);
+
+  /**
+   * Asks the prefetch threads to read the pages [first_page_id, first_page_id + num_pages) into the buffer pool.
+   * @param first_page_id id of the first page to be prefetched
+   * @param num_pages number of pages to be prefetched
+   */
+  void PrefetchRange(page_id_t first_page_id, size_t num_pages);
+
+  /**
+   * Start the background writer. Every bg_writer_interval, it writes back the dirty pages among the next
+   * num_clean_frames frames the replacer is going to victimize, so that requests that need a frame find a clean one
+   * and do not have to wait for a write.
+   * @param num_clean_frames the number of frames at the eviction end of the replacer to keep clean
+   */
+  virtual void RunBackgroundWriter(size_t num_clean_frames);
+
+  /**
+   * Stop and join the background writer.
+   */
+  virtual void StopBackgroundWriter();
+
+  /** @return the number of dirty pages that requests had to write back themselves to free their frame */
+  virtual size_t GetNumForegroundWrites() { return num_foreground_writes_; }
+
+  /** @return the number of dirty pages the background writer has written back */
+  virtual size_t GetNumBackgroundWrites() { return num_background_writes_; }
 
  protected:
+  /** Maximum number of queued prefetch requests. */
+  static constexpr size_t PREFETCH_QUEUE_SIZE = 256;
+  /** Pin count of a frame that is being handed over to another page or freed, which cannot be pinned. */
+  static constexpr int RESERVED_PIN_COUNT = -1;
+
+  /**
+   * Pins a page without taking latch_, if it is resident and not being read in.
+   * @param page_id id of the page to pin
+   * @return the pinned page, or nullptr if the caller has to take the slow path under latch_
+   */
+  Page *PinResidentPage(page_id_t page_id);
+
+  /**
+   * Claims an unpinned frame, so that nobody can pin it until ReserveFrame or DeletePage hands it over. Must be called
+   * with latch_ held.
+   * @param frame_id the frame to claim
+   * @return false if the frame is pinned
+   */
+  bool ClaimFrame(frame_id_t frame_id);
+
+  /**
+   * Takes a frame from the free list or, if it is empty, a victim from the replacer, and claims it. Must be called
+   * with latch_ held.
+   * @param[out] frame_id the claimed frame
+   * @return false if every frame is pinned
+   */
+  bool FindFreeFrame(frame_id_t *frame_id);
+
+  /**
+   * Hands a frame whose pin count dropped to zero to the replacer, unless it was pinned or freed again meanwhile.
+   * Does not take latch_, so the replacer must be thread-safe on its own.
+   * @param frame_id the frame
+   */
+  void MakeEvictable(frame_id_t frame_id);
+
+  /**
+   * Reads a page into an unpinned frame of the buffer pool unless it is resident already. The page is read without
+   * holding latch_, so that other threads can use the buffer pool in the meantime.
+   * @param page_id id of page to be read
+   * @return true if the page was read into the buffer pool
+   */
+  virtual bool ReadAhead(page_id_t page_id);
+
+  /** Body of the prefetch threads: serves queued prefetch requests until the threads are stopped. */
+  void RunPrefetch();
+
+  /** Body of the background writer: calls WriteBackDirtyVictims every bg_writer_interval until it is stopped. */
+  void RunBackgroundWrite();
+
+  /**
+   * Writes back the dirty pages among the next num_clean_frames_ victims. The pages are marked clean and copied under
+   * latch_, and written without holding it.
+   * @return the number of pages written
+   */
+  size_t WriteBackDirtyVictims();
+
+  /**
+   * Writes a page back to disk and drops the pin that the caller took for it under latch_. Must be called without
+   * holding latch_. If the page is still being written back by another thread, waits for it first, so that the older
+   * copy cannot overwrite this one.
+   * @param frame_id the frame of the page to write
+   */
+  void WriteBack(frame_id_t frame_id);
+
+  /**
+   * Hands a frame over to page_id in the page table, pins it and marks it as having I/O in progress, so that the
+   * caller can drop latch_ while it transfers the frame's contents. Threads that fetch page_id in the meantime wait
+   * on the frame's I/O event. If the frame holds a dirty page, that page is registered as being written back, so
+   * that fetching it waits until it is on disk. Must be called with latch_ held.
+   * @param frame_id the frame to hand over, which must be claimed and neither in the free list nor in the replacer
+   * @param page_id id of the page the frame is reserved for
+   * @return the id of the dirty page the caller must write back with WriteBackVictim, or INVALID_PAGE_ID
+   */
+  page_id_t ReserveFrame(frame_id_t frame_id, page_id_t page_id);
+
+  /**
+   * Ends the I/O of a frame reserved by ReserveFrame and wakes up the threads waiting for it. Must be called with
+   * latch_ held.
+   * @param page the page of the frame
+   */
+  void FinishIO(Page *page);
+
+  /**
+   * Writes back a dirty victim on behalf of a request that needs its frame, and wakes up the background writer.
+   * Must be called without holding latch_.
+   * @param page_id id of the victim page, as returned by ReserveFrame
+   * @param data the contents of the victim page
+   */
+  void WriteBackVictim(page_id_t page_id, const char *data);
+
+  /** Waits until page_id is not being written back. */
+  void WaitForBackgroundWrite(page_id_t page_id);
+
+  /**
+   * Allocate a page id on disk. The returned page id always belongs to this instance.
+   * @return the id of the allocated page
+   */
+  page_id_t AllocatePage();
+
   /** Number of pages in the buffer pool. */
   size_t pool_size_;
+  /** Number of instances in the parallel buffer pool this instance belongs to (1 if standalone). */
+  const uint32_t num_instances_ = 1;
+  /** Index of this instance in the parallel buffer pool (0 if standalone). */
+  const uint32_t instance_index_ = 0;
+  /** Each instance hands out page ids that are congruent to instance_index_ modulo num_instances_. */
+  std::atomic<page_id_t> next_page_id_;
   /** Array of buffer pool pages. */
   Page *pages_;
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_;
   /** Pointer to the log manager. */
   LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
+  /** Page table for keeping track of buffer pool pages. Lookups do not need latch_, changes do. */
+  PageTable page_table_;
   /** Replacer to find unpinned pages for replacement. */
   Replacer *replacer_;
   /** List of free pages. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /** Protects free_list_, serializes the changes of page_table_, and protects the book-keeping fields (pin count, dirty
+   * flag, page id, I/O state) of pages_, except that resident pages are pinned and unpinned without it: see
+   * PinResidentPage and ClaimFrame. Disk transfers happen without holding it: see ReserveFrame. */
   std::mutex latch_;
+
+  /** True while the prefetch threads are running. */
+  std::atomic<bool> enable_prefetch_{false};
+  /** The prefetch threads. */
+  std::vector<std::thread *> prefetch_threads_;
+  /** Pages waiting to be prefetched. */
+  std::deque<page_id_t> prefetch_queue_;
+  /** Protects prefetch_queue_. */
+  std::mutex prefetch_latch_;
+  /** Signals the prefetch threads that a request was queued or that they should stop. */
+  std::condition_variable prefetch_cv_;
+
+  /** Number of frames at the eviction end of the replacer the background writer keeps clean. */
+  size_t num_clean_frames_{0};
+  /** True while the background writer is running. */
+  std::atomic<bool> enable_bg_writer_{false};
+  /** The background writer. */
+  std::thread *bg_writer_thread_{nullptr};
+  /** Wakes up the background writer when it should stop. */
+  std::condition_variable bg_writer_cv_;
+  /** Protects the stop signal of the background writer. */
+  std::mutex bg_writer_latch_;
+  /** Pages that are being written back right now, by the background writer or by requests that evicted them. */
+  std::unordered_set<page_id_t> pages_being_written_;
+  /** Protects pages_being_written_. Never acquire latch_ while holding it. */
+  std::mutex write_latch_;
+  /** Signals that pages were removed from pages_being_written_. */
+  std::condition_variable write_cv_;
+  /** Number of dirty pages written back by requests that needed their frame. */
+  std::atomic<size_t> num_foreground_writes_{0};
+  /** Number of dirty pages written back by the background writer. */
+  std::atomic<size_t> num_background_writes_{0};
 };
 }  // namespace bustub
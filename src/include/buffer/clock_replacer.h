@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// clock_replacer.h
+//
+// Identification: src/include/buffer/clock_replacer.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * ClockReplacer implements the clock (second chance) replacement policy, which approximates the Least Recently Used
+ * policy.
+ *
+ * ClockReplacer does not take any latch. Every frame has an atomic state that says whether the frame is in the
+ * replacer and whether its reference bit is set, so Pin and Unpin are a single atomic exchange. Only Victim sweeps:
+ * it advances an atomic clock hand, clearing reference bits until it finds an unreferenced frame it can claim.
+ */
+class ClockReplacer : public Replacer {
+ public:
+  /**
+   * Create a new ClockReplacer.
+   * @param num_pages the maximum number of pages the ClockReplacer will be required to store
+   */
+  explicit ClockReplacer(size_t num_pages);
+
+  /**
+   * Destroys the ClockReplacer.
+   */
+  ~ClockReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  std::vector<frame_id_t> PeekVictims(size_t num_frames) override;
+
+  size_t Size() override;
+
+ private:
+  /** The frame is not in the replacer, i.e. it is pinned or free. */
+  static constexpr uint8_t NOT_PRESENT = 0;
+  /** The frame is in the replacer and its reference bit is clear, so the clock hand can take it. */
+  static constexpr uint8_t PRESENT = 1;
+  /** The frame is in the replacer and its reference bit is set, so the clock hand gives it a second chance. */
+  static constexpr uint8_t REFERENCED = 2;
+
+  /** Number of frames. */
+  const size_t num_pages_;
+  /** Per-frame state, one of NOT_PRESENT, PRESENT and REFERENCED. */
+  std::vector<std::atomic<uint8_t>> states_;
+  /** Number of frames in the replacer. */
+  std::atomic<size_t> size_{0};
+  /** Total number of frames the clock hand has passed; the hand points at clock_hand_ % num_pages_. */
+  std::atomic<size_t> clock_hand_{0};
+};
+
+}  // namespace bustub
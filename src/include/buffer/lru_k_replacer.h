@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.h
+//
+// Identification: src/include/buffer/lru_k_replacer.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <mutex>  // NOLINT
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * LRUKReplacer implements the LRU-K replacement policy.
+ *
+ * Every Pin counts as an access to the frame. The replacer remembers the timestamps of the last K accesses of every
+ * frame and evicts the frame whose backward K-distance, i.e. the time since its K-th most recent access, is the
+ * largest. Frames with fewer than K accesses have an infinite backward K-distance and are evicted first, in LRU order
+ * of their first access. A page that is touched once by a sequential scan therefore never pushes out a page that is
+ * accessed over and over again.
+ *
+ * A frame's history is forgotten when the frame is victimized or removed, since the frame is about to hold another
+ * page.
+ */
+class LRUKReplacer : public Replacer {
+ public:
+  /**
+   * Create a new LRUKReplacer.
+   * @param num_pages the maximum number of pages the LRUKReplacer will be required to store
+   * @param k the number of accesses remembered per frame
+   */
+  explicit LRUKReplacer(size_t num_pages, size_t k = LRUK_REPLACER_K);
+
+  /**
+   * Destroys the LRUKReplacer.
+   */
+  ~LRUKReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  std::vector<frame_id_t> PeekVictims(size_t num_frames) override;
+
+  size_t Size() override;
+
+ private:
+  /** Eviction order key: (timestamp, frame id), smallest is evicted first. */
+  using Key = std::pair<uint64_t, frame_id_t>;
+
+  /** Access history of a single frame. */
+  struct FrameInfo {
+    /** Timestamps of the last (at most k_) accesses, oldest first. */
+    std::deque<uint64_t> history_;
+    /** True if the frame can be victimized, i.e. it is in one of the eviction sets. */
+    bool evictable_{false};
+  };
+
+  /** @return the key of an evictable frame: its first access if it has fewer than k_ accesses, else its k-th last */
+  Key EvictionKey(frame_id_t frame_id) const { return {frames_[frame_id].history_.front(), frame_id}; }
+
+  /** @return the eviction set the frame belongs to, depending on how many accesses it has seen */
+  std::set<Key> *EvictionSet(frame_id_t frame_id);
+
+  /** Takes frame_id out of the eviction sets. */
+  void MakeUnevictable(frame_id_t frame_id);
+
+  /** Number of accesses remembered per frame. */
+  const size_t k_;
+  /** Logical clock, incremented on every access. */
+  uint64_t current_timestamp_{0};
+  /** Per-frame access history, indexed by frame id. */
+  std::vector<FrameInfo> frames_;
+  /** Evictable frames with fewer than k_ accesses, ordered by their first access. */
+  std::set<Key> young_frames_;
+  /** Evictable frames with k_ accesses, ordered by their k-th most recent access. */
+  std::set<Key> old_frames_;
+  /** Protects all of the above. */
+  std::mutex latch_;
+};
+
+}  // namespace bustub
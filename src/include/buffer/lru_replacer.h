@@ -12,7 +12,6 @@
 
 #pragma once
 
-#include <list>
 #include <mutex>  // NOLINT
 #include <vector>
 
@@ -23,14 +22,23 @@ namespace bustub {
 
 /**
  * LRUReplacer implements the lru replacement policy, which approximates the Least Recently Used policy.
+ *
+ * The unpinned frames are kept in a doubly-linked list whose nodes are stored in an array indexed by frame id, so
+ * Victim, Pin and Unpin are all O(1) regardless of the number of frames.
  */
 class LRUReplacer : public Replacer {
  public:
   /**
-   * Create a new LRUReplacer.
+   * Create a new LRUReplacer. The node array grows on demand as larger frame ids are unpinned.
    */
   LRUReplacer();
 
+  /**
+   * Create a new LRUReplacer.
+   * @param num_pages the maximum number of pages the LRUReplacer will be required to store
+   */
+  explicit LRUReplacer(size_t num_pages);
+
   /**
    * Destroys the LRUReplacer.
    */
@@ -42,10 +50,33 @@ class LRUReplacer : public Replacer {
 
   void Unpin(frame_id_t frame_id) override;
 
+  void Remove(frame_id_t frame_id) override;
+
+  std::vector<frame_id_t> PeekVictims(size_t num_frames) override;
+
   size_t Size() override;
 
  private:
-  std::list<frame_id_t> my_list;
+  /** A list node; prev_ and next_ are frame ids, INVALID_FRAME_ID marks the ends of the list. */
+  struct Node {
+    frame_id_t prev_{INVALID_FRAME_ID};
+    frame_id_t next_{INVALID_FRAME_ID};
+    bool in_list_{false};
+  };
+
+  static constexpr frame_id_t INVALID_FRAME_ID = -1;
+
+  /** Unlinks frame_id from the list. The frame must be in the list, and the latch held. */
+  void Unlink(frame_id_t frame_id);
+
+  /** List nodes, indexed by frame id. */
+  std::vector<Node> nodes_;
+  /** Least recently unpinned frame, i.e. the next victim. */
+  frame_id_t head_{INVALID_FRAME_ID};
+  /** Most recently unpinned frame. */
+  frame_id_t tail_{INVALID_FRAME_ID};
+  /** Number of frames in the list. */
+  size_t size_{0};
 
  protected:
   mutable std::mutex latch;
@@ -0,0 +1,225 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_guard.h
+//
+// Identification: src/include/buffer/page_guard.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+class BufferPoolManager;
+class ReadPageGuard;
+class WritePageGuard;
+
+/**
+ * BasicPageGuard owns one pin of a page: it unpins the page when it is dropped, destroyed or moved onto. The page is
+ * unpinned as dirty if it was accessed through GetDataMut, AsMut or SetDirty.
+ *
+ * Guards are move-only, so that a pin is released exactly once no matter which path a caller takes. A default
+ * constructed guard, or the guard of a FetchPage or NewPage call that failed, guards nothing: see IsValid.
+ */
+class BasicPageGuard {
+  friend class ReadPageGuard;
+  friend class WritePageGuard;
+
+ public:
+  BasicPageGuard() = default;
+
+  /**
+   * Takes over a pin of page.
+   * @param bpm the buffer pool manager the page was pinned in
+   * @param page the pinned page, or nullptr to guard nothing
+   */
+  BasicPageGuard(BufferPoolManager *bpm, Page *page) : bpm_(bpm), page_(page) {}
+
+  DISALLOW_COPY(BasicPageGuard);
+
+  BasicPageGuard(BasicPageGuard &&that) noexcept : bpm_(that.bpm_), page_(that.page_), is_dirty_(that.is_dirty_) {
+    that.page_ = nullptr;
+  }
+
+  /** Unpins the page this guard held, if any, and takes over the pin of that. */
+  BasicPageGuard &operator=(BasicPageGuard &&that) noexcept;
+
+  ~BasicPageGuard() { Drop(); }
+
+  /** Unpins the page. The guard guards nothing afterwards. */
+  void Drop();
+
+  /**
+   * Latches the page for reading and moves the pin into a ReadPageGuard. This guard guards nothing afterwards.
+   * @return the read guard
+   */
+  ReadPageGuard UpgradeRead();
+
+  /**
+   * Latches the page for writing and moves the pin into a WritePageGuard. This guard guards nothing afterwards.
+   * @return the write guard
+   */
+  WritePageGuard UpgradeWrite();
+
+  /** @return true if the guard holds a pin */
+  bool IsValid() const { return page_ != nullptr; }
+
+  /** @return the id of the guarded page */
+  page_id_t PageId() { return page_->GetPageId(); }
+
+  /** @return the guarded page, for page types that derive from Page. Call SetDirty after modifying it. */
+  Page *GetPage() { return page_; }
+
+  /** Marks the page as modified, so that it is unpinned as dirty. */
+  void SetDirty() { is_dirty_ = true; }
+
+  /** @return the data of the guarded page */
+  const char *GetData() { return page_->GetData(); }
+
+  /** @return the data of the guarded page, which is marked as modified */
+  char *GetDataMut() {
+    is_dirty_ = true;
+    return page_->GetData();
+  }
+
+  /** @return the data of the guarded page, interpreted as T */
+  template <class T>
+  const T *As() {
+    return reinterpret_cast<const T *>(GetData());
+  }
+
+  /** @return the data of the guarded page, interpreted as T, which is marked as modified */
+  template <class T>
+  T *AsMut() {
+    return reinterpret_cast<T *>(GetDataMut());
+  }
+
+ private:
+  BufferPoolManager *bpm_{nullptr};
+  Page *page_{nullptr};
+  bool is_dirty_{false};
+};
+
+/**
+ * ReadPageGuard owns one pin and the read latch of a page, and releases both, latch first, when it is dropped,
+ * destroyed or moved onto.
+ */
+class ReadPageGuard {
+  friend class BasicPageGuard;
+
+ public:
+  ReadPageGuard() = default;
+
+  /**
+   * Takes over a pin and the read latch of page.
+   * @param bpm the buffer pool manager the page was pinned in
+   * @param page the pinned and read-latched page, or nullptr to guard nothing
+   */
+  ReadPageGuard(BufferPoolManager *bpm, Page *page) : guard_(bpm, page) {}
+
+  DISALLOW_COPY(ReadPageGuard);
+
+  ReadPageGuard(ReadPageGuard &&that) noexcept = default;
+
+  /** Releases the page this guard held, if any, and takes over the latch and pin of that. */
+  ReadPageGuard &operator=(ReadPageGuard &&that) noexcept;
+
+  ~ReadPageGuard() { Drop(); }
+
+  /** Releases the read latch and unpins the page. The guard guards nothing afterwards. */
+  void Drop();
+
+  /** @return true if the guard holds a latch and a pin */
+  bool IsValid() const { return guard_.IsValid(); }
+
+  /** @return the id of the guarded page */
+  page_id_t PageId() { return guard_.PageId(); }
+
+  /** @return the guarded page, for page types that derive from Page */
+  Page *GetPage() { return guard_.GetPage(); }
+
+  /** @return the data of the guarded page */
+  const char *GetData() { return guard_.GetData(); }
+
+  /** @return the data of the guarded page, interpreted as T */
+  template <class T>
+  const T *As() {
+    return guard_.As<T>();
+  }
+
+ private:
+  BasicPageGuard guard_;
+};
+
+/**
+ * WritePageGuard owns one pin and the write latch of a page, and releases both, latch first, when it is dropped,
+ * destroyed or moved onto.
+ */
+class WritePageGuard {
+  friend class BasicPageGuard;
+
+ public:
+  WritePageGuard() = default;
+
+  /**
+   * Takes over a pin and the write latch of page.
+   * @param bpm the buffer pool manager the page was pinned in
+   * @param page the pinned and write-latched page, or nullptr to guard nothing
+   */
+  WritePageGuard(BufferPoolManager *bpm, Page *page) : guard_(bpm, page) {}
+
+  DISALLOW_COPY(WritePageGuard);
+
+  WritePageGuard(WritePageGuard &&that) noexcept = default;
+
+  /** Releases the page this guard held, if any, and takes over the latch and pin of that. */
+  WritePageGuard &operator=(WritePageGuard &&that) noexcept;
+
+  ~WritePageGuard() { Drop(); }
+
+  /** Releases the write latch and unpins the page. The guard guards nothing afterwards. */
+  void Drop();
+
+  /** @return true if the guard holds a latch and a pin */
+  bool IsValid() const { return guard_.IsValid(); }
+
+  /** @return the id of the guarded page */
+  page_id_t PageId() { return guard_.PageId(); }
+
+  /** @return the guarded page, for page types that derive from Page. Call SetDirty after modifying it. */
+  Page *GetPage() { return guard_.GetPage(); }
+
+  /** Marks the page as modified, so that it is unpinned as dirty. */
+  void SetDirty() { guard_.SetDirty(); }
+
+  /** @return the data of the guarded page */
+  const char *GetData() { return guard_.GetData(); }
+
+  /** @return the data of the guarded page, which is marked as modified */
+  char *GetDataMut() { return guard_.GetDataMut(); }
+
+  /** @return the data of the guarded page, interpreted as T */
+  template <class T>
+  const T *As() {
+    return guard_.As<T>();
+  }
+
+  /** @return the data of the guarded page, interpreted as T, which is marked as modified */
+  template <class T>
+  T *AsMut() {
+    return guard_.AsMut<T>();
+  }
+
+ private:
+  BasicPageGuard guard_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.h
+//
+// Identification: src/include/buffer/page_table.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * PageTable maps the ids of the pages in a buffer pool to their frames.
+ *
+ * PageTable is an open-addressing hash table with linear probing, whose slots each hold a page id and a frame id in a
+ * single atomic word, so Find takes no latch and never follows a pointer. Insert and Erase must be serialized by the
+ * caller. Erase shifts the entries that follow the erased one back instead of leaving tombstones, so probe sequences
+ * never grow longer than the table is full.
+ *
+ * A Find that runs concurrently with an Insert or Erase can miss an entry that is in the table (a shifted entry may
+ * move behind it), or return an entry that has just been erased. The caller must confirm a miss under the latch that
+ * serializes the writers, and a hit by checking the frame it found.
+ */
+class PageTable {
+ public:
+  /**
+   * Creates an empty page table.
+   * @param capacity the maximum number of entries the table has to hold, i.e. the number of frames
+   */
+  explicit PageTable(size_t capacity);
+
+  DISALLOW_COPY_AND_MOVE(PageTable);
+
+  /**
+   * Looks up a page. Does not take any latch.
+   * @param page_id id of the page to look up
+   * @param[out] frame_id the frame of the page, if the page was found
+   * @return true if the page was found
+   */
+  bool Find(page_id_t page_id, frame_id_t *frame_id) const;
+
+  /**
+   * Maps a page to a frame, replacing the mapping of the page if it has one.
+   * @param page_id id of the page, which must not be INVALID_PAGE_ID
+   * @param frame_id the frame of the page
+   */
+  void Insert(page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * Removes the mapping of a page, if it has one.
+   * @param page_id id of the page
+   */
+  void Erase(page_id_t page_id);
+
+ private:
+  /** Value of an empty slot. No entry packs to it, since INVALID_PAGE_ID is never inserted. */
+  static constexpr uint64_t EMPTY_SLOT = ~static_cast<uint64_t>(0);
+
+  static uint64_t Pack(page_id_t page_id, frame_id_t frame_id) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << 32) | static_cast<uint32_t>(frame_id);
+  }
+  static page_id_t PageIdOf(uint64_t slot) { return static_cast<page_id_t>(slot >> 32); }
+  static frame_id_t FrameIdOf(uint64_t slot) { return static_cast<frame_id_t>(slot & 0xFFFFFFFF); }
+
+  /** @return the slot a page's probe sequence starts at */
+  size_t HomeSlot(page_id_t page_id) const;
+
+  /** @return the slot that holds page_id, or the empty slot that ends its probe sequence */
+  size_t FindSlot(page_id_t page_id) const;
+
+  /** Number of slots minus one. The number of slots is a power of two, at least twice the capacity. */
+  size_t mask_;
+  /** Number of bits of a slot index. */
+  int num_bits_;
+  /** The slots, each EMPTY_SLOT or a packed page id and frame id. */
+  std::vector<std::atomic<uint64_t>> slots_;
+};
+
+}  // namespace bustub
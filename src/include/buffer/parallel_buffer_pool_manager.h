@@ -0,0 +1,140 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/parallel_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * ParallelBufferPoolManager shards the buffer pool into several independent BufferPoolManager instances, each with
+ * its own frames, page table and latch. A page always lives in the instance selected by page_id % num_instances, so
+ * operations on pages of different instances never contend on the same latch.
+ *
+ * The prefetch threads are shared by all instances: they are run by the ParallelBufferPoolManager itself, which hands
+ * every request to the instance that owns the page.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * Creates a new ParallelBufferPoolManager.
+   * @param num_instances the number of individual BufferPoolManager instances to create
+   * @param pool_size the pool size of each instance
+   * @param disk_manager the disk manager
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_policy the replacement policy of each instance
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            LogManager *log_manager = nullptr, ReplacerPolicy replacer_policy = ReplacerPolicy::LRU);
+
+  /**
+   * Destroys an existing ParallelBufferPoolManager.
+   */
+  ~ParallelBufferPoolManager() override;
+
+  /** @return size of the buffer pool, i.e. the sum of the pool sizes of all instances */
+  size_t GetPoolSize() override;
+
+  /** @return the number of instances */
+  size_t GetNumInstances() const { return instances_.size(); }
+
+  using BufferPoolManager::FetchPage;
+
+  /**
+   * Fetch the requested page from the instance that owns it.
+   * @param page_id id of page to be fetched
+   * @param strategy the access strategy of the caller, nullptr to use the shared pool
+   * @return the requested page
+   */
+  Page *FetchPage(page_id_t page_id, BufferAccessStrategy *strategy) override;
+
+  /**
+   * Unpin the target page from the instance that owns it.
+   * @param page_id id of page to be unpinned
+   * @param is_dirty true if the page should be marked as dirty, false otherwise
+   * @return false if the page pin count is <= 0 before this call, true otherwise
+   */
+  bool UnpinPage(page_id_t page_id, bool is_dirty) override;
+
+  /**
+   * Flushes the target page to disk.
+   * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
+   * @return false if the page could not be found in the page table, true otherwise
+   */
+  bool FlushPage(page_id_t page_id) override;
+
+  /**
+   * Creates a new page. Instances are tried in round robin order, starting from a different instance on every call,
+   * until one of them has a frame available.
+   * @param[out] page_id id of created page
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  Page *NewPage(page_id_t *page_id) override;
+
+  /**
+   * Deletes a page from the instance that owns it.
+   * @param page_id id of page to be deleted
+   * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
+   */
+  bool DeletePage(page_id_t page_id) override;
+
+  /**
+   * Flushes all the pages of every instance to disk.
+   */
+  void FlushAllPages() override;
+
+  /**
+   * Looks up a resident page in the instance that owns it, without pinning or latching it.
+   * @param page_id id of page to look up
+   * @return the frame of the page, or nullptr if the page is not resident
+   */
+  Page *FindResidentPage(page_id_t page_id) override;
+
+  /**
+   * Start the background writer of every instance.
+   * @param num_clean_frames the number of frames at the eviction end of each instance's replacer to keep clean
+   */
+  void RunBackgroundWriter(size_t num_clean_frames) override;
+
+  /**
+   * Stop the background writer of every instance.
+   */
+  void StopBackgroundWriter() override;
+
+  /** @return the number of foreground writes of all instances */
+  size_t GetNumForegroundWrites() override;
+
+  /** @return the number of background writes of all instances */
+  size_t GetNumBackgroundWrites() override;
+
+ protected:
+  /** Reads a page ahead into the instance that owns it. */
+  bool ReadAhead(page_id_t page_id) override;
+
+ private:
+  /** @return the instance responsible for page_id */
+  BufferPoolManager *GetInstance(page_id_t page_id);
+
+  /** The individual buffer pool instances. */
+  std::vector<BufferPoolManager *> instances_;
+  /** The instance the next NewPage call starts at. */
+  std::atomic<size_t> next_instance_{0};
+};
+
+}  // namespace bustub
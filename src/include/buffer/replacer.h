@@ -12,10 +12,15 @@
 
 #pragma once
 
+#include <vector>
+
 #include "common/config.h"
 
 namespace bustub {
 
+/** The replacement policies a BufferPoolManager can be configured with. */
+enum class ReplacerPolicy { LRU, CLOCK, LRU_K };
+
 /**
  * Replacer is an abstract class that tracks page usage.
  */
@@ -43,6 +48,20 @@ class Replacer {
    */
   virtual void Unpin(frame_id_t frame_id) = 0;
 
+  /**
+   * Removes a frame that is no longer backed by a page, e.g. because the page was deleted. Replacers that remember
+   * anything about a frame besides whether it can be victimized must forget it here.
+   * @param frame_id the id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) { Pin(frame_id); }
+
+  /**
+   * Lists the frames that are going to be victimized next, without removing them from the replacer.
+   * @param num_frames the maximum number of frames to list
+   * @return up to num_frames frames, the next victim first
+   */
+  virtual std::vector<frame_id_t> PeekVictims(size_t num_frames) = 0;
+
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
 };
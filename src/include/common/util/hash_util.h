@@ -13,11 +13,14 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 
 #include "common/macros.h"
+#include "murmur3/MurmurHash3.h"
 #include "type/value.h"
 
 namespace bustub {
@@ -29,32 +32,44 @@ class HashUtil {
   static const hash_t prime_factor = 10000019;
 
  public:
+  /** @return the hash of a word: the murmur3 finalizer, which mixes each bit of the word into all bits of the hash */
+  static inline hash_t HashWord(uint64_t word) {
+    word ^= word >> 33;
+    word *= 0xff51afd7ed558ccdULL;
+    word ^= word >> 33;
+    word *= 0xc4ceb9fe1a85ec53ULL;
+    word ^= word >> 33;
+    return word;
+  }
+
+  /** @return the hash of length bytes: murmur3, which hashes 16 bytes per round */
   static inline hash_t HashBytes(const char *bytes, size_t length) {
-    // https://github.com/greenplum-db/gpos/blob/b53c1acd6285de94044ff91fbee91589543feba1/libgpos/src/utils.cpp#L126
-    hash_t hash = length;
-    for (size_t i = 0; i < length; ++i) {
-      hash = ((hash << 5) ^ (hash >> 27)) ^ bytes[i];
-    }
-    return hash;
+    uint64_t hash[2];
+    murmur3::MurmurHash3_x64_128(bytes, static_cast<int>(length), 0, hash);
+    return hash[0];
   }
 
   static inline hash_t CombineHashes(hash_t l, hash_t r) {
-    hash_t both[2];
-    both[0] = l;
-    both[1] = r;
-    return HashBytes(reinterpret_cast<char *>(both), sizeof(hash_t) * 2);
+    return HashWord(l ^ (r + 0x9e3779b97f4a7c15ULL + (l << 6) + (l >> 2)));
   }
 
   static inline hash_t SumHashes(hash_t l, hash_t r) { return (l % prime_factor + r % prime_factor) % prime_factor; }
 
+  /** @return the hash of the bytes of *ptr, which are hashed as a single word if they fit into one */
   template <typename T>
   static inline hash_t Hash(const T *ptr) {
-    return HashBytes(reinterpret_cast<const char *>(ptr), sizeof(T));
+    if constexpr (sizeof(T) <= sizeof(uint64_t)) {
+      uint64_t word = 0;
+      memcpy(&word, ptr, sizeof(T));
+      return HashWord(word);
+    } else {
+      return HashBytes(reinterpret_cast<const char *>(ptr), sizeof(T));
+    }
   }
 
   template <typename T>
   static inline hash_t HashPtr(const T *ptr) {
-    return HashBytes(reinterpret_cast<const char *>(&ptr), sizeof(void *));
+    return HashWord(reinterpret_cast<uintptr_t>(ptr));
   }
 
   /** @return the hash of the value */
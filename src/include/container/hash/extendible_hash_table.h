@@ -0,0 +1,147 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table.h
+//
+// Identification: src/include/container/hash/extendible_hash_table.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rwlatch.h"
+#include "concurrency/transaction.h"
+#include "container/hash/hash_function.h"
+#include "container/hash/hash_table.h"
+#include "storage/index/generic_key.h"
+#include "storage/page/hash_table_bucket_page.h"
+#include "storage/page/hash_table_directory_page.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+#define EXTENDIBLE_HASH_TABLE_TYPE ExtendibleHashTable<KeyType, ValueType, KeyComparator>
+
+/**
+ * Implementation of extendible hashing that is backed by a buffer pool manager. Non-unique keys are supported.
+ * Supports insert and delete. The table grows by splitting the bucket that is full, and doubles the directory if that
+ * bucket has the global depth already, so an insert moves at most one bucket of pairs. Buckets that become empty are
+ * not merged, and the directory does not shrink.
+ *
+ * A split cannot separate pairs whose hashes agree in the MAX_DEPTH bits of the directory, such as the pairs of a key
+ * with many values. A full bucket only splits if that moves at least half a page of pairs away from its largest
+ * group of such pairs, and its local depth is below MAX_DEPTH; otherwise it links another overflow page. The overflow
+ * pages belong to their bucket: they are only read under the latch of the bucket page, and only modified under its
+ * write latch, so they are pinned, but not latched themselves.
+ *
+ * The directory only changes when a bucket splits, which takes the table latch in write mode. Lookups, inserts and
+ * removes take it in read mode, along with the latch of their bucket page, so they only wait for each other if they
+ * meet in a bucket.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class ExtendibleHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
+ public:
+  /**
+   * Creates a new ExtendibleHashTable with a single bucket
+   *
+   * @param buffer_pool_manager buffer pool manager to be used
+   * @param comparator comparator for keys
+   * @param hash_fn the hash function
+   */
+  explicit ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                               const KeyComparator &comparator, HashFunction<KeyType> hash_fn);
+
+  /**
+   * Inserts a key-value pair into the hash table.
+   * @param transaction the current transaction
+   * @param key the key to create
+   * @param value the value to be associated with the key
+   * @return true if insert succeeded, false if the table holds the pair already
+   */
+  bool Insert(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Deletes the associated value for the given key.
+   * @param transaction the current transaction
+   * @param key the key to delete
+   * @param value the value to delete
+   * @return true if remove succeeded, false otherwise
+   */
+  bool Remove(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Performs a point query on the hash table.
+   * @param transaction the current transaction
+   * @param key the key to look up
+   * @param[out] result the value(s) associated with a given key
+   * @return the value(s) associated with the given key
+   */
+  bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
+
+  /**
+   * @return the global depth of the directory
+   */
+  uint32_t GetGlobalDepth();
+
+ private:
+  /** The outcome of ChainInsert */
+  enum class ChainInsertResult { INSERTED, DUPLICATE, NEEDS_SPLIT };
+
+  /**
+   * Inserts a pair into the first page of a bucket that has room, unless the bucket holds the pair already. If all
+   * pages are full, and the bucket should not split, links a new overflow page for the pair.
+   * @param guard the guard of the bucket page, which holds its write latch, or the table latch in write mode
+   * @param local_depth the local depth of the bucket
+   * @return NEEDS_SPLIT if the bucket is full and should be split first
+   */
+  template <class Guard>
+  ChainInsertResult ChainInsert(Guard *guard, uint32_t local_depth, const KeyType &key, const ValueType &value,
+                                uint64_t hash);
+
+  /**
+   * @return whether splitting a full bucket, which is to hold the pair of hash as well, would move at least half a
+   * page of pairs away from its largest group of pairs that no split can separate
+   */
+  bool ShouldSplit(const HASH_TABLE_BUCKET_TYPE *bucket, uint64_t hash);
+
+  /**
+   * Inserts a pair whose bucket was full: splits the bucket, and doubles the directory if necessary, until the bucket
+   * of the pair has room or should not split. Needs the table latch in write mode.
+   * @return false if the table holds the pair already
+   */
+  bool SplitInsert(const KeyType &key, const ValueType &value, uint64_t hash);
+
+  /**
+   * Moves the pairs of a full bucket whose hash has bit local_depth set to the empty split image, reusing the
+   * overflow pages of the bucket for either side, and deleting those that are left over.
+   */
+  void SplitBucket(HASH_TABLE_BUCKET_TYPE *bucket, HASH_TABLE_BUCKET_TYPE *image, uint32_t local_depth);
+
+  /**
+   * Makes bucket hold pairs, linking pages of free_page_ids as overflow pages as needed.
+   * @param pairs the (hash, (key, value)) pairs
+   */
+  void FillBucket(HASH_TABLE_BUCKET_TYPE *bucket, const std::vector<std::pair<uint64_t, MappingType>> &pairs,
+                  std::vector<page_id_t> *free_page_ids);
+
+  // member variable
+  page_id_t directory_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+
+  // Readers include lookups, inserts and removes, the writer is a split
+  ReaderWriterLatch table_latch_;
+
+  // Hash function
+  HashFunction<KeyType> hash_fn_;
+};
+
+}  // namespace bustub
@@ -14,7 +14,7 @@
 
 #include <cstdint>
 
-#include "murmur3/MurmurHash3.h"
+#include "common/util/hash_util.h"
 
 namespace bustub {
 
@@ -23,14 +23,10 @@ class HashFunction {
  public:
   /**
    * @param key the key to be hashed
-   * @return the hashed value
+   * @return the hashed value: keys of up to 8 bytes, such as integers, are mixed as a single word, and longer keys are
+   * hashed with murmur3, see HashUtil::Hash
    */
-  virtual uint64_t GetHash(KeyType key) {
-    uint64_t hash[2];
-    murmur3::MurmurHash3_x64_128(reinterpret_cast<const void *>(&key), static_cast<int>(sizeof(KeyType)), 0,
-                                 reinterpret_cast<void *>(&hash));
-    return hash[0];
-  }
+  virtual uint64_t GetHash(KeyType key) { return HashUtil::Hash(&key); }
 };
 
 }  // namespace bustub
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <mutex>  // NOLINT
 #include <queue>
 #include <string>
 #include <vector>
@@ -32,6 +34,27 @@ namespace bustub {
  * Implementation of linear probing hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table dynamically grows once full.
+ *
+ * The buckets are the slots of the block pages, in the order of the header page. A key starts probing at the bucket of
+ * its hash and goes on to the next buckets, wrapping around the table, until it reaches a bucket that was never
+ * occupied. Each probe step compares the tags of a group of slots with the tag of the key, see
+ * HashTableBlockPage::MatchTag, so keys are only compared where the top bits of their hashes match. A removed pair
+ * leaves a tombstone, which keeps the probe sequences through its bucket intact; an insert takes the first tombstone of
+ * its probe sequence, or else the bucket where the sequence ends. Before the occupied buckets, including tombstones,
+ * exceed MAX_LOAD_FACTOR of all buckets, the table is rebuilt, which keeps probes to a group or two: at twice its size,
+ * or at its size if most of the occupied buckets are tombstones.
+ *
+ * A resize does not rehash the whole table at once. It allocates the header page of the new table and leaves the pairs
+ * in the old one; each insert and remove then moves MIGRATE_GROUPS groups of old buckets into the new table, until the
+ * old table is empty and its pages are freed. Until then, lookups probe both tables, so that no operation waits for
+ * more than a few groups to move.
+ *
+ * Latching: inserts, removes and lookups hold the table latch in read mode, and latch the block pages of their probe
+ * sequence one at a time, in read mode for lookups and in write mode for writes. Only starting and finishing a resize
+ * take the table latch in write mode. Two inserts of the same pair would both miss it if they probed different blocks,
+ * so the inserts of a key are serialized by one of NUM_KEY_LATCHES latches, chosen by its hash. A migration step moves
+ * the pairs of an old block under its write latch, into the new table before tombstoning them in the old one, so a
+ * pair is always found by probing the old table before the new one; the block latches are taken in that order, too.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
@@ -52,7 +75,8 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
    * @param transaction the current transaction
    * @param key the key to create
    * @param value the value to be associated with the key
-   * @return true if insert succeeded, false otherwise
+   * @return true if insert succeeded, false if the table holds the pair already, or cannot make room for it: it has
+   * as many blocks as its header page holds, or the buffer pool has no frame for its pages
    */
   bool Insert(Transaction *transaction, const KeyType &key, const ValueType &value) override;
 
@@ -75,25 +99,137 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
   bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
 
   /**
-   * Resizes the table to at least twice the initial size provided.
+   * Resizes the table to at least twice the initial size provided. The pairs move to the new buckets over the following
+   * inserts and removes; a resize that is still in progress is finished first.
    * @param initial_size the initial size of the hash table
    */
   void Resize(size_t initial_size);
 
+  /**
+   * @return whether a resize is in progress, i.e. the old table still holds pairs
+   */
+  bool IsResizing();
+
   /**
    * Gets the size of the hash table
    * @return current size of the hash table
    */
   size_t GetSize();
 
+  /** The share of buckets that may be occupied before an insert grows the table. */
+  static constexpr double MAX_LOAD_FACTOR = 0.875;
+
+  /**
+   * The number of groups of old buckets that each insert and remove moves to the new table during a resize. The new
+   * table has twice the buckets, so the old one is empty long before the new one fills up.
+   */
+  static constexpr size_t MIGRATE_GROUPS = 2;
+
+  /** The number of latches that serialize the inserts of keys with the same hash. */
+  static constexpr size_t NUM_KEY_LATCHES = 64;
+
  private:
+  /**
+   * Allocates the header page of a new table. Its blocks are allocated by the first insert into them, see
+   * AllocateBlock.
+   * @param num_buckets the least number of buckets of the table
+   * @return the page id of the header page
+   */
+  page_id_t CreateTable(size_t num_buckets);
+
+  /**
+   * Walks the probe sequence of a key, from the bucket of its hash up to the first bucket that was never occupied, and
+   * calls on_match(&guard, slot) for the readable slots whose tag matches the tag of the key. The block pages are
+   * latched one at a time by a Guard, which is a ReadPageGuard or a WritePageGuard.
+   * @param header the header page of the table
+   * @param key the key to probe for
+   * @param hash the hash of the key
+   * @param on_match returns false to stop the probe
+   * @param[out] empty_bucket the first bucket that was never occupied, or the number of buckets if there is none
+   * @param[out] empty_guard if not nullptr, takes the guard of the block of empty_bucket, which is allocated if it was
+   * not yet, so that the bucket stays empty until the caller writes it
+   * @param[out] tombstone_bucket if not nullptr, the first bucket of the probe sequence whose pair was removed, or the
+   * number of buckets if there is none
+   * @return false if on_match stopped the probe
+   */
+  template <class Guard, class MatchFunction>
+  bool Probe(HashTableHeaderPage *header, const KeyType &key, uint64_t hash, MatchFunction &&on_match,
+             size_t *empty_bucket, Guard *empty_guard = nullptr, size_t *tombstone_bucket = nullptr);
+
+  /** @return the guard of a block page, which is latched in read mode for a ReadPageGuard and write mode otherwise */
+  template <class Guard>
+  Guard FetchBlock(page_id_t block_page_id);
+
+  /** @return whether the table holds the pair */
+  bool HasPair(HashTableHeaderPage *header, const KeyType &key, uint64_t hash, const ValueType &value);
+
+  /** @return whether the table held the pair, which is removed then */
+  bool RemovePair(HashTableHeaderPage *header, const KeyType &key, uint64_t hash, const ValueType &value);
+
+  /**
+   * Allocates the page of a block that was never written to. Concurrent inserts may both allocate it; the first one to
+   * set the page id in the header page wins, and the other page is deleted again. Throws std::bad_alloc if the buffer
+   * pool has no frame for the page.
+   */
+  void AllocateBlock(HashTableHeaderPage *header, size_t block_index);
+
+  /**
+   * Starts a resize into a new table of at least num_buckets buckets: the current table becomes the old one. Needs the
+   * table latch in write mode, and no resize in progress. Leaves the table as it was if it throws: OUT_OF_RANGE if the
+   * table would outgrow its header page, or std::bad_alloc if the buffer pool has no frame for the new one.
+   */
+  void StartResize(size_t num_buckets);
+
+  /**
+   * Moves up to num_groups groups of old buckets into the new table. Needs the table latch, in read mode if the caller
+   * holds migrate_latch_, which serializes the moves, and in write mode otherwise.
+   * @return whether all pairs of the old table have been moved, so that it can be freed
+   */
+  bool Migrate(size_t num_groups);
+
+  /**
+   * Moves MIGRATE_GROUPS unless another write is moving pairs already, see Migrate, or the buffer pool has no frame
+   * for a block of the new table. Needs the table latch.
+   */
+  bool TryMigrate();
+
+  /** Moves the remaining pairs of the old table, and frees its pages. Needs the table latch in write mode. */
+  void FreeOldTable();
+
+  /**
+   * Frees the old table of a resize that has moved all of its pairs, unless a concurrent write has done so already.
+   * Takes the table latch in write mode.
+   * @param old_header_page_id the header page of the old table
+   */
+  void FinishResize(page_id_t old_header_page_id);
+
+  /**
+   * Makes room for another pair, unless a concurrent write has done so already: finishes the resize in progress, or
+   * starts one. Takes the table latch in write mode.
+   * @param header_page_id the header page of the table that is full
+   * @return false if the table cannot grow, see StartResize
+   */
+  bool Grow(page_id_t header_page_id);
+
   // member variable
   page_id_t header_page_id_;
+  // The header page of the old table during a resize, INVALID_PAGE_ID otherwise
+  page_id_t old_header_page_id_{INVALID_PAGE_ID};
+  // The first bucket of the old table whose pairs have not been moved to the new one, guarded by migrate_latch_
+  size_t migrate_bucket_{0};
+  std::mutex migrate_latch_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
+  // The number of occupied buckets of the new table, including those of removed pairs, which only a resize frees
+  std::atomic<size_t> num_occupied_{0};
+  // The number of pairs in both tables
+  std::atomic<size_t> num_pairs_{0};
+
   // Readers includes inserts and removes, writer is only resize
   ReaderWriterLatch table_latch_;
+  // Serialize the inserts of a key, see NUM_KEY_LATCHES
+  std::mutex key_latches_[NUM_KEY_LATCHES];
 
   // Hash function
   HashFunction<KeyType> hash_fn_;
@@ -91,6 +91,9 @@ class DiskManager {
   /** @return the number of disk writes */
   int GetNumWrites() const;
 
+  /** @return the number of pages the database file currently spans */
+  int GetNumPages();
+
   /**
    * Sets the future which is used to check for non-blocking flushes.
    * @param f the non-blocking flush check
@@ -105,12 +108,13 @@ class DiskManager {
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
-  // stream to write db file
-  std::fstream db_io_;
+  // descriptor of the db file; pages are transferred with pread/pwrite, so that concurrent reads and writes of
+  // different pages do not serialize on a shared file cursor
+  int db_fd_{-1};
   std::string file_name_;
   std::atomic<page_id_t> next_page_id_;
   int num_flushes_;
-  int num_writes_;
+  std::atomic<int> num_writes_;
   bool flush_log_;
   std::future<void> *flush_log_f_;
 };
@@ -10,11 +10,18 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <atomic>
+#include <deque>
 #include <queue>
 #include <string>
+#include <thread>  // NOLINT
+#include <utility>
 #include <vector>
 
+#include "buffer/page_guard.h"
+#include "common/rwlatch.h"
 #include "concurrency/transaction.h"
+#include "storage/index/external_sorter.h"
 #include "storage/index/index_iterator.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
@@ -29,10 +36,17 @@ enum class Operation {SEARCH = 0, INSERT, DELETE};
  *
  * Implementation of simple b+ tree data structure where internal pages direct
  * the search and leaf pages contain actual data.
- * (1) We only support unique key
+ * (1) Keys are unique, unless the tree is non-unique: then a key keeps all of
+ * its values, the second and following ones in a posting list, see PostingList
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ *
+ * In B-link mode, every page links to its right sibling and knows its high
+ * key, so that operations latch a single page at a time on their way down,
+ * and a split latches at most a page and its parent. This keeps concurrent
+ * inserts into the same part of the tree, such as increasing keys, from
+ * waiting for each other's splits. Pages are never merged in this mode.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
@@ -41,7 +55,8 @@ class BPlusTree {
 
  public:
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE,
+                     bool b_link = false, bool unique_keys = true);
 
   // Returns true if this B+ tree has no keys and values.
   bool IsEmpty() const;
@@ -49,17 +64,82 @@ class BPlusTree {
   // Insert a key-value pair into this B+ tree.
   bool Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
 
-  // Remove a key and its value from this B+ tree.
+  // Insert several key-value pairs, sorting them by key first. Returns the number of pairs inserted.
+  int InsertBatch(std::vector<std::pair<KeyType, ValueType>> *entries, Transaction *transaction = nullptr);
+
+  // Remove a key and its value from this B+ tree, or all of its values if the tree is non-unique.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
+  // Remove a key & value pair from this B+ tree.
+  void Remove(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  /**
+   * Builds the tree bottom-up from the entries in [first, last), which is much faster than inserting them one by one:
+   * the entries are sorted with an ExternalSorter, packed into leaves, and the internal levels are built on top of the
+   * leaves. Of several entries with the same key, a unique tree only loads the first one.
+   * @param first the first entry, a pair of key and value; the entries may come in any order
+   * @param last the end of the entries
+   * @param fill_factor the fraction of each page to fill; pages are never filled below their minimum size
+   * @return false, without loading anything, if the tree is not empty
+   */
+  template <class InputIterator>
+  bool BulkLoad(InputIterator first, InputIterator last, double fill_factor = 1.0, Transaction *transaction = nullptr) {
+    if (!IsEmpty()) {
+      return false;
+    }
+    ExternalSorter<KeyType, ValueType, KeyComparator> sorter(comparator_, EXTERNAL_SORT_RUN_SIZE, unique_keys_);
+    for (; first != last; ++first) {
+      sorter.Add(first->first, first->second);
+    }
+    sorter.Finish();
+    return BulkLoad(&sorter, fill_factor, transaction);
+  }
+
+  // Build the tree bottom-up from the entries of a finished sorter, see above.
+  bool BulkLoad(ExternalSorter<KeyType, ValueType, KeyComparator> *sorter, double fill_factor = 1.0,
+                Transaction *transaction = nullptr);
+
   // return the value associated with a given key
   bool GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr);
 
+  // return the values associated with several keys: (*results)[i] gets the values of keys[i]
+  void GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                 Transaction *transaction = nullptr);
+
   // index iterator
   INDEXITERATOR_TYPE begin();
   INDEXITERATOR_TYPE Begin(const KeyType &key);
+  INDEXITERATOR_TYPE Begin(const KeyType &key, const KeyType &end_key);
   INDEXITERATOR_TYPE end();
 
+  // reverse index iterator, which ends at end() as well
+  INDEXITERATOR_TYPE RBegin();
+  INDEXITERATOR_TYPE RBegin(const KeyType &key);
+  INDEXITERATOR_TYPE RBegin(const KeyType &key, const KeyType &end_key);
+
+  // Split [key, end_key) into at most parts ranges of about the same size, and return the keys that separate them.
+  std::vector<KeyType> SplitRange(const KeyType &key, const KeyType &end_key, int parts);
+
+  /**
+   * Scans the keys in [key, end_key) with up to parts threads, each of which iterates over one of the ranges of
+   * SplitRange. Each thread creates its own iterator, since an iterator holds the latch on its leaf.
+   * @param scan called as scan(part, iterator) in the thread of each range, in which it may drive the iterator up to
+   * end(); part counts the ranges from 0 in key order
+   */
+  template <class ScanFunction>
+  void ParallelScan(const KeyType &key, const KeyType &end_key, int parts, ScanFunction scan) {
+    std::vector<KeyType> bounds = SplitRange(key, end_key, parts);
+    bounds.insert(bounds.begin(), key);
+    bounds.push_back(end_key);
+    std::vector<std::thread> threads;
+    for (size_t part = 0; part + 1 < bounds.size(); part++) {
+      threads.emplace_back([this, &bounds, &scan, part] { scan(part, Begin(bounds[part], bounds[part + 1])); });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+
   void Print(BufferPoolManager *bpm) {
     std::cout << ToString(reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(root_page_id_)->GetData()), bpm);
   }
@@ -79,36 +159,120 @@ class BPlusTree {
   void RemoveFromFile(const std::string &file_name, Transaction *transaction = nullptr);
 
  private:
-  void LockPage(Page* page, Transaction* transaction, Operation op);
-  void UnlockPage(Page* page, Transaction* transaction, Operation op);
-  void UnlockParentPage(Page* page, Transaction* transaction, Operation op);
-  void UnlockAllPage(Transaction* transaction, Operation op);
+  /** Number of optimistic descents an operation tries before it falls back to latch coupling. */
+  static constexpr int OPTIMISTIC_DESCENT_ATTEMPTS = 3;
+
+  /**
+   * The pages an insert or remove holds latched on its way down. Each page is only released once a page below it is
+   * safe, i.e. cannot split or underflow, so the pages in write_set_ are exactly the ones the operation may still have
+   * to modify. root_latch_ is held the same way, for as long as the root may change.
+   */
+  struct Context {
+    Context() = default;
+    ~Context() {
+      if (root_latch_ != nullptr) {
+        root_latch_->WUnlock();
+      }
+    }
+    DISALLOW_COPY(Context);
+
+    /** Acquires the root latch. */
+    void LockRoot(ReaderWriterLatch *root_latch) {
+      root_latch_ = root_latch;
+      root_latch_->WLock();
+    }
+
+    /** Releases root_latch_ and every page in write_set_ but the last one. */
+    void ReleaseAncestors() {
+      if (root_latch_ != nullptr) {
+        root_latch_->WUnlock();
+        root_latch_ = nullptr;
+      }
+      while (write_set_.size() > 1) {
+        write_set_.pop_front();
+      }
+    }
+
+    /** Releases root_latch_ and every page in write_set_. */
+    void ReleaseAll() {
+      ReleaseAncestors();
+      write_set_.clear();
+    }
+
+    /** The root latch while it is held, nullptr otherwise. */
+    ReaderWriterLatch *root_latch_{nullptr};
+    /** Guards of the latched pages, from the highest one down to the current one. */
+    std::deque<WritePageGuard> write_set_;
+  };
+
+  ReadPageGuard FindLeafPage(const KeyType &key, bool leftMost = false);
+
+  ReadPageGuard FindRightmostLeafPage();
+
+  INDEXITERATOR_TYPE ReverseBegin(const KeyType *key, const KeyType *end_key);
 
-  Page *FindLeafPage(const KeyType &key, bool leftMost = false, 
-                    Transaction *transaction = nullptr,
-                    Operation op = Operation::SEARCH);
+  bool FindLeafPageForWrite(const KeyType &key, Operation op, Context *ctx);
 
-  void StartNewTree(const KeyType &key, const ValueType &value, Transaction* transaction);
+  bool OptimisticDescent(const KeyType &key, bool leftMost, page_id_t *leaf_page_id, Page **parent,
+                         uint64_t *parent_version);
 
-  bool InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+  bool ValidateDescent(page_id_t leaf_page_id, Page *parent, uint64_t parent_version) const;
 
-  void InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
-                        Transaction *transaction = nullptr);
+  bool IsSafe(const BPlusTreePage *node, Operation op, const KeyType &key) const;
 
-  BPlusTreePage *Split(BPlusTreePage *node);
+  page_id_t BLinkDescend(const KeyType &key, int level, bool leftMost, std::vector<page_id_t> *path);
 
-  void CoalesceOrRedistribute(BPlusTreePage *node, Transaction *transaction = nullptr);
+  template <class Guard>
+  void MoveRight(Guard *guard, const KeyType &key);
 
-  void Coalesce(BPlusTreePage *sibling, BPlusTreePage *node, InternalPage *parent, int index, Transaction *transaction);
+  ReadPageGuard BLinkFindLeafPage(const KeyType &key, bool leftMost);
+
+  bool BLinkInsert(const KeyType &key, const ValueType &value);
+
+  void BLinkInsertIntoParent(WritePageGuard *child_guard, KeyType key, page_id_t new_page_id, int level,
+                             std::vector<page_id_t> *path);
+
+  void BLinkRemove(const KeyType &key, const ValueType *value);
+
+  void StartNewTree(const KeyType &key, const ValueType &value);
+
+  bool InsertIntoLeaf(const KeyType &key, const ValueType &value, Context *ctx);
+
+  bool InsertDuplicate(LeafPage *leaf, const KeyType &key, const ValueType &existing_value, const ValueType &value);
+
+  void InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node, Context *ctx);
+
+  BasicPageGuard Split(BPlusTreePage *node, KeyType *separator);
+
+  KeyType ShortSeparator(const KeyType &left, const KeyType &right) const;
+
+  void LinkPrev(page_id_t page_id, page_id_t prev_page_id);
+
+  void RemoveEntry(const KeyType &key, const ValueType *value);
+
+  bool RemoveFromLeaf(LeafPage *leaf, const KeyType &key, ValueType existing_value, const ValueType *value);
+
+  void CoalesceOrRedistribute(BPlusTreePage *node, Context *ctx);
+
+  bool IsUnderfull(const BPlusTreePage *node) const;
+
+  bool CanCoalesce(const BPlusTreePage *neighbor_node, const BPlusTreePage *node, const InternalPage *parent,
+                   int index) const;
+
+  void Coalesce(BPlusTreePage *neighbor_node, BPlusTreePage *node, InternalPage *parent, int index);
 
   void Redistribute(BPlusTreePage *sibling, BPlusTreePage *node, InternalPage *parent, int index);
 
-  void AdjustRoot(BPlusTreePage *node);
+  void AdjustRoot(BPlusTreePage *old_root_node, Context *ctx);
 
   void UpdateRootPageId(bool insert_record = false);
 
-  inline void LockRoot(){root_mutex_.lock();}
-  inline void UnlockRoot(){root_mutex_.unlock();}
+  int BulkLoadPageSize(double fill_factor, int min_size, int max_size) const;
+
+  void BulkLoadLeaves(ExternalSorter<KeyType, ValueType, KeyComparator> *sorter, double fill_factor,
+                      std::vector<std::pair<KeyType, page_id_t>> *level);
+
+  void BulkLoadInternalLevel(double fill_factor, std::vector<std::pair<KeyType, page_id_t>> *level);
 
   /* Debug Routines for FREE!! */
   void ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstream &out) const;
@@ -117,12 +281,18 @@ class BPlusTree {
 
   // member variable
   std::string index_name_;
-  page_id_t root_page_id_;
+  // read without root_latch_ by optimistic descents
+  std::atomic<page_id_t> root_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
-  std::mutex root_mutex_; 
+  // serializes the changes of root_page_id_
+  ReaderWriterLatch root_latch_;
+  // the number of levels, guarded by root_latch_
+  int height_{0};
   int leaf_max_size_;
   int internal_max_size_;
+  bool b_link_;
+  bool unique_keys_;
 };
 
 }  // namespace bustub
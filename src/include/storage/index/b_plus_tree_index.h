@@ -12,7 +12,9 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "storage/index/b_plus_tree.h"
@@ -22,6 +24,13 @@ namespace bustub {
 
 #define BPLUSTREE_INDEX_TYPE BPlusTreeIndex<KeyType, ValueType, KeyComparator>
 
+/**
+ * B+ tree index over fixed-size keys of type KeyType. Each key tuple is copied into a KeyType, so the index only holds
+ * keys whose serialized tuple (inlined columns plus VARCHAR lengths and data) is at most sizeof(KeyType) bytes: longer
+ * keys make InsertEntry and InsertEntries throw an OUT_OF_RANGE Exception (InsertEntries then inserts none of the
+ * entries), and DeleteEntry, ScanKey and ScanKeys treat them as absent. Keys are never truncated, since a prefix may be
+ * shared by other keys.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeIndex : public Index {
  public:
@@ -33,17 +42,47 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  void InsertEntries(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) override;
+
+  void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                Transaction *transaction) override;
+
   INDEXITERATOR_TYPE GetBeginIterator();
 
   INDEXITERATOR_TYPE GetBeginIterator(const KeyType &key);
 
+  INDEXITERATOR_TYPE GetBeginIterator(const KeyType &key, const KeyType &end_key);
+
+  INDEXITERATOR_TYPE GetReverseBeginIterator();
+
+  INDEXITERATOR_TYPE GetReverseBeginIterator(const KeyType &key);
+
+  INDEXITERATOR_TYPE GetReverseBeginIterator(const KeyType &key, const KeyType &end_key);
+
   INDEXITERATOR_TYPE GetEndIterator();
 
+  // the keys that split [key, end_key) into at most parts ranges for a parallel scan, see BPlusTree::SplitRange
+  std::vector<KeyType> SplitRange(const KeyType &key, const KeyType &end_key, int parts);
+
  protected:
+  // builds the index key of a key tuple; @return false if the key tuple is longer than KeyType
+  bool MakeKey(const Tuple &key, KeyType *index_key) const;
+
   // comparator for key
   KeyComparator comparator_;
   // container
   BPlusTree<KeyType, ValueType, KeyComparator> container_;
 };
 
+/**
+ * Creates a B+ tree index with a key type that suits the key schema of metadata: keys with VARCHAR columns, which vary
+ * in length, get GenericKey<256> and are stored in slotted pages, see SlottedEntries; other keys get the smallest
+ * GenericKey they fit into.
+ *
+ * VARCHAR keys are thus capped at 256 bytes of serialized key tuple whatever the declared column lengths. Each VARCHAR
+ * column takes its string plus 17 bytes (inlined slot, length and terminating NUL), so a key of a single VARCHAR column
+ * holds at most 239 characters. Inserting a longer key throws an OUT_OF_RANGE Exception, see BPlusTreeIndex.
+ */
+std::unique_ptr<Index> CreateBPlusTreeIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager);
+
 }  // namespace bustub
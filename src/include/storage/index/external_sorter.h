@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// external_sorter.h
+//
+// Identification: src/include/storage/index/external_sorter.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define EXTERNAL_SORTER_TYPE ExternalSorter<KeyType, ValueType, KeyComparator>
+
+/**
+ * ExternalSorter sorts index entries by key, no matter whether they fit in memory: entries are collected into runs of
+ * at most run_size entries, every full run is sorted and written to a temporary file, and the runs are merged when the
+ * entries are read back. Entries are read back without duplicate keys; of several entries with the same key, the one
+ * that was added first is kept. A sorter for a non-unique index keeps all of them, in the order they were added.
+ *
+ * Usage: Add every entry, call Finish, then call Next until it returns false.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class ExternalSorter {
+ public:
+  /**
+   * @param comparator the key comparator
+   * @param run_size the number of entries that are sorted in memory at a time
+   * @param unique_keys whether to drop all but the first entry of a key
+   */
+  explicit ExternalSorter(const KeyComparator &comparator, size_t run_size = EXTERNAL_SORT_RUN_SIZE,
+                          bool unique_keys = true);
+
+  /** Closes, and thereby deletes, the temporary files. */
+  ~ExternalSorter();
+
+  DISALLOW_COPY_AND_MOVE(ExternalSorter);
+
+  /** Adds an entry. Must not be called after Finish. */
+  void Add(const KeyType &key, const ValueType &value);
+
+  /** Ends the input and prepares the merge of the runs. */
+  void Finish();
+
+  /**
+   * Reads the next entry in key order. Must only be called after Finish.
+   * @param[out] entry the entry
+   * @return false if all entries have been read
+   */
+  bool Next(MappingType *entry);
+
+  /** @return the number of runs that were written to temporary files */
+  size_t SpilledRuns() const { return spilled_runs_; }
+
+ private:
+  /** A sorted run that is being merged. */
+  struct Run {
+    /** The temporary file of the run, or nullptr for the last run, which stays in buffer_. */
+    std::FILE *file_;
+    /** The smallest entry of the run that has not been read yet. */
+    MappingType head_;
+  };
+
+  /** Sorts buffer_ by key and, if keys are unique, drops all but the first of equal keys. Does not sort a buffer that is sorted already. */
+  void SortBuffer();
+
+  /** Sorts buffer_, writes it to a temporary file and clears it. */
+  void SpillRun();
+
+  /** Reads the next entry of a run into its head. @return false if the run is exhausted */
+  bool Advance(Run *run);
+
+  /** @return true if run a has a greater head than run b, or the same head but was added later */
+  bool HeapGreater(size_t a, size_t b) const;
+
+  KeyComparator comparator_;
+  size_t run_size_;
+  bool unique_keys_;
+  /** The entries of the run that is being collected; after Finish, the last run. */
+  std::vector<MappingType> buffer_;
+  /** Position of the next entry of buffer_ to read. */
+  size_t buffer_pos_{0};
+  /** The runs in the order they were collected. */
+  std::vector<Run> runs_;
+  /** Indexes into runs_ of the runs that are not exhausted, as a min-heap on their heads. */
+  std::vector<size_t> heap_;
+  /** The number of runs written to temporary files. */
+  size_t spilled_runs_{0};
+  /** True once Next returned an entry, whose key is then last_key_. */
+  bool has_last_{false};
+  KeyType last_key_;
+};
+
+}  // namespace bustub
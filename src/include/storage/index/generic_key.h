@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstring>
 
 #include "storage/table/tuple.h"
@@ -32,7 +33,8 @@ class GenericKey {
   inline void SetFromKey(const Tuple &tuple) {
     // intialize to 0
     memset(data_, 0, KeySize);
-    memcpy(data_, tuple.GetData(), tuple.GetLength());
+    // a longer tuple would not read back as valid values anyway; BPlusTreeIndex rejects such keys beforehand
+    memcpy(data_, tuple.GetData(), std::min<size_t>(tuple.GetLength(), KeySize));
   }
 
   // NOTE: for test purpose only
@@ -94,13 +96,50 @@ class GenericComparator {
     return 0;
   }
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
+  GenericComparator(const GenericComparator &other)
+      : key_schema_{other.key_schema_},
+        int64_key_{other.int64_key_},
+        truncation_offset_{other.truncation_offset_} {}
 
   // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+  explicit GenericComparator(Schema *key_schema)
+      : key_schema_(key_schema),
+        int64_key_(key_schema != nullptr && key_schema->GetColumnCount() == 1 &&
+                   key_schema->GetColumn(0).GetType() == TypeId::BIGINT && key_schema->GetColumn(0).GetOffset() == 0),
+        truncation_offset_(KeySize) {
+    if (key_schema == nullptr) {
+      return;
+    }
+    // the data of a single uninlined column follows the inlined ones, after its length; with several, where their
+    // lengths are depends on the key
+    uint32_t uninlined_count = 0;
+    for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+      uninlined_count += key_schema->GetColumn(i).IsInlined() ? 0 : 1;
+    }
+    if (uninlined_count == 0) {
+      truncation_offset_ = 0;
+    } else if (uninlined_count == 1) {
+      truncation_offset_ = key_schema->GetLength() + sizeof(uint32_t);
+    }
+  }
+
+  /**
+   * @return true if the key is a single BIGINT column at the start of the key data, i.e. if keys order like the
+   * int64_t in their first 8 bytes. Index pages use this to search such keys with integer compares.
+   */
+  inline bool IsInt64Key() const { return int64_key_; }
+
+  /**
+   * @return the offset from which on the bytes of a key can be zeroed and the key still reads as valid values: past the
+   * offsets and lengths of uninlined columns, or KeySize if there is no such offset. Index pages truncate separator
+   * keys there.
+   */
+  inline uint32_t TruncationOffset() const { return truncation_offset_; }
 
  private:
   Schema *key_schema_;
+  bool int64_key_;
+  uint32_t truncation_offset_;
 };
 
 }  // namespace bustub
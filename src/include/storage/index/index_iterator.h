@@ -13,6 +13,10 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include <functional>
+#include <vector>
+
+#include "buffer/page_guard.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
@@ -22,9 +26,27 @@ namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
  public:
-  // you may define your own constructor based on your member variables
-  IndexIterator(page_id_t page_id, int index, BufferPoolManager* buffer_pool_manager);
-  ~IndexIterator();
+  /** Creates the end iterator. */
+  IndexIterator() = default;
+
+  /**
+   * Creates an iterator positioned at an entry of a leaf, or at the first entry of a following leaf if index is past
+   * the end of the leaf. Backwards, the iterator is positioned at the last entry of a preceding leaf if index is -1.
+   * @param buffer_pool_manager the buffer pool manager of the tree
+   * @param leaf_guard the read guard of the leaf, which the iterator keeps until it moves on
+   * @param index the index of the entry within the leaf
+   * @param postings whether the tree is non-unique, so that the iterator returns every value of a posting list
+   * @param comparator the comparator of the tree, which must outlive the iterator
+   * @param end_key if not nullptr, the iterator ends at the first key that is not smaller (if reverse: greater) than
+   * end_key; it does not read the next leaf if the high key of the current one shows that the next leaf only holds
+   * keys beyond end_key
+   * @param reverse whether the iterator visits the keys in descending order
+   * @param find_leaf returns the read guard of the leaf that holds a key, see BPlusTree::FindLeafPage. The iterator
+   * falls back to it if the neighbor of its leaf, in its direction, has changed since it released its leaf.
+   */
+  IndexIterator(BufferPoolManager *buffer_pool_manager, ReadPageGuard leaf_guard, int index, bool postings,
+                const KeyComparator *comparator, const KeyType *end_key, bool reverse,
+                std::function<ReadPageGuard(const KeyType &)> find_leaf);
 
   bool isEnd();
 
@@ -37,11 +59,43 @@ class IndexIterator {
   bool operator!=(const IndexIterator &itr) const;
 
  private:
-  // add your own private member variables here
-  page_id_t page_id_;
-  int index_;
-  BufferPoolManager *buffer_pool_manager_;
-  B_PLUS_TREE_LEAF_PAGE_TYPE *leaf_node_;
+  /** Moves on to the following leaves while the iterator is past the end of its leaf. */
+  void SkipExhaustedLeaves();
+
+  /** Moves on to the preceding leaves while a reverse iterator is before the start of its leaf. */
+  void SkipExhaustedLeavesBackward();
+
+  /** Ends the iterator if it has reached its end key. */
+  void CheckEndKey();
+
+  /** Releases the leaf and turns the iterator into the end iterator. */
+  void MakeEnd();
+
+  /** Reads the posting list of the current entry, if it has one. */
+  void LoadPostings();
+
+  page_id_t page_id_ = INVALID_PAGE_ID;
+  int index_ = 0;
+  BufferPoolManager *buffer_pool_manager_ = nullptr;
+  ReadPageGuard leaf_guard_;
+  const B_PLUS_TREE_LEAF_PAGE_TYPE *leaf_node_ = nullptr;
+  // leaves below this page id have been read ahead already
+  page_id_t read_ahead_until_ = INVALID_PAGE_ID;
+  // the entry returned by operator*
+  MappingType item_;
+  bool postings_enabled_ = false;
+  // the values of the current entry if it has a posting list, and the position among them
+  std::vector<ValueType> postings_;
+  int posting_index_ = 0;
+  // the direction, and the end key of a bounded iterator, see the constructor
+  bool reverse_ = false;
+  bool bounded_ = false;
+  KeyType end_key_{};
+  const KeyComparator *comparator_ = nullptr;
+  std::function<ReadPageGuard(const KeyType &)> find_leaf_;
+  // a reverse iterator has visited the keys from this one on, and continues with the smaller ones
+  bool has_boundary_ = false;
+  KeyType boundary_{};
 };
 
 }  // namespace bustub
@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// key_search.h
+//
+// Identification: src/include/storage/index/key_search.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+/**
+ * Binary search over sorted keys.
+ * @param size the number of keys
+ * @param key the key to search for
+ * @param comparator the key comparator
+ * @param upper false to count the keys that are smaller than key, true to count the keys that are not greater than key
+ * @param key_at key_at(i) returns the key at index i
+ * @return the index of the first key that is not smaller (if upper: greater) than key, or size if there is none
+ */
+template <class KeyType, class KeyComparator, class KeyAt>
+int KeyBound(int size, const KeyType &key, const KeyComparator &comparator, bool upper, KeyAt key_at) {
+  int lo = 0;
+  int len = size;
+  while (len > 0) {
+    int half = len / 2;
+    int cmp = comparator(key_at(lo + half), key);
+    if (cmp < 0 || (upper && cmp == 0)) {
+      lo += half + 1;
+      len -= half + 1;
+    } else {
+      len = half;
+    }
+  }
+  return lo;
+}
+
+/**
+ * The integer counterpart of KeyBound, for keys that order like the int64_t stored in their first 8 bytes. It narrows
+ * the range down by binary search, and counts the keys of the remaining window with SSE4.2 or AVX2 compares when the
+ * CPU supports them.
+ * @param keys the first key
+ * @param stride the distance between two keys in bytes
+ * @param width the number of bytes stored of each key, at most 8; the missing high-order bytes are zero
+ * @param size the number of keys
+ * @param key the key to search for
+ * @param upper as in KeyBound
+ * @return as in KeyBound
+ */
+int Int64KeyBound(const char *keys, size_t stride, int width, int size, int64_t key, bool upper);
+
+/** @return false: keys compared by comparator are not known to order as integers */
+template <class KeyComparator>
+bool HasInt64Keys(const KeyComparator &comparator) {
+  return false;
+}
+
+/** @return true if comparator orders keys by the BIGINT they start with, so that Int64KeyBound applies */
+template <size_t KeySize>
+bool HasInt64Keys(const GenericComparator<KeySize> &comparator) {
+  return KeySize >= sizeof(int64_t) && comparator.IsInt64Key();
+}
+
+/** @return the offset from which on key bytes may be zeroed; none, unless the comparator is known to allow it */
+template <class KeyComparator>
+int TruncationOffset(const KeyComparator &comparator) {
+  return INT32_MAX;
+}
+
+/** @return the offset from which on the bytes of keys compared by comparator may be zeroed, see GenericComparator */
+template <size_t KeySize>
+int TruncationOffset(const GenericComparator<KeySize> &comparator) {
+  return comparator.TruncationOffset();
+}
+
+}  // namespace bustub
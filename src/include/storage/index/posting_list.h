@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// posting_list.h
+//
+// Identification: src/include/storage/index/posting_list.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+/**
+ * PostingList keeps the record ids of a key that occurs more than once in a non-unique B+ tree. The key is stored once,
+ * in its leaf, and the ids are sorted across a chain of BPlusTreePostingPages. Instead of a record id, the leaf entry
+ * holds a reference to the first page: a RID with the page id of that page and the slot number REFERENCE_SLOT, which
+ * no table page reaches. A posting list always holds at least two ids; the last remaining one goes back into the leaf.
+ *
+ * The pages belong to the leaf entry: they are only read under a latch on the leaf, and only modified under its write
+ * latch, so they are pinned, but not latched themselves.
+ */
+class PostingList {
+ public:
+  /** The slot number that marks a reference to a posting list. */
+  static constexpr uint32_t REFERENCE_SLOT = std::numeric_limits<uint32_t>::max();
+
+  /** @return whether the value of a leaf entry refers to a posting list */
+  static bool IsReference(const RID &value) { return value.GetSlotNum() == REFERENCE_SLOT; }
+
+  /**
+   * Creates a posting list of rids, which are sorted and deduplicated in place.
+   * @return the reference to the new list, or the only id if rids holds a single distinct one
+   */
+  static RID Create(BufferPoolManager *bpm, std::vector<RID> *rids);
+
+  /** Appends the ids of the list to result, in ascending order. */
+  static void Read(BufferPoolManager *bpm, const RID &reference, std::vector<RID> *result);
+
+  /**
+   * Adds rid to the list.
+   * @return false if the list holds rid already
+   */
+  static bool Insert(BufferPoolManager *bpm, const RID &reference, const RID &rid);
+
+  /**
+   * Removes rid from the list.
+   * @param[in,out] value the value of the leaf entry: the reference, which changes if the first page is freed, or the
+   * remaining id once only one is left
+   * @return false if the list does not hold rid
+   */
+  static bool Remove(BufferPoolManager *bpm, RID *value, const RID &rid);
+
+  /** Deletes all pages of the list. */
+  static void Delete(BufferPoolManager *bpm, const RID &reference);
+};
+
+}  // namespace bustub
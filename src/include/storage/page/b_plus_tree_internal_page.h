@@ -13,12 +13,19 @@
 #include <queue>
 
 #include "storage/page/b_plus_tree_page.h"
+#include "storage/page/slotted_entries.h"
 
 namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
-#define INTERNAL_PAGE_HEADER_SIZE 24
-#define INTERNAL_PAGE_SIZE ((PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
+#define INTERNAL_PAGE_HEADER_SIZE 28
+// bytes available to the entries of an internal page, and the number of entries its max size derives from
+#define INTERNAL_PAGE_SPACE \
+  (PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE - sizeof(KeyType) - PageEntries<KeyType, ValueType>::HEADER_SIZE)
+#define INTERNAL_PAGE_SLOTS (PageEntries<KeyType, ValueType>::Slots(INTERNAL_PAGE_SPACE))
+// an internal page holds at most max_size children and splits before it would hold more; a page of
+// 2 * INTERNAL_PAGE_SLOTS - 2 children splits into halves that still have room for any key
+#define INTERNAL_PAGE_SIZE (2 * INTERNAL_PAGE_SLOTS - 2)
 /**
  * Store size_-1 indexed keys and size_ child pointers (page ids) within internal page.
  * Pointer PAGE_ID(i) points to a subtree in which all keys K satisfy:
@@ -27,10 +34,17 @@ namespace bustub {
  * the first key always remains invalid. That is to say, any search/lookup
  * should ignore the first key.
  *
+ * The entries are prefix and suffix compressed, or slotted for long keys, see PageEntries. The first key is kept a real
+ * key of the subtree range, so that it does not spoil the compression. A page is full once it holds max_size children
+ * or the next key does not fit, see HasRoomFor.
+ *
+ * Like a leaf, the page has a high key unless it is the rightmost one on its level: the keys of its subtrees are
+ * smaller, and the keys of the pages to its right are at least as large.
+ *
  * Internal page format (keys are stored in increasing order):
- *  --------------------------------------------------------------------------
- * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
- *  --------------------------------------------------------------------------
+ *  -----------------------------------------------------------------------------------------------------------
+ * | HEADER | HIGH KEY | ENTRIES HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
+ *  -----------------------------------------------------------------------------------------------------------
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
@@ -38,12 +52,26 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   // must call Init method after creating a new node (i.e., after allocated a new page with the buffer pool)
   void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = INTERNAL_PAGE_SIZE);
 
+  KeyType GetHighKey() const;
+  void SetHighKey(const KeyType &high_key);
+  bool IsBeyondHighKey(const KeyType &key, const KeyComparator &comparator) const;
+
   KeyType KeyAt(int index) const;
   void SetKeyAt(int index, const KeyType &key);
   int ValueIndex(const ValueType &value) const;
   ValueType ValueAt(int index) const;
 
   ValueType Lookup(const KeyType &key, const KeyComparator &comparator) const;
+
+  // capacity: whether key fits into the page with my entries, whether any key can be inserted without a split,
+  // whether the key at index can be replaced by key, whether the entries of sibling and middle_key fit in with mine,
+  // and whether the page holds so few entries that it should be merged or redistributed
+  bool HasRoomFor(const KeyType &key) const;
+  bool HasRoomForAny() const;
+  bool CanSetKeyAt(int index, const KeyType &key) const;
+  bool CanAbsorb(const BPlusTreeInternalPage *sibling, const KeyType &middle_key) const;
+  bool IsUnderfull() const;
+
   void PopulateNewRoot(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
   int InsertNodeAfter(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
   int Remove(int index);
@@ -54,12 +82,18 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   void MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
                         BufferPoolManager *buffer_pool_manager);
   void MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
-                         BufferPoolManager *buffer_pool_manager, const int parent_index);
+                         BufferPoolManager *buffer_pool_manager);
+
+  // bulk loading: append sorted entries after every entry of the page, and adopt their children
+  void AppendSorted(const MappingType *items, int size, BufferPoolManager *buffer_pool_manager);
+  static int FitCount(const MappingType *items, int size);
 
  private:
-  void CopyNFrom(MappingType *items, int size, BufferPoolManager *buffer_pool_manager);
+  void CopyNFrom(const MappingType *items, int size, BufferPoolManager *buffer_pool_manager);
   void CopyLastFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager);
-  void CopyFirstFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager, const KeyType &middle_key, const int parent_index);
-  MappingType array[0];
+  void CopyFirstFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager);
+  void Adopt(page_id_t child_page_id, BufferPoolManager *buffer_pool_manager);
+  KeyType high_key_;
+  PageEntries<KeyType, ValueType> entries_;
 };
 }  // namespace bustub
@@ -14,30 +14,45 @@
 #include <vector>
 
 #include "storage/page/b_plus_tree_page.h"
+#include "storage/page/slotted_entries.h"
 
 namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
-#define LEAF_PAGE_HEADER_SIZE 28
-#define LEAF_PAGE_SIZE ((PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
+#define LEAF_PAGE_HEADER_SIZE 32
+// bytes available to the entries of a leaf page, and the number of entries its max size derives from, see PageEntries
+#define LEAF_PAGE_SPACE \
+  (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE - 2 * sizeof(KeyType) - PageEntries<KeyType, ValueType>::HEADER_SIZE)
+#define LEAF_PAGE_SLOTS (PageEntries<KeyType, ValueType>::Slots(LEAF_PAGE_SPACE))
+// a leaf holds at most max_size - 1 entries; a leaf of 2 * LEAF_PAGE_SLOTS - 2 entries splits into halves that still
+// have room for any key, so compression can at most double the fanout
+#define LEAF_PAGE_SIZE (2 * LEAF_PAGE_SLOTS - 1)
 
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
  * see include/common/rid.h for detailed implementation) together within leaf
- * page. Only supports unique keys.
+ * page. Keys are unique; the record id of a key in a non-unique tree may refer
+ * to its posting list, see PostingList.
+ *
+ * The entries are prefix and suffix compressed, see CompressedEntries, or slotted if the keys are long strings, see
+ * SlottedEntries. A leaf is full once it holds max_size - 1 entries or the next key does not fit, see HasRoomFor.
+ *
+ * Unless the leaf is the rightmost one, all of its keys are smaller than its high key, and all keys of the leaves to
+ * its right are at least as large. Unless the leaf is the leftmost one, its low key is the high key of the leaf to its
+ * left. The leaves are linked in both directions, for forward and reverse scans.
  *
  * Leaf page format (keys are stored in order):
- *  ----------------------------------------------------------------------
- * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
- *  ----------------------------------------------------------------------
+ *  -----------------------------------------------------------------------------------------------
+ * | HEADER | HIGH KEY | LOW KEY | ENTRIES HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
+ *  ---------------------------------------------------------------------------------------------------------
  *
- *  Header format (size in byte, 28 bytes in total):
+ *  Header format (size in byte, 32 bytes in total):
  *  ---------------------------------------------------------------------
  * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
  *  ---------------------------------------------------------------------
- *  -----------------------------------------------
- * | ParentPageId (4) | PageId (4) | NextPageId (4)
- *  -----------------------------------------------
+ *  ----------------------------------------------------------------
+ * | ParentPageId (4) | PageId (4) | NextPageId (4) | PrevPageId (4)
+ *  ----------------------------------------------------------------
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeLeafPage : public BPlusTreePage {
@@ -47,11 +62,24 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = LEAF_PAGE_SIZE);
 
   // helper methods
-  page_id_t GetNextPageId() const;
-  void SetNextPageId(page_id_t next_page_id);
+  page_id_t GetPrevPageId() const;
+  void SetPrevPageId(page_id_t prev_page_id);
+  KeyType GetHighKey() const;
+  void SetHighKey(const KeyType &high_key);
+  KeyType GetLowKey() const;
+  void SetLowKey(const KeyType &low_key);
+  bool IsBeyondHighKey(const KeyType &key, const KeyComparator &comparator) const;
+  bool Covers(const KeyType &key, const KeyComparator &comparator) const;
   KeyType KeyAt(int index) const;
   int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
-  const MappingType &GetItem(int index);
+  MappingType GetItem(int index) const;
+  void SetValueAt(int index, const ValueType &value);
+
+  // capacity: whether key fits into the page with my entries, whether the entries of sibling do, and whether the page
+  // holds so few entries that it should be merged or redistributed
+  bool HasRoomFor(const KeyType &key) const;
+  bool CanAbsorb(const BPlusTreeLeafPage *sibling) const;
+  bool IsUnderfull() const;
 
   // insert and delete methods
   int Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
@@ -65,12 +93,17 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   void MoveFirstToEndOf(BPlusTreeLeafPage *recipient);
   void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
 
+  // bulk loading: append entries that are sorted and greater than every key of the page
+  void AppendSorted(const MappingType *items, int size);
+  static int FitCount(const MappingType *items, int size);
+
  private:
-  void CopyNFrom(MappingType *items, int size);
+  void CopyNFrom(const MappingType *items, int size);
   void CopyLastFrom(const MappingType &item);
   void CopyFirstFrom(const MappingType &item);
-  void CopyAllFrom(MappingType *items, int size);
-  page_id_t next_page_id_;
-  MappingType array[0];
+  page_id_t prev_page_id_;
+  KeyType high_key_;
+  KeyType low_key_;
+  PageEntries<KeyType, ValueType> entries_;
 };
 }  // namespace bustub
@@ -33,11 +33,15 @@ enum class IndexPageType { INVALID_INDEX_PAGE = 0, LEAF_PAGE, INTERNAL_PAGE };
  * It actually serves as a header part for each B+ tree page and
  * contains information shared by both leaf page and internal page.
  *
- * Header format (size in byte, 24 bytes in total):
+ * Every page links to its right sibling on the same level, NextPageId, which
+ * is INVALID_PAGE_ID for the rightmost page. Leaves are scanned along these
+ * links, and B-link trees also follow them on internal levels.
+ *
+ * Header format (size in byte, 28 bytes in total):
  * ----------------------------------------------------------------------------
  * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
  * ----------------------------------------------------------------------------
- * | ParentPageId (4) | PageId(4) |
+ * | ParentPageId (4) | PageId(4) | NextPageId (4) |
  * ----------------------------------------------------------------------------
  */
 class BPlusTreePage {
@@ -60,6 +64,9 @@ class BPlusTreePage {
   page_id_t GetPageId() const;
   void SetPageId(page_id_t page_id);
 
+  page_id_t GetNextPageId() const;
+  void SetNextPageId(page_id_t next_page_id);
+
   void SetLSN(lsn_t lsn = INVALID_LSN);
 
  private:
@@ -70,6 +77,7 @@ class BPlusTreePage {
   int max_size_ __attribute__((__unused__));
   page_id_t parent_page_id_ __attribute__((__unused__));
   page_id_t page_id_ __attribute__((__unused__));
+  page_id_t next_page_id_ __attribute__((__unused__));
 };
 
 }  // namespace bustub
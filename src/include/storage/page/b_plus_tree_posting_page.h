@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_posting_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_posting_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/config.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+#define POSTING_PAGE_HEADER_SIZE 12
+#define POSTING_PAGE_SPACE (PAGE_SIZE - POSTING_PAGE_HEADER_SIZE)
+
+/**
+ * A posting page holds record ids of a key that occurs more than once in a non-unique B+ tree, see PostingList. The
+ * ids are sorted by page id and slot number, and delta compressed: the first id is stored as a whole, every following
+ * one as the varint encoded difference to its predecessor. Ids of the same table page usually differ by a few slots,
+ * so they take a byte or two each.
+ *
+ * Format (size in byte):
+ *  --------------------------------------------------------------------------------------
+ * | NextPageId (4) | Size (4) | Bytes (4) | RID(1) (8) | DELTA(2) | DELTA(3) | ... | DELTA(n)
+ *  --------------------------------------------------------------------------------------
+ */
+class BPlusTreePostingPage {
+ public:
+  /** Empties the page. */
+  void Init();
+
+  /** @return the number of record ids */
+  int GetSize() const { return size_; }
+
+  /** The next page of the posting list, or INVALID_PAGE_ID for the last one. */
+  page_id_t GetNextPageId() const { return next_page_id_; }
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  /** Decodes the record ids and appends them to result, in ascending order. */
+  void GetRids(std::vector<RID> *result) const;
+
+  /** Replaces the record ids with the count ids at rids, which must be sorted, unique, and fit, see FitCount. */
+  void SetRids(const RID *rids, int count);
+
+  /** @return the number of leading ids of the count sorted ids at rids that fit into a page */
+  static int FitCount(const RID *rids, int count);
+
+  /** @return the order of record ids in posting lists, the page id in the high and the slot in the low 32 bits */
+  static uint64_t SortKey(const RID &rid) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(rid.GetPageId())) << 32 | rid.GetSlotNum();
+  }
+
+ private:
+  /** @return the number of bytes the varint encoding of delta takes */
+  static int VarintSize(uint64_t delta);
+
+  page_id_t next_page_id_;
+  int size_;
+  int bytes_;
+  char data_[0];
+};
+
+}  // namespace bustub
@@ -0,0 +1,174 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_entries.h
+//
+// Identification: src/include/storage/page/compressed_entries.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "storage/index/key_search.h"
+
+namespace bustub {
+
+/**
+ * CompressedEntries stores the (key, value) entries of a B+ tree page with prefix and suffix compression: the leading
+ * bytes that all keys of the page share are stored once, in the prefix, and the trailing bytes that are zero in all
+ * keys, such as the padding of short strings in a GenericKey, are not stored at all. Every entry is a fixed-size slot
+ * with the remaining key bytes followed by the value, so entries are still addressed by index.
+ *
+ * The layout only depends on the bytes of the keys, not on their order, so it works with any key comparator. Adding a
+ * key can widen the slots, which re-encodes all entries; the page must make sure beforehand that they still fit, see
+ * BytesWith and MergedBytes. Removing keys never widens the slots, and Recompress narrows them again.
+ *
+ * The object lives at the end of the page header and extends to the end of the page. It does not know how many
+ * entries it holds; the page passes its size to every call.
+ *
+ * Format (size in byte):
+ *  ------------------------------------------------------------------------------------------
+ * | PrefixSize (2) | KeyEnd (2) | Prefix (sizeof(KeyType)) | KEY(1) + VALUE(1) | KEY(2) + ...
+ *  ------------------------------------------------------------------------------------------
+ */
+template <class KeyType, class ValueType>
+class CompressedEntries {
+ public:
+  static constexpr int KEY_SIZE = sizeof(KeyType);
+  static constexpr int VALUE_SIZE = sizeof(ValueType);
+  /** The size of the compression header in front of the entries. */
+  static constexpr int HEADER_SIZE = 4 + KEY_SIZE;
+
+  /**
+   * The byte range [prefix_size_, key_end_) of the keys that the entries store. Pages that are read without a latch
+   * take a consistent snapshot with GetLayout and pass it to the accessors.
+   */
+  struct Layout {
+    int prefix_size_;
+    int key_end_;
+    int Stride() const { return key_end_ - prefix_size_ + VALUE_SIZE; }
+  };
+
+  /** @return the number of entries that fit into space bytes even if none of them compresses */
+  static constexpr int Slots(int space) { return space / (KEY_SIZE + VALUE_SIZE); }
+
+  /**
+   * Empties the entries.
+   * @param space unused: the slots fill the page from the front, so the entries need not know where it ends
+   */
+  void Init(int space = 0) {
+    prefix_size_ = 0;
+    key_end_ = 0;
+  }
+
+  /** @return the layout, clamped to a valid one in case the page is being modified concurrently */
+  Layout GetLayout() const {
+    int key_end = std::clamp<int>(key_end_, 0, KEY_SIZE);
+    return {std::clamp<int>(prefix_size_, 0, key_end), key_end};
+  }
+
+  /** @return the number of bytes that size entries take */
+  int Bytes(int size) const { return size * GetLayout().Stride(); }
+
+  /** @return the number of bytes that the size entries and key take together, e.g. after inserting key */
+  int BytesWith(int size, const KeyType &key) const;
+
+  /**
+   * @return the number of bytes that the entries of this and other, and key if it is not nullptr, take together, e.g.
+   * after merging other into this
+   */
+  int MergedBytes(int size, const CompressedEntries &other, int other_size, const KeyType *key) const;
+
+  KeyType KeyAt(int index) const { return KeyAt(index, GetLayout()); }
+  KeyType KeyAt(int index, const Layout &layout) const;
+  ValueType ValueAt(int index) const { return ValueAt(index, GetLayout()); }
+  ValueType ValueAt(int index, const Layout &layout) const;
+  void SetValueAt(int index, const ValueType &value);
+
+  /** Replaces the key at index. The entries must fit with the new key. */
+  void SetKeyAt(int index, const KeyType &key, int size);
+
+  /** Inserts an entry at index, shifting the following ones. The entries must fit with the new one. */
+  void Insert(int index, const KeyType &key, const ValueType &value, int size);
+
+  /** Removes the entry at index, shifting the following ones. */
+  void Remove(int index, int size);
+
+  /** Appends count entries. The entries must fit with the new ones. */
+  void Append(const std::pair<KeyType, ValueType> *items, int count, int size);
+
+  /** Copies the entries [from, from + count) to items. */
+  void CopyOut(int from, int count, std::pair<KeyType, ValueType> *items) const;
+
+  /** Recomputes the layout from the keys, so that entries that were removed no longer widen the slots. */
+  void Recompress(int size);
+
+  /** @return the number of trailing entries that a split moves to the new page, half of them */
+  int HalfCount(int size) const { return (size + 1) / 2; }
+
+  /**
+   * @return the number of leading items, at most count, that fit into space bytes of entries. Used to fill a new page.
+   */
+  static int FitCount(const std::pair<KeyType, ValueType> *items, int count, int space);
+
+  /**
+   * Binary search over the keys, see KeyBound. Keys that order like integers are searched with Int64KeyBound when the
+   * slots start with the whole key. Reads no entry beyond space bytes, even if the page is modified concurrently.
+   * @param size the number of entries
+   * @param space the number of bytes the entries may take
+   * @return the index of the first key that is not smaller (if upper: greater) than key, or size if there is none
+   */
+  template <class KeyComparator>
+  int Search(int size, int space, const KeyType &key, const KeyComparator &comparator, bool upper) const {
+    return Search(GetLayout(), 0, size, space, key, comparator, upper);
+  }
+
+  /**
+   * Search over the keys [from, size) with a layout snapshot, see above. The result is a valid index for the snapshot.
+   * @return the index of the first key in [from, size) that is not smaller (if upper: greater) than key, or the end
+   */
+  template <class KeyComparator>
+  int Search(const Layout &layout, int from, int size, int space, const KeyType &key, const KeyComparator &comparator,
+             bool upper) const {
+    size = std::clamp(size, from, std::max(from, space / layout.Stride()));
+    if (layout.prefix_size_ == 0 && HasInt64Keys(comparator)) {
+      int64_t int_key;
+      memcpy(&int_key, &key, sizeof(int64_t));
+      int width = std::min<int>(layout.key_end_, sizeof(int64_t));
+      return from + Int64KeyBound(data_ + from * layout.Stride(), layout.Stride(), width, size - from, int_key, upper);
+    }
+    return from + KeyBound(size - from, key, comparator, upper,
+                           [this, &layout, from](int index) { return KeyAt(from + index, layout); });
+  }
+
+ private:
+  /** @return the number of leading bytes of key that are not all zero */
+  static int SignificantSize(const KeyType &key);
+
+  /** @return the length of the common prefix of a and b, at most limit */
+  static int CommonPrefix(const char *a, const char *b, int limit);
+
+  /** Writes the entry at index with the given layout. */
+  void Encode(int index, const Layout &layout, const KeyType &key, const ValueType &value);
+
+  /** Re-encodes all entries with a new layout, taking the prefix bytes from prefix. */
+  void Relayout(const Layout &layout, const char *prefix, int size);
+
+  /** @return the layout for the entries and key, which is the current one, or a wider one if key does not fit it */
+  Layout LayoutWith(int size, const KeyType &key) const;
+
+  uint16_t prefix_size_;
+  uint16_t key_end_;
+  char prefix_[KEY_SIZE];
+  char data_[0];
+};
+
+}  // namespace bustub
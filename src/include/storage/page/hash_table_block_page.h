@@ -13,22 +13,28 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <utility>
 #include <vector>
 
 #include "common/config.h"
 #include "storage/index/int_comparator.h"
 #include "storage/page/hash_table_page_defs.h"
+#include "storage/page/hash_table_tags.h"
 
 namespace bustub {
 /**
  * Store indexed key and and value together within block page. Supports
  * non-unique keys.
  *
+ * Each slot has a tag byte next to its occupied and readable flags: EMPTY_TAG if the slot was never occupied,
+ * TOMBSTONE_TAG if its pair was removed, and otherwise the tag of its key, see HashTag. A probe compares the tags of
+ * GROUP_SIZE slots with the tag of its key at once, so keys are only compared for the few slots whose tag matches.
+ *
  * Block page format (keys are stored in order):
- *  ----------------------------------------------------------------
- * | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
- *  ----------------------------------------------------------------
+ *  -------------------------------------------------------------------------------------------------------
+ * | OCCUPIED | READABLE | TAG(1) ... TAG(n) | PADDING | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
+ *  -------------------------------------------------------------------------------------------------------
  *
  *  Here '+' means concatenation.
  *
@@ -36,6 +42,18 @@ namespace bustub {
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class HashTableBlockPage {
  public:
+  /** The number of slots whose tags MatchTag compares at once. */
+  static constexpr size_t GROUP_SIZE = TAG_GROUP_SIZE;
+  /** The tag of a slot that was never occupied. A new page is zeroed, so all its slots are empty. */
+  static constexpr uint8_t EMPTY_TAG = 0x00;
+  /** The tag of a slot whose pair was removed. */
+  static constexpr uint8_t TOMBSTONE_TAG = 0x01;
+  /** The bit that is set in the tags of all readable slots, and in no other tag. */
+  static constexpr uint8_t FULL_TAG = 0x80;
+
+  /** @return the tag of a key with the given hash, see HashTag */
+  static uint8_t TagOf(uint64_t hash) { return HashTag(hash); }
+
   // Delete all constructor / destructor to ensure memory safety
   HashTableBlockPage() = delete;
 
@@ -64,11 +82,24 @@ class HashTableBlockPage {
    * @param bucket_ind index to write the key and value to
    * @param key key to insert
    * @param value value to insert
+   * @param tag the tag of the key, see TagOf
    * @return If the value is inserted successfully, it returns true. If the
    * index is marked as occupied before the key and value can be inserted,
    * Insert returns false.
    */
-  bool Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value);
+  bool Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value, uint8_t tag = FULL_TAG);
+
+  /**
+   * Writes a key and value into an index whose pair was removed, which makes the index readable again. Unlike Insert,
+   * it is not thread safe; the caller holds the write latch of the page.
+   *
+   * @param bucket_ind index to write the key and value to
+   * @param key key to insert
+   * @param value value to insert
+   * @param tag the tag of the key, see TagOf
+   * @return false if the index does not hold a tombstone, e.g. since it was reused already
+   */
+  bool Reuse(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value, uint8_t tag = FULL_TAG);
 
   /**
    * Removes a key and value at index.
@@ -93,11 +124,26 @@ class HashTableBlockPage {
    */
   bool IsReadable(slot_offset_t bucket_ind) const;
 
+  /**
+   * Compares the tags of the GROUP_SIZE slots from bucket_ind with tag at once, with SSE2 where available.
+   *
+   * @param bucket_ind the first slot of the group
+   * @param tag the tag of the key to look for, see TagOf, or TOMBSTONE_TAG to look for the slots of removed pairs
+   * @param[out] empty bit i is set if slot bucket_ind + i was never occupied
+   * @return a mask whose bit i is set if slot bucket_ind + i has the given tag. Slots past the end of the block are in
+   * neither mask.
+   */
+  uint32_t MatchTag(slot_offset_t bucket_ind, uint8_t tag, uint32_t *empty) const;
+
  private:
   std::atomic_char occupied_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
 
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
   std::atomic_char readable_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
+
+  // The tags of the slots, followed by the tags of no slot, which stay EMPTY_TAG, so that a group can be loaded from
+  // any slot.
+  uint8_t tags_[BLOCK_ARRAY_SIZE + GROUP_SIZE - 1];
   MappingType array_[0];
 };
 
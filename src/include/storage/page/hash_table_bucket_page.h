@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_bucket_page.h
+//
+// Identification: src/include/storage/page/hash_table_bucket_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/index/int_comparator.h"
+#include "storage/page/hash_table_page_defs.h"
+#include "storage/page/hash_table_tags.h"
+
+namespace bustub {
+/**
+ * Stores the (key, value) pairs of a bucket of an extendible hash table. Supports non-unique keys, but no duplicate
+ * pairs.
+ *
+ * The pairs are kept densely at the front of the page, so a bucket needs no tombstones: removing a pair moves the last
+ * pair into its place. Each pair has a tag byte, see HashTag, and lookups compare the tags of TAG_GROUP_SIZE pairs at
+ * once before they compare keys.
+ *
+ * A bucket whose pairs cannot be split apart links to overflow pages of the same format, which hold the rest of its
+ * pairs.
+ *
+ * Bucket page format:
+ *  ---------------------------------------------------------------------------------------------------------
+ * | Size (4) | NextPageId (4) | TAG(1) ... TAG(n) | PADDING | KEY(1) + VALUE(1) | ... | KEY(n) + VALUE(n)
+ *  ---------------------------------------------------------------------------------------------------------
+ *
+ *  Here '+' means concatenation.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class HashTableBucketPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  HashTableBucketPage() = delete;
+
+  /** Makes the page an empty bucket without an overflow page. */
+  void Init() {
+    size_ = 0;
+    next_page_id_ = INVALID_PAGE_ID;
+  }
+
+  /** @return the id of the overflow page, or INVALID_PAGE_ID if there is none */
+  page_id_t GetNextPageId() const { return next_page_id_; }
+
+  /** @param next_page_id the id of the overflow page, or INVALID_PAGE_ID */
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  /** @return the number of pairs in the bucket */
+  uint32_t GetSize() const { return size_; }
+
+  /** @return whether the bucket has no room for another pair */
+  bool IsFull() const { return size_ == BUCKET_ARRAY_SIZE; }
+
+  /** @return the key of the index-th pair */
+  KeyType KeyAt(uint32_t index) const { return array_[index].first; }
+
+  /** @return the value of the index-th pair */
+  ValueType ValueAt(uint32_t index) const { return array_[index].second; }
+
+  /**
+   * Appends the values of key to result.
+   *
+   * @param key the key to look up
+   * @param tag the tag of key
+   * @param comparator the comparator of the keys
+   * @param[out] result the values of key
+   * @return whether the bucket holds key
+   */
+  bool GetValue(const KeyType &key, uint8_t tag, KeyComparator comparator, std::vector<ValueType> *result) const;
+
+  /**
+   * @param key the key of the pair
+   * @param value the value of the pair
+   * @param tag the tag of key
+   * @param comparator the comparator of the keys
+   * @return the index of the pair, or -1 if the bucket does not hold it
+   */
+  int Find(const KeyType &key, const ValueType &value, uint8_t tag, KeyComparator comparator) const;
+
+  /**
+   * Appends a pair. The bucket must not be full.
+   *
+   * @param key the key of the pair
+   * @param value the value of the pair
+   * @param tag the tag of key
+   */
+  void Append(const KeyType &key, const ValueType &value, uint8_t tag);
+
+  /**
+   * Removes the index-th pair, and moves the last pair into its place.
+   *
+   * @param index the index of the pair to remove
+   */
+  void RemoveAt(uint32_t index);
+
+ private:
+  /**
+   * Calls on_match(index) for the pairs whose tag equals tag, until it returns false.
+   * @return false if on_match did
+   */
+  template <class MatchFunction>
+  bool ForEachTag(uint8_t tag, MatchFunction &&on_match) const;
+
+  uint32_t size_;
+  page_id_t next_page_id_;
+  // The tags of the pairs, followed by the tags of no pair, so that a group can be loaded from any pair
+  uint8_t tags_[BUCKET_ARRAY_SIZE + TAG_GROUP_SIZE - 1];
+  MappingType array_[0];
+};
+
+}  // namespace bustub
@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_directory_page.h
+//
+// Identification: src/include/storage/page/hash_table_directory_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * Directory page of an extendible hash table. The directory has 2^GlobalDepth slots, and slot i points to the bucket
+ * of the keys whose hashes end in the bits of i. A bucket with a local depth d below the global depth is shared by
+ * the 2^(GlobalDepth - d) slots that agree in their d lowest bits.
+ *
+ * Directory format (size in byte):
+ * --------------------------------------------------------------------------------------------------------
+ * | LSN (4) | PageId (4) | GlobalDepth (4) | LocalDepths (MAX_SLOTS) | BucketPageIds (4 * MAX_SLOTS) |
+ * --------------------------------------------------------------------------------------------------------
+ */
+class HashTableDirectoryPage {
+ public:
+  /** The largest global depth: the directory then takes about two thirds of the page. */
+  static constexpr uint32_t MAX_DEPTH = 9;
+  static constexpr uint32_t MAX_SLOTS = 1U << MAX_DEPTH;
+
+  /** @return the page ID of this page */
+  page_id_t GetPageId() const { return page_id_; }
+
+  /** Sets the page ID of this page */
+  void SetPageId(page_id_t page_id) { page_id_ = page_id; }
+
+  /** @return the lsn of this page */
+  lsn_t GetLSN() const { return lsn_; }
+
+  /** Sets the LSN of this page */
+  void SetLSN(lsn_t lsn) { lsn_ = lsn; }
+
+  /** @return the global depth of the directory */
+  uint32_t GetGlobalDepth() const { return global_depth_; }
+
+  /** @return the number of slots of the directory, 2^GlobalDepth */
+  uint32_t Size() const { return 1U << global_depth_; }
+
+  /** @return the slot of the keys with the given hash */
+  uint32_t SlotOf(uint64_t hash) const { return static_cast<uint32_t>(hash & (Size() - 1)); }
+
+  /**
+   * Doubles the directory: the new upper half of the slots points to the same buckets as the lower half. The global
+   * depth must be below MAX_DEPTH.
+   */
+  void IncrGlobalDepth();
+
+  /** @return the page id of the bucket that slot points to */
+  page_id_t GetBucketPageId(uint32_t slot) const { return bucket_page_ids_[slot]; }
+
+  /** Points slot to the bucket with the given page id */
+  void SetBucketPageId(uint32_t slot, page_id_t page_id) { bucket_page_ids_[slot] = page_id; }
+
+  /** @return the local depth of the bucket that slot points to */
+  uint32_t GetLocalDepth(uint32_t slot) const { return local_depths_[slot]; }
+
+  /** Sets the local depth of the bucket that slot points to, in slot */
+  void SetLocalDepth(uint32_t slot, uint32_t local_depth) { local_depths_[slot] = static_cast<uint8_t>(local_depth); }
+
+  /**
+   * Points the slots of a bucket that was split to the bucket and its split image: of the slots that agree with slot
+   * in their local_depth lowest bits, those with bit local_depth clear keep the bucket, and the others point to the
+   * image. Both get the local depth local_depth + 1.
+   *
+   * @param slot a slot of the bucket
+   * @param local_depth the local depth of the bucket before the split
+   * @param image_page_id the page id of the split image
+   */
+  void SplitBucket(uint32_t slot, uint32_t local_depth, page_id_t image_page_id);
+
+ private:
+  lsn_t lsn_;
+  page_id_t page_id_;
+  uint32_t global_depth_;
+  uint8_t local_depths_[MAX_SLOTS];
+  page_id_t bucket_page_ids_[MAX_SLOTS];
+};
+
+static_assert(sizeof(HashTableDirectoryPage) <= PAGE_SIZE, "the directory must fit into a page");
+
+}  // namespace bustub
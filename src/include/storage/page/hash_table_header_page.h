@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <cassert>
 #include <climits>
 #include <cstdlib>
@@ -26,10 +27,10 @@ namespace bustub {
  *
  * Header Page for linear probing hash table.
  *
- * Header format (size in byte, 16 bytes in total):
- * -------------------------------------------------------------
- * | LSN (4) | Size (4) | PageId(4) | NextBlockIndex(4)
- * -------------------------------------------------------------
+ * Header format (size in byte, 32 bytes in total):
+ * ---------------------------------------------------------------------------------------------------
+ * | LSN (4) | Unused (4) | Size (8) | PageId (4) | Unused (4) | NextBlockIndex (8) | BlockPageIds ...
+ * ---------------------------------------------------------------------------------------------------
  */
 class HashTableHeaderPage {
  public:
@@ -84,17 +85,31 @@ class HashTableHeaderPage {
    */
   page_id_t GetBlockPageId(size_t index);
 
+  /**
+   * Replaces the page_id of the index-th block if it is still expected. The block page ids are atomic, so that blocks
+   * can be allocated by concurrent inserts, which only hold the table latch in read mode.
+   *
+   * @param index the index of the block
+   * @param expected the page_id the block is expected to have
+   * @param page_id the new page_id of the block
+   * @return false if the block had another page_id, which is left in place
+   */
+  bool ReplaceBlockPageId(size_t index, page_id_t expected, page_id_t page_id);
+
   /**
    * @return the number of blocks currently stored in the header page
    */
   size_t NumBlocks();
 
+  /** The number of block page ids that fit into the header page, which limits the size of the hash table. */
+  static constexpr size_t MAX_BLOCKS = (PAGE_SIZE - 32) / sizeof(page_id_t);
+
  private:
-  __attribute__((unused)) lsn_t lsn_;
-  __attribute__((unused)) size_t size_;
-  __attribute__((unused)) page_id_t page_id_;
-  __attribute__((unused)) size_t next_ind_;
-  __attribute__((unused)) page_id_t block_page_ids_[0];
+  lsn_t lsn_;
+  size_t size_;
+  page_id_t page_id_;
+  size_t next_ind_;
+  std::atomic<page_id_t> block_page_ids_[0];
 };
 
 }  // namespace bustub
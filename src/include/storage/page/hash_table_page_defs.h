@@ -14,11 +14,21 @@
 
 #define MappingType std::pair<KeyType, ValueType>
 
-/** BLOCK_ARRAY_SIZE is the number of (key, value) pairs that can be stored in   * a block page. It is an approximate
+/** BLOCK_ARRAY_SIZE is the number of (key, value) pairs that can be stored in a block page. It is an approximate
  * calculation based on the size of MappingType (which is a std::pair of KeyType and ValueType). For each key/value
- * pair, we need two additional bits for occupied_ and readable_. 4 * PAGE_SIZE / (4 * sizeof (MappingType) + 1) =
- * PAGE_SIZE/(sizeof (MappingType) + 0.25) because 0.25 bytes = 2 bits is the space required to maintain the occupied
- * and readable flags for a key value pair.*/
-#define BLOCK_ARRAY_SIZE (4 * PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+ * pair, we need two additional bits for occupied_ and readable_, and a byte for its tag in tags_. 4 * (PAGE_SIZE - 32)
+ * / (4 * (sizeof (MappingType) + 1) + 1) = (PAGE_SIZE - 32) / (sizeof (MappingType) + 1.25) because 1.25 bytes = 10
+ * bits is the space required to maintain the tag and the occupied and readable flags for a key value pair. The 32
+ * bytes cover the padding behind the tags, which lets a group of tags be loaded at once from any slot, the rounding of
+ * the flags to whole bytes and the alignment of the pairs.*/
+#define BLOCK_ARRAY_SIZE (4 * (PAGE_SIZE - 32) / (4 * (sizeof(MappingType) + 1) + 1))
 
 #define HASH_TABLE_BLOCK_TYPE HashTableBlockPage<KeyType, ValueType, KeyComparator>
+
+/** BUCKET_ARRAY_SIZE is the number of (key, value) pairs that can be stored in a bucket page of an extendible hash
+ * table. Each pair takes sizeof (MappingType) bytes and a byte for its tag; the 32 bytes cover the size of the bucket,
+ * the id of its overflow page, the padding behind the tags, which lets a group of tags be loaded at once from any
+ * slot, and the alignment of the pairs.*/
+#define BUCKET_ARRAY_SIZE ((PAGE_SIZE - 32) / (sizeof(MappingType) + 1))
+
+#define HASH_TABLE_BUCKET_TYPE HashTableBucketPage<KeyType, ValueType, KeyComparator>
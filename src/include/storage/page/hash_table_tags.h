@@ -0,0 +1,56 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_tags.h
+//
+// Identification: src/include/storage/page/hash_table_tags.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <emmintrin.h>
+#define BUSTUB_HASH_TAG_X86
+#endif
+
+namespace bustub {
+
+/**
+ * The pages of the hash tables keep a tag byte per slot, which holds the top bits of the hash of the key in the slot.
+ * A lookup compares the tags of a group of slots with the tag of its key at once, like the control bytes of a Swiss
+ * table, and only compares the keys of the slots whose tags match.
+ */
+
+/** The number of tags that MatchTags compares at once, the width of an SSE2 register. */
+constexpr size_t TAG_GROUP_SIZE = 16;
+
+/** @return the tag of a key with the given hash: the top seven bits of the hash, and the top bit set */
+inline uint8_t HashTag(uint64_t hash) { return 0x80 | static_cast<uint8_t>(hash >> 57); }
+
+/**
+ * @param tags the first of TAG_GROUP_SIZE tags, which must all be readable
+ * @param tag the tag to look for
+ * @return a mask whose bit i is set if tags[i] equals tag
+ */
+inline uint32_t MatchTags(const uint8_t *tags, uint8_t tag) {
+#ifdef BUSTUB_HASH_TAG_X86
+  // SSE2 is part of x86-64, so the group needs no check of the CPU
+  const __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tags));
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(tag))));
+#else
+  uint32_t match = 0;
+  for (size_t i = 0; i < TAG_GROUP_SIZE; i++) {
+    match |= static_cast<uint32_t>(tags[i] == tag) << i;
+  }
+  return match;
+#endif
+}
+
+}  // namespace bustub
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>  // NOLINT
 #include <cstring>
 #include <iostream>
 
@@ -49,10 +51,16 @@ class Page {
   inline bool IsDirty() { return is_dirty_; }
 
   /** Acquire the page write latch. */
-  inline void WLatch() { rwlatch_.WLock(); }
+  inline void WLatch() {
+    rwlatch_.WLock();
+    version_.fetch_add(1);
+  }
 
   /** Release the page write latch. */
-  inline void WUnlatch() { rwlatch_.WUnlock(); }
+  inline void WUnlatch() {
+    version_.fetch_add(1);
+    rwlatch_.WUnlock();
+  }
 
   /** Acquire the page read latch. */
   inline void RLatch() { rwlatch_.RLock(); }
@@ -60,6 +68,24 @@ class Page {
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
+  /**
+   * Starts an optimistic read of the page, which takes no latch and does not write to the page. Everything read from
+   * the page afterwards may be inconsistent, and must not be relied upon before ValidateVersion succeeds.
+   * @return the version of the page, which is odd while the page is write latched or its frame is being handed over
+   */
+  inline uint64_t ReadVersion() { return version_.load(std::memory_order_acquire); }
+
+  /**
+   * Ends an optimistic read of the page.
+   * @param version the version returned by ReadVersion
+   * @return true if the page was neither write latched nor handed over since ReadVersion returned version, i.e. if
+   * everything read from the page in between is consistent
+   */
+  inline bool ValidateVersion(uint64_t version) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return (version & 1) == 0 && version_.load(std::memory_order_relaxed) == version;
+  }
+
   /** @return the page LSN. */
   inline lsn_t GetLSN() { return *reinterpret_cast<lsn_t *>(GetData() + OFFSET_LSN); }
 
@@ -80,12 +106,20 @@ class Page {
 
   /** The actual data that is stored within a page. */
   char data_[PAGE_SIZE]{};
+  // The book-keeping fields are atomic, so that the buffer pool manager can pin resident pages without its latch.
   /** The ID of this page. */
-  page_id_t page_id_ = INVALID_PAGE_ID;
-  /** The pin count of this page. */
-  int pin_count_ = 0;
+  std::atomic<page_id_t> page_id_{INVALID_PAGE_ID};
+  /** The pin count of this page, or -1 while the buffer pool manager hands the frame over to another page. */
+  std::atomic<int> pin_count_{0};
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
-  bool is_dirty_ = false;
+  std::atomic<bool> is_dirty_{false};
+  /** True while the buffer pool manager transfers the frame's contents to or from disk without holding its latch. */
+  std::atomic<bool> io_in_progress_{false};
+  /** Incremented whenever the page is write latched or unlatched, and whenever the frame is handed over to another
+   * page or freed, so that optimistic readers can tell whether the page changed under them. */
+  std::atomic<uint64_t> version_{0};
+  /** Signaled, under the buffer pool manager's latch, when the I/O of the frame completes. */
+  std::condition_variable io_cv_;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
 };
@@ -0,0 +1,171 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// slotted_entries.h
+//
+// Identification: src/include/storage/page/slotted_entries.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "storage/index/key_search.h"
+#include "storage/page/compressed_entries.h"
+
+namespace bustub {
+
+/**
+ * SlottedEntries stores the (key, value) entries of a B+ tree page with keys of variable length, such as strings: the
+ * slots at the front of the page hold the offset and length of each key along with the value, and the keys themselves
+ * are stored in a heap that grows from the end of the page towards the slots. A key takes its own significant bytes,
+ * without the zero padding of its KeyType, so short and long keys share a page without the short ones paying for the
+ * long ones, as in CompressedEntries.
+ *
+ * Removing or replacing a key leaves a hole in the heap; the holes are compacted when a key does not fit into the free
+ * space between slots and heap otherwise, and by Recompress. The interface is the one of CompressedEntries, so that
+ * the pages work with either, see PageEntries.
+ *
+ * Format (size in byte):
+ *  ------------------------------------------------------------------------------------------------------------
+ * | Space (2) | HeapStart (2) | HeapBytes (2) | Unused (2) | SLOT(1) | SLOT(2) | ... | free | KEY(n) ... KEY(1) |
+ *  ------------------------------------------------------------------------------------------------------------
+ *  SLOT: | KeyOffset (2) | KeyLength (2) | VALUE |
+ */
+template <class KeyType, class ValueType>
+class SlottedEntries {
+ public:
+  static constexpr int KEY_SIZE = sizeof(KeyType);
+  static constexpr int VALUE_SIZE = sizeof(ValueType);
+  static constexpr int SLOT_SIZE = 4 + VALUE_SIZE;
+  /** The size of the header in front of the slots. */
+  static constexpr int HEADER_SIZE = 8;
+
+  /** The slots do not depend on the keys; the layout only exists for the interface of CompressedEntries. */
+  struct Layout {};
+
+  /**
+   * @return the number of entries that a page sizes its max_size from: as many as fit with keys of 8 bytes, which is
+   * about the shortest string key
+   */
+  static constexpr int Slots(int space) { return space / (SLOT_SIZE + 8); }
+
+  /**
+   * Empties the entries.
+   * @param space the number of bytes the entries may take, up to the end of the page
+   */
+  void Init(int space) {
+    space_ = space;
+    heap_start_ = space;
+    heap_bytes_ = 0;
+  }
+
+  Layout GetLayout() const { return {}; }
+
+  /** @return the number of bytes that size entries take */
+  int Bytes(int size) const { return size * SLOT_SIZE + heap_bytes_; }
+
+  /** @return the number of bytes that the size entries and key take together, e.g. after inserting key */
+  int BytesWith(int size, const KeyType &key) const { return Bytes(size + 1) + SignificantSize(key); }
+
+  /**
+   * @return the number of bytes that the entries of this and other, and key if it is not nullptr, take together, e.g.
+   * after merging other into this
+   */
+  int MergedBytes(int size, const SlottedEntries &other, int other_size, const KeyType *key) const {
+    return Bytes(size) + other.Bytes(other_size) + (key != nullptr ? SLOT_SIZE + SignificantSize(*key) : 0);
+  }
+
+  KeyType KeyAt(int index) const { return KeyAt(index, GetLayout()); }
+  KeyType KeyAt(int index, const Layout &layout) const;
+  ValueType ValueAt(int index) const { return ValueAt(index, GetLayout()); }
+  ValueType ValueAt(int index, const Layout &layout) const;
+  void SetValueAt(int index, const ValueType &value);
+
+  /** Replaces the key at index. The entries must fit with the new key. */
+  void SetKeyAt(int index, const KeyType &key, int size);
+
+  /** Inserts an entry at index, shifting the following ones. The entries must fit with the new one. */
+  void Insert(int index, const KeyType &key, const ValueType &value, int size);
+
+  /** Removes the entry at index, shifting the following ones. */
+  void Remove(int index, int size);
+
+  /** Appends count entries. The entries must fit with the new ones. */
+  void Append(const std::pair<KeyType, ValueType> *items, int count, int size);
+
+  /** Copies the entries [from, from + count) to items. */
+  void CopyOut(int from, int count, std::pair<KeyType, ValueType> *items) const;
+
+  /** Compacts the heap, so that keys that were removed no longer take space. */
+  void Recompress(int size);
+
+  /** @return the number of trailing entries that a split moves to the new page: the ones with about half the bytes */
+  int HalfCount(int size) const;
+
+  /**
+   * @return the number of leading items, at most count, that fit into space bytes of entries. Used to fill a new page.
+   */
+  static int FitCount(const std::pair<KeyType, ValueType> *items, int count, int space);
+
+  /**
+   * Binary search over the keys, see KeyBound. Reads no slot beyond space bytes, and no key beyond the heap, even if
+   * the page is modified concurrently.
+   * @param size the number of entries
+   * @param space the number of bytes the entries may take
+   * @return the index of the first key that is not smaller (if upper: greater) than key, or size if there is none
+   */
+  template <class KeyComparator>
+  int Search(int size, int space, const KeyType &key, const KeyComparator &comparator, bool upper) const {
+    return Search(GetLayout(), 0, size, space, key, comparator, upper);
+  }
+
+  /** Search over the keys [from, size), see above. @return the index of the first matching key, or the end */
+  template <class KeyComparator>
+  int Search(const Layout &layout, int from, int size, int space, const KeyType &key, const KeyComparator &comparator,
+             bool upper) const {
+    size = std::clamp(size, from, std::max(from, space / SLOT_SIZE));
+    return from + KeyBound(size - from, key, comparator, upper,
+                           [this, &layout, from](int index) { return KeyAt(from + index, layout); });
+  }
+
+ private:
+  /** @return the number of leading bytes of key that are not all zero */
+  static int SignificantSize(const KeyType &key);
+
+  char *Slot(int index) { return data_ + index * SLOT_SIZE; }
+  const char *Slot(int index) const { return data_ + index * SLOT_SIZE; }
+
+  /** @return the offset and length of the key at index, clamped to the heap */
+  std::pair<int, int> KeyExtent(int index) const;
+
+  /** Writes the key bytes to the heap, compacting it first if necessary, and points the slot at index to them. */
+  void StoreKey(int index, const KeyType &key, int size);
+
+  /** Moves the keys of the size slots to the end of the page, closing the holes between them. */
+  void Compact(int size);
+
+  uint16_t space_;
+  uint16_t heap_start_;
+  uint16_t heap_bytes_;
+  uint16_t unused_;
+  char data_[0];
+};
+
+/**
+ * The entries of B+ tree pages with keys of type KeyType: keys of up to 64 bytes are compressed into slots of a fixed
+ * size, see CompressedEntries. Larger keys are meant for variable-length strings and go into slotted pages, see
+ * SlottedEntries.
+ */
+template <class KeyType, class ValueType>
+using PageEntries = std::conditional_t<(sizeof(KeyType) > 64), SlottedEntries<KeyType, ValueType>,
+                                       CompressedEntries<KeyType, ValueType>>;
+
+}  // namespace bustub
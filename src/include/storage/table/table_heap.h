@@ -102,6 +102,13 @@ class TableHeap {
   /** @return the begin iterator of this table */
   TableIterator Begin(Transaction *txn);
 
+  /**
+   * @param txn the transaction performing the scan
+   * @param strategy the access strategy the iterator fetches pages with, e.g. a ring for a large sequential scan
+   * @return the begin iterator of this table
+   */
+  TableIterator Begin(Transaction *txn, BufferAccessStrategy *strategy);
+
   /** @return the end iterator of this table */
   TableIterator End();
 
@@ -14,6 +14,7 @@
 
 #include <cassert>
 
+#include "buffer/buffer_access_strategy.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
 #include "storage/table/tuple.h"
@@ -29,10 +30,14 @@ class TableIterator {
   friend class Cursor;
 
  public:
-  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn);
+  TableIterator(TableHeap *table_heap, RID rid, Transaction *txn, BufferAccessStrategy *strategy = nullptr);
 
   TableIterator(const TableIterator &other)
-      : table_heap_(other.table_heap_), tuple_(new Tuple(*other.tuple_)), txn_(other.txn_) {}
+      : table_heap_(other.table_heap_),
+        tuple_(new Tuple(*other.tuple_)),
+        txn_(other.txn_),
+        strategy_(other.strategy_),
+        read_ahead_until_(other.read_ahead_until_) {}
 
   ~TableIterator() { delete tuple_; }
 
@@ -52,13 +57,25 @@ class TableIterator {
     table_heap_ = other.table_heap_;
     *tuple_ = *other.tuple_;
     txn_ = other.txn_;
+    strategy_ = other.strategy_;
+    read_ahead_until_ = other.read_ahead_until_;
     return *this;
   }
 
  private:
+  /**
+   * Reads the pages after next_page_id ahead if the table is laid out sequentially, i.e. if next_page_id directly
+   * follows cur_page_id, so that the scan does not wait for the disk one page at a time.
+   */
+  void ReadAhead(page_id_t cur_page_id, page_id_t next_page_id);
+
   TableHeap *table_heap_;
   Tuple *tuple_;
   Transaction *txn_;
+  /** The access strategy pages are fetched with when moving to the next page, nullptr for the shared pool. */
+  BufferAccessStrategy *strategy_;
+  /** Pages below this id have been read ahead already. */
+  page_id_t read_ahead_until_{INVALID_PAGE_ID};
 };
 
 }  // namespace bustub
@@ -10,7 +10,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <cassert>
 #include <cstring>
 #include <iostream>
@@ -52,18 +54,10 @@ DiskManager::DiskManager(const std::string &db_file)
     }
   }
 
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out);
-    db_io_.close();
-    // reopen with original mode
-    db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-    if (!db_io_.is_open()) {
-      throw Exception("can't open db file");
-    }
+  // create the file if it does not exist
+  db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+  if (db_fd_ < 0) {
+    throw Exception("can't open db file");
   }
   buffer_used = nullptr;
 }
@@ -72,53 +66,43 @@ DiskManager::DiskManager(const std::string &db_file)
  * Close all file streams
  */
 void DiskManager::ShutDown() {
-  db_io_.close();
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+    db_fd_ = -1;
+  }
   log_io_.close();
 }
 
 /**
  * Write the contents of the specified page into disk file
+ * Safe to call concurrently, also with ReadPage
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
-  size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
-  // set write cursor to offset
+  off_t offset = static_cast<off_t>(page_id) * PAGE_SIZE;
   num_writes_ += 1;
-  db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
+  // write at offset, without moving a shared cursor
+  ssize_t write_count = pwrite(db_fd_, page_data, PAGE_SIZE, offset);
   // check for I/O error
-  if (db_io_.bad()) {
+  if (write_count != PAGE_SIZE) {
     LOG_DEBUG("I/O error while writing");
-    return;
   }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
 }
 
 /**
  * Read the contents of the specified page into the given memory area
+ * Safe to call concurrently, also with WritePage
  */
 void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  int offset = page_id * PAGE_SIZE;
-  // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
-    LOG_DEBUG("I/O error reading past end of file");
-    // std::cerr << "I/O error while reading" << std::endl;
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, PAGE_SIZE);
-    if (db_io_.bad()) {
-      LOG_DEBUG("I/O error while reading");
-      return;
-    }
-    // if file ends before reading PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < PAGE_SIZE) {
-      LOG_DEBUG("Read less than a page");
-      db_io_.clear();
-      // std::cerr << "Read less than a page" << std::endl;
-      memset(page_data + read_count, 0, PAGE_SIZE - read_count);
-    }
+  off_t offset = static_cast<off_t>(page_id) * PAGE_SIZE;
+  ssize_t read_count = pread(db_fd_, page_data, PAGE_SIZE, offset);
+  if (read_count < 0) {
+    LOG_DEBUG("I/O error while reading");
+    read_count = 0;
+  }
+  // if file ends before reading PAGE_SIZE, or the page lies beyond the end of the file
+  if (read_count < PAGE_SIZE) {
+    LOG_DEBUG("Read less than a page");
+    memset(page_data + read_count, 0, PAGE_SIZE - read_count);
   }
 }
 
@@ -207,6 +191,14 @@ int DiskManager::GetNumFlushes() const { return num_flushes_; }
  */
 int DiskManager::GetNumWrites() const { return num_writes_; }
 
+/**
+ * Returns number of pages the db file spans, counting a trailing partial page
+ */
+int DiskManager::GetNumPages() {
+  int file_size = GetFileSize(file_name_);
+  return file_size <= 0 ? 0 : (file_size + PAGE_SIZE - 1) / PAGE_SIZE;
+}
+
 /**
  * Returns true if the log is currently being flushed
  */
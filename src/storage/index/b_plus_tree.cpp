@@ -9,27 +9,36 @@
 //
 //===----------------------------------------------------------------------===//
 
-#include <string>
-#include <iostream>
+#include <algorithm>
 #include <cinttypes>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "common/exception.h"
 #include "common/rid.h"
 #include "common/logger.h"
 #include "storage/index/b_plus_tree.h"
+#include "storage/index/posting_list.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 #include "storage/page/header_page.h"
 
 namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(const std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                          int leaf_max_size, int internal_max_size)
+                          int leaf_max_size, int internal_max_size, bool b_link, bool unique_keys)
     : index_name_(std::move(name)),
       root_page_id_(INVALID_PAGE_ID),
       buffer_pool_manager_(buffer_pool_manager),
       comparator_(comparator),
-      leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size) {}
+      // compressed pages only guarantee room for this many entries, see LEAF_PAGE_SIZE and INTERNAL_PAGE_SIZE
+      leaf_max_size_(std::min<int>(leaf_max_size, LEAF_PAGE_SIZE)),
+      internal_max_size_(std::min<int>(internal_max_size, INTERNAL_PAGE_SIZE)),
+      b_link_(b_link),
+      unique_keys_(unique_keys) {}
 
 /*
  * @return true if there is nothing stored in the b+ tree, false otherwise
@@ -42,28 +51,64 @@ bool BPLUSTREE_TYPE::IsEmpty() const { return root_page_id_ == INVALID_PAGE_ID;
  *****************************************************************************/
 /*
  * Add the value that is associated with parameter key to the vector result
- * if key exists.
+ * if key exists, or all of its values if the tree is non-unique.
  * This method is used for point query
  * @return : true means key exists
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) {
-  if(IsEmpty()) {
+  ReadPageGuard leaf_guard = FindLeafPage(key);
+  if (!leaf_guard.IsValid()) {
     return false;
   }
-  auto leaf_page = FindLeafPage(key, false, transaction, Operation::SEARCH);
-  auto leaf_node = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(leaf_page->GetData());
-  ValueType temp_value;
-  if (leaf_node->Lookup(key, &temp_value, comparator_)){
-    LOG_INFO("# sucessful");
-    result->push_back(temp_value);
-    UnlockPage(leaf_page, transaction, Operation::SEARCH);
-    return true;
-  }else{
-    LOG_INFO("# failed");
-    UnlockPage(leaf_page, transaction, Operation::SEARCH);
+  ValueType value;
+  if (!leaf_guard.As<LeafPage>()->Lookup(key, &value, comparator_)) {
     return false;
   }
+  if (!unique_keys_ && PostingList::IsReference(value)) {
+    PostingList::Read(buffer_pool_manager_, value, result);
+  } else {
+    result->push_back(value);
+  }
+  return true;
+}
+
+/*
+ * Look up a batch of keys, such as the probes of an index join. The keys are
+ * visited in ascending order, and as long as a key lies within the leaf of the
+ * previous one, it is looked up in that leaf, which stays latched, instead of
+ * descending from the root again. Keys that arrive roughly sorted thus touch
+ * each leaf once.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                               Transaction *transaction) {
+  results->resize(keys.size());
+  std::vector<size_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [this, &keys](size_t a, size_t b) { return comparator_(keys[a], keys[b]) < 0; });
+  ReadPageGuard leaf_guard;
+  for (size_t i : order) {
+    const KeyType &key = keys[i];
+    if (!leaf_guard.IsValid() || !leaf_guard.As<LeafPage>()->Covers(key, comparator_)) {
+      // Release the leaf first: a remove may hold the leaf the descent ends at while it latches this one.
+      leaf_guard.Drop();
+      leaf_guard = FindLeafPage(key);
+      if (!leaf_guard.IsValid()) {
+        return;
+      }
+    }
+    ValueType value;
+    if (!leaf_guard.As<LeafPage>()->Lookup(key, &value, comparator_)) {
+      continue;
+    }
+    if (!unique_keys_ && PostingList::IsReference(value)) {
+      PostingList::Read(buffer_pool_manager_, value, &(*results)[i]);
+    } else {
+      (*results)[i].push_back(value);
+    }
+  }
 }
 
 /*****************************************************************************
@@ -73,17 +118,119 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  * Insert constant key & value pair into b+ tree
  * if current tree is empty, start new tree, update root page id and insert
  * entry, otherwise insert into leaf page.
- * @return: since we only support unique key, if user tries to insert duplicate
- * keys return false, otherwise return true.
+ * @return: if user tries to insert duplicate keys into a unique tree, or a
+ * key & value pair that exists already, return false, otherwise return true.
  */
 INDEX_TEMPLATE_ARGUMENTS
-bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) { 
-  std::lock_guard<std::mutex> locker(root_mutex_);
-  if(IsEmpty()){
-      StartNewTree(key, value, transaction);
+bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  if (b_link_) {
+    return BLinkInsert(key, value);
+  }
+  Context ctx;
+  if (!FindLeafPageForWrite(key, Operation::INSERT, &ctx)) {
+    StartNewTree(key, value);
+    return true;
+  }
+  return InsertIntoLeaf(key, value, &ctx);
+}
+
+/*
+ * Insert a batch of key & value pairs, sorted by key. As long as the next key
+ * lies within the leaf of the previous one, and the leaf stays safe, i.e. the
+ * insert cannot split it, the key goes into that leaf, which stays latched,
+ * instead of descending from the root again. Once the leaf would split, the
+ * key is inserted as usual. Entries with keys in ascending order, as from an
+ * insert of sorted tuples, thus touch each leaf once.
+ * @return: the number of pairs inserted, see Insert
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int BPLUSTREE_TYPE::InsertBatch(std::vector<std::pair<KeyType, ValueType>> *entries, Transaction *transaction) {
+  std::stable_sort(entries->begin(), entries->end(),
+                   [this](const auto &a, const auto &b) { return comparator_(a.first, b.first) < 0; });
+  int inserted = 0;
+  Context ctx;
+  for (const auto &[key, value] : *entries) {
+    if (b_link_) {
+      inserted += BLinkInsert(key, value) ? 1 : 0;
+      continue;
+    }
+    if (!ctx.write_set_.empty()) {
+      WritePageGuard &leaf_guard = ctx.write_set_.back();
+      const auto *leaf = leaf_guard.As<LeafPage>();
+      if (!leaf->Covers(key, comparator_) || !IsSafe(leaf, Operation::INSERT, key)) {
+        ctx.ReleaseAll();
+      }
+    }
+    if (ctx.write_set_.empty() && !FindLeafPageForWrite(key, Operation::INSERT, &ctx)) {
+      StartNewTree(key, value);
+      ctx.ReleaseAll();
+      inserted++;
+      continue;
+    }
+    inserted += InsertIntoLeaf(key, value, &ctx) ? 1 : 0;
+    // Only a leaf that did not split, and is all that is latched, is kept for the next key.
+    if (ctx.root_latch_ != nullptr || ctx.write_set_.size() != 1) {
+      ctx.ReleaseAll();
+      continue;
+    }
+    WritePageGuard &guard = ctx.write_set_.back();
+    if (!guard.As<BPlusTreePage>()->IsLeafPage()) {
+      ctx.ReleaseAll();
+    }
+  }
+  return inserted;
+}
+
+/*
+ * Insert key & value pair into the leaf that is the last page of ctx, see
+ * Insert, and split it if necessary.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value, Context *ctx) {
+  // Look through the leaf page to see whether the key exists. If it does, return immediately, otherwise insert the
+  // entry, and split the leaf once it is full. If the key does not fit into the page, split the leaf first, and insert
+  // the entry into the half it belongs to.
+  WritePageGuard &leaf_guard = ctx->write_set_.back();
+  ValueType existing_value;
+  if (leaf_guard.As<LeafPage>()->Lookup(key, &existing_value, comparator_)) {
+    return !unique_keys_ && InsertDuplicate(leaf_guard.AsMut<LeafPage>(), key, existing_value, value);
+  }
+  auto *leaf = leaf_guard.AsMut<LeafPage>();
+  bool has_room = leaf->HasRoomFor(key);
+  if (has_room) {
+    leaf->Insert(key, value, comparator_);
+    if (leaf->GetSize() < leaf->GetMaxSize()) {
       return true;
+    }
+  }
+  KeyType separator;
+  BasicPageGuard new_leaf_guard = Split(leaf, &separator);
+  auto *new_leaf = new_leaf_guard.AsMut<LeafPage>();
+  if (!has_room) {
+    (comparator_(key, separator) < 0 ? leaf : new_leaf)->Insert(key, value, comparator_);
   }
-  return InsertIntoLeaf(key, value, transaction);
+  InsertIntoParent(leaf, separator, new_leaf, ctx);
+  return true;
+}
+
+/*
+ * Add value to a key of a non-unique tree that is in leaf already, with
+ * existing_value: either a single record id, or the reference to the posting
+ * list of the key. The entry keeps its size in the leaf.
+ * @return : false if the key has this value already
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::InsertDuplicate(LeafPage *leaf, const KeyType &key, const ValueType &existing_value,
+                                     const ValueType &value) {
+  if (PostingList::IsReference(existing_value)) {
+    return PostingList::Insert(buffer_pool_manager_, existing_value, value);
+  }
+  if (existing_value == value) {
+    return false;
+  }
+  std::vector<ValueType> values{existing_value, value};
+  leaf->SetValueAt(leaf->KeyIndex(key, comparator_), PostingList::Create(buffer_pool_manager_, &values));
+  return true;
 }
 
 /*
@@ -93,73 +240,18 @@ bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
  * tree's root page id and insert entry directly into leaf page.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value, Transaction* transaction) {
-  assert(IsEmpty());
-  auto new_page = buffer_pool_manager_->NewPage(&root_page_id_);
-  if(new_page == nullptr){
+void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
+  page_id_t root_page_id;
+  BasicPageGuard root_guard = buffer_pool_manager_->NewPageGuarded(&root_page_id);
+  if (!root_guard.IsValid()) {
     throw std::bad_alloc();
   }
-  LockPage(new_page, transaction, Operation::INSERT);
-  auto new_page_node = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(new_page->GetData());
+  auto *root = root_guard.AsMut<LeafPage>();
+  root->Init(root_page_id, INVALID_PAGE_ID, leaf_max_size_);
+  root->Insert(key, value, comparator_);
+  root_page_id_ = root_page_id;
+  height_ = 1;
   UpdateRootPageId(true);
-  new_page_node->Init(root_page_id_, INVALID_PAGE_ID, leaf_max_size_);
-  assert(!IsEmpty());
-  new_page_node->Insert(key, value, comparator_);
-  new_page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(new_page->GetPageId(), true);
-  transaction->GetPageSet()->pop_front();
-}
-
-/*
- * Insert constant key & value pair into leaf page
- * You should first find the right leaf page as insertion target, then look
- * through leaf page to see whether insert key exists or not. If it exists, return
- * immdiately, otherwise insert entry. Remember to deal with a split if necessary.
- * @return: since we only support unique keys, if user tries to insert duplicate
- * keys return false, otherwise return true.
- */
-INDEX_TEMPLATE_ARGUMENTS
-bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction) {
-  auto leaf_page = FindLeafPage(key, false, transaction, Operation::INSERT);
-  auto leaf_node = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(leaf_page->GetData());
-  // check if key exists
-  ValueType temp_value;
-  if(leaf_node->Lookup(key, &temp_value, comparator_)){
-    UnlockParentPage(leaf_page, transaction, Operation::INSERT);
-    UnlockPage(leaf_page, transaction, Operation::INSERT);
-    return false;
-  }else{
-    if(leaf_node->GetSize() < leaf_node->GetMaxSize()){
-      leaf_node->Insert(key, value, comparator_);
-
-      UnlockPage(leaf_page, transaction, Operation::INSERT);
-      if(transaction != nullptr){
-        assert(transaction->GetPageSet()->empty());
-      }
-    }else{
-      auto new_leaf_node = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(Split(leaf_node)); 
-      assert(new_leaf_node->IsLeafPage()); 
-      new_leaf_node->SetNextPageId(leaf_node->GetNextPageId());
-      leaf_node->SetNextPageId(new_leaf_node->GetPageId());
-      new_leaf_node->SetParentPageId(leaf_node->GetParentPageId());
-      KeyType middle_one = new_leaf_node->KeyAt(0);
-      
-      InsertIntoParent(leaf_node, middle_one, new_leaf_node, transaction);
-
-      // Split the right half to new node
-      if(comparator_(key, middle_one) < 0){
-          leaf_node->Insert(key, value, comparator_);
-      }else{
-          new_leaf_node->Insert(key, value, comparator_);
-      }
-      
-      UnlockParentPage(leaf_page, transaction, Operation::INSERT);
-      UnlockPage(leaf_page, transaction, Operation::INSERT);
-      if(transaction != nullptr)
-          assert(transaction->GetPageSet()->empty());
-    }
-    return true;
-  }
 }
 
 /*
@@ -168,88 +260,319 @@ bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value,
  * User needs to first ask for new page from buffer pool manager (NOTICE: throw
  * an std::bad_alloc exception if returned value is nullptr), then move half
  * of key & value pairs from input page to newly created page
+ * The new page becomes the right sibling of the input page: it takes over
+ * the right link and high key of the input page, whose high key becomes the
+ * separator of the two.
+ * @param[out] separator: the key to insert into the parent along with the new page
+ * @return: the guard of the new page
  */
 INDEX_TEMPLATE_ARGUMENTS
-BPlusTreePage *BPLUSTREE_TYPE::Split(BPlusTreePage *node) { 
-  page_id_t new_page_id; // place holder
-  auto new_page = buffer_pool_manager_->NewPage(&new_page_id);
-  if(new_page == nullptr){
-     throw std::bad_alloc();
+BasicPageGuard BPLUSTREE_TYPE::Split(BPlusTreePage *node, KeyType *separator) {
+  page_id_t new_page_id;
+  BasicPageGuard new_guard = buffer_pool_manager_->NewPageGuarded(&new_page_id);
+  if (!new_guard.IsValid()) {
+    throw std::bad_alloc();
   }
-  //auto new_node = reinterpret_cast<BPlusTreePage *>(new_page->GetData());
-  BPlusTreePage *new_node_page = reinterpret_cast<BPlusTreePage *>(new_page->GetData());
   if (node->IsLeafPage()) {
-    // leaf page split
-    LeafPage *leaf = reinterpret_cast<LeafPage *>(node);
-    LeafPage *new_leaf = reinterpret_cast<LeafPage *>(new_node_page);
-    new_leaf->Init(new_page_id, INVALID_PAGE_ID, leaf_max_size_);
-    new_leaf->SetNextPageId(leaf->GetNextPageId());
-    leaf->SetNextPageId(new_leaf->GetPageId());
+    auto *leaf = reinterpret_cast<LeafPage *>(node);
+    auto *new_leaf = new_guard.AsMut<LeafPage>();
+    new_leaf->Init(new_page_id, leaf->GetParentPageId(), leaf_max_size_);
     leaf->MoveHalfTo(new_leaf);
-    return new_leaf;
-    } else {
-      // internal page split
-    InternalPage *internal = reinterpret_cast<InternalPage *>(node);
-    InternalPage *new_internal = reinterpret_cast<InternalPage *>(new_node_page);
-    new_internal->Init(new_page_id, INVALID_PAGE_ID, internal_max_size_);
-    internal->MoveHalfTo(new_internal, buffer_pool_manager_);
-    return new_internal;
+    *separator = ShortSeparator(leaf->KeyAt(leaf->GetSize() - 1), new_leaf->KeyAt(0));
+    new_leaf->SetHighKey(leaf->GetHighKey());
+    new_leaf->SetLowKey(*separator);
+    leaf->SetHighKey(*separator);
+  } else {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    auto *new_internal = new_guard.AsMut<InternalPage>();
+    new_internal->Init(new_page_id, internal->GetParentPageId(), internal_max_size_);
+    internal->MoveHalfTo(new_internal, b_link_ ? nullptr : buffer_pool_manager_);
+    // the first key of the new page separates it from the input page
+    *separator = new_internal->KeyAt(0);
+    new_internal->SetHighKey(internal->GetHighKey());
+    internal->SetHighKey(*separator);
+  }
+  // the new page must be linked in last: a B-link reader may follow the link as soon as it is set
+  auto *new_node = new_guard.AsMut<BPlusTreePage>();
+  new_node->SetNextPageId(node->GetNextPageId());
+  if (node->IsLeafPage()) {
+    new_guard.AsMut<LeafPage>()->SetPrevPageId(node->GetPageId());
+    LinkPrev(node->GetNextPageId(), new_page_id);
+  }
+  node->SetNextPageId(new_page_id);
+  return new_guard;
+}
+
+/*
+ * Point the prev link of leaf page_id, unless it is INVALID_PAGE_ID, to
+ * prev_page_id. The caller holds the leaf to the left of page_id latched.
+ * Writers only latch a leaf to the left of one they hold while they also
+ * hold the parent of both, which the caller then holds as well, so this
+ * cannot deadlock.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::LinkPrev(page_id_t page_id, page_id_t prev_page_id) {
+  if (page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  WritePageGuard guard = buffer_pool_manager_->FetchPageWrite(page_id);
+  guard.AsMut<LeafPage>()->SetPrevPageId(prev_page_id);
+}
+
+/*
+ * Suffix truncation: the separator of two adjacent leaves only needs to tell the last key of the left one from the
+ * first key of the right one. Zero as many trailing bytes of right as possible, which the pages do not store.
+ * @return a key k with left < k <= right
+ */
+INDEX_TEMPLATE_ARGUMENTS
+KeyType BPLUSTREE_TYPE::ShortSeparator(const KeyType &left, const KeyType &right) const {
+  int key_size = sizeof(KeyType);
+  for (int size = TruncationOffset(comparator_); size < key_size; size++) {
+    KeyType separator = right;
+    memset(reinterpret_cast<char *>(&separator) + size, 0, key_size - size);
+    if (comparator_(left, separator) < 0 && comparator_(separator, right) <= 0) {
+      return separator;
+    }
   }
- }
+  return right;
+}
 
 /*
  * Insert key & value pair into internal page after split
  * @param   old_node      input page from split() method
  * @param   key
  * @param   new_node      returned page from split() method
+ * @param   ctx           the pages latched on the way down; the last one is old_node
  * You first needs to find the parent page of old_node, parent node must be
  * adjusted to take info of new_node into account. Remember to recursively
  * insert in parent if necessary.
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
-                                      Transaction *transaction) {
-    if (old_node->IsRootPage()) {
-      auto newPage = buffer_pool_manager_->NewPage(&root_page_id_);
-      if(newPage == nullptr){
-            throw std::bad_alloc();
-        }
-      newPage->WLatch();
-      transaction->GetPageSet()->push_front(newPage);
-      InternalPage *newRoot = reinterpret_cast<InternalPage *>(newPage);
-      newRoot->Init(root_page_id_, INVALID_PAGE_ID, internal_max_size_);
-      newRoot->PopulateNewRoot(old_node->GetPageId(),key,new_node->GetPageId());
-      old_node->SetParentPageId(root_page_id_);
-      new_node->SetParentPageId(root_page_id_);
-      UpdateRootPageId(false);
-      //fetch page and new page need to unpin page
-      //buffer_pool_manager_->UnpinPage(new_node->GetPageId(), true);
-      //buffer_pool_manager_->UnpinPage(newRoot->GetPageId(), true);
+                                      Context *ctx) {
+  // Keep old_node latched until we are done with it, but make its parent the last page of the context.
+  WritePageGuard old_guard = std::move(ctx->write_set_.back());
+  ctx->write_set_.pop_back();
+
+  if (old_node->IsRootPage()) {
+    page_id_t root_page_id;
+    BasicPageGuard root_guard = buffer_pool_manager_->NewPageGuarded(&root_page_id);
+    if (!root_guard.IsValid()) {
+      throw std::bad_alloc();
+    }
+    auto *root = root_guard.AsMut<InternalPage>();
+    root->Init(root_page_id, INVALID_PAGE_ID, internal_max_size_);
+    root->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId());
+    old_node->SetParentPageId(root_page_id);
+    new_node->SetParentPageId(root_page_id);
+    root_page_id_ = root_page_id;
+    height_++;
+    UpdateRootPageId(false);
+    return;
+  }
+
+  // The parent was not safe when we passed it, so it is still latched. As with leaves, a parent that has no room for
+  // the key is split first.
+  WritePageGuard &parent_guard = ctx->write_set_.back();
+  auto *parent = parent_guard.AsMut<InternalPage>();
+  if (parent->HasRoomFor(key)) {
+    parent->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
+    new_node->SetParentPageId(parent->GetPageId());
+    if (parent->GetSize() <= parent->GetMaxSize()) {
       return;
-    }else{
-      auto newPage = buffer_pool_manager_->FetchPage(old_node->GetParentPageId());
-      if(newPage==nullptr){
-          throw std::bad_alloc();
-      }
-      auto parent = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *>(newPage->GetData());
-      if(parent->GetSize() < parent->GetMaxSize()){
-        parent->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
-      }else{
-        auto new_internal = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *>(Split(parent));
-        new_internal->SetParentPageId(parent->GetParentPageId());
-        KeyType mid_one = new_internal->KeyAt(0);
-        if(comparator_(key, mid_one) < 0){
-          parent->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
-          new_node->SetParentPageId(parent->GetPageId());
-        }else{
-          new_internal->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
-          new_node->SetParentPageId(new_internal->GetPageId());
-        }
-        InsertIntoParent(parent, mid_one, new_internal, transaction);
+    }
+    KeyType separator;
+    BasicPageGuard new_parent_guard = Split(parent, &separator);
+    InsertIntoParent(parent, separator, new_parent_guard.AsMut<InternalPage>(), ctx);
+    return;
+  }
+  KeyType separator;
+  BasicPageGuard new_parent_guard = Split(parent, &separator);
+  auto *new_parent = new_parent_guard.AsMut<InternalPage>();
+  // Split has moved old_node to new_parent if it is not in parent anymore.
+  auto *old_parent = parent->ValueIndex(old_node->GetPageId()) != -1 ? parent : new_parent;
+  old_parent->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
+  new_node->SetParentPageId(old_parent->GetPageId());
+  InsertIntoParent(parent, separator, new_parent, ctx);
+}
+
+/*****************************************************************************
+ * BULK LOADING
+ *****************************************************************************/
+namespace {
+
+/*
+ * Cut a stream of entries into pages of page_size entries each, or fewer if they do not fit into a page, except for
+ * the last two pages, which share their entries if the last one would otherwise hold fewer than min_size. next(&entry)
+ * reads the next entry and returns false at the end of the stream; fit(items, size) returns how many of the leading
+ * size items fit into a page; emit(items, size) writes a page. A page_size of at least min_size and a max_size of at
+ * least 2 * min_size - 1 make every page but a single one hold between min_size and max_size entries, unless the
+ * entries do not fit.
+ */
+template <class Entry, class NextFunction, class FitFunction, class EmitFunction>
+void PackPages(NextFunction next, int page_size, int min_size, int max_size, FitFunction fit, EmitFunction emit) {
+  // Only write a page once enough entries follow it to fill the last page.
+  std::vector<Entry> pending;
+  Entry entry;
+  while (next(&entry)) {
+    pending.push_back(entry);
+    if (static_cast<int>(pending.size()) == page_size + min_size) {
+      int size = fit(pending.data(), page_size);
+      emit(pending.data(), size);
+      pending.erase(pending.begin(), pending.begin() + size);
+    }
+  }
+  const Entry *items = pending.data();
+  int remaining = static_cast<int>(pending.size());
+  while (remaining > 0) {
+    int size = fit(items, std::min(remaining, max_size));
+    if (size < remaining && remaining - size < min_size) {
+      size = std::min(size, remaining - remaining / 2);
+    }
+    emit(items, size);
+    items += size;
+    remaining -= size;
+  }
+}
+
+}  // namespace
+
+/*
+ * Build the tree bottom-up from the sorted entries of sorter: first the leaves, then one internal level after the
+ * other, until a level consists of a single page, which becomes the root. Holds the root latch throughout, so that
+ * concurrent operations wait for the tree to be complete.
+ * @return false, without loading anything, if the tree is not empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::BulkLoad(ExternalSorter<KeyType, ValueType, KeyComparator> *sorter, double fill_factor,
+                              Transaction *transaction) {
+  Context ctx;
+  ctx.LockRoot(&root_latch_);
+  if (!IsEmpty()) {
+    return false;
+  }
+  // the separator key and the page id of every page of the level built last
+  std::vector<std::pair<KeyType, page_id_t>> level;
+  BulkLoadLeaves(sorter, fill_factor, &level);
+  if (level.empty()) {
+    return true;
+  }
+  height_ = 1;
+  while (level.size() > 1) {
+    BulkLoadInternalLevel(fill_factor, &level);
+    height_++;
+  }
+  root_page_id_ = level[0].second;
+  UpdateRootPageId(true);
+  return true;
+}
+
+/*
+ * @return the number of entries to put into each page of a level, for pages that hold between min_size and max_size
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int BPLUSTREE_TYPE::BulkLoadPageSize(double fill_factor, int min_size, int max_size) const {
+  auto page_size = static_cast<int>(fill_factor * max_size + 0.5);
+  return std::clamp(page_size, std::max(min_size, 1), max_size);
+}
+
+/*
+ * Pack the entries of sorter into new leaves, which are linked in key order, and append the page id of every leaf to
+ * level, along with its separator from the previous leaf, see ShortSeparator.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BulkLoadLeaves(ExternalSorter<KeyType, ValueType, KeyComparator> *sorter, double fill_factor,
+                                    std::vector<std::pair<KeyType, page_id_t>> *level) {
+  // A leaf splits as soon as it is full, so it holds at most leaf_max_size_ - 1 entries.
+  int max_size = leaf_max_size_ - 1;
+  int min_size = leaf_max_size_ / 2;
+  BasicPageGuard prev_guard;
+  KeyType prev_last_key;
+  auto emit = [&](const MappingType *items, int size) {
+    page_id_t page_id;
+    BasicPageGuard guard = buffer_pool_manager_->NewPageGuarded(&page_id);
+    if (!guard.IsValid()) {
+      throw std::bad_alloc();
+    }
+    auto *leaf = guard.AsMut<LeafPage>();
+    leaf->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+    leaf->AppendSorted(items, size);
+    if (prev_guard.IsValid()) {
+      KeyType separator = ShortSeparator(prev_last_key, items[0].first);
+      leaf->SetPrevPageId(prev_guard.PageId());
+      leaf->SetLowKey(separator);
+      prev_guard.AsMut<LeafPage>()->SetNextPageId(page_id);
+      prev_guard.AsMut<LeafPage>()->SetHighKey(separator);
+      level->emplace_back(separator, page_id);
+    } else {
+      level->emplace_back(items[0].first, page_id);
+    }
+    prev_guard = std::move(guard);
+    prev_last_key = items[size - 1].first;
+  };
+  // Read one entry ahead, to gather the values of a key into a posting list in a non-unique tree. A unique tree keeps
+  // the first value of a key only.
+  MappingType lookahead;
+  bool has_lookahead = sorter->Next(&lookahead);
+  std::vector<ValueType> values;
+  auto next = [&](MappingType *entry) {
+    if (!has_lookahead) {
+      return false;
+    }
+    *entry = lookahead;
+    values.assign(1, entry->second);
+    while ((has_lookahead = sorter->Next(&lookahead)) && comparator_(lookahead.first, entry->first) == 0) {
+      if (!unique_keys_) {
+        values.push_back(lookahead.second);
       }
-      buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
     }
-    buffer_pool_manager_->UnpinPage(new_node->GetPageId(), true);
+    if (values.size() > 1) {
+      entry->second = PostingList::Create(buffer_pool_manager_, &values);
+    }
+    return true;
+  };
+  PackPages<MappingType>(next, BulkLoadPageSize(fill_factor, min_size, max_size), min_size, max_size,
+                         &LeafPage::FitCount, emit);
+}
+
+/*
+ * Build the internal level above the pages in level, which are linked like the leaves, and replace level with the
+ * first key and page id of every new page. The first key of a page is kept in its otherwise unused first slot, as Split
+ * does.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BulkLoadInternalLevel(double fill_factor, std::vector<std::pair<KeyType, page_id_t>> *level) {
+  int max_size = internal_max_size_;
+  int min_size = (internal_max_size_ + 1) / 2;
+  std::vector<std::pair<KeyType, page_id_t>> parents;
+  BasicPageGuard prev_guard;
+  auto emit = [&](const std::pair<KeyType, page_id_t> *items, int size) {
+    page_id_t page_id;
+    BasicPageGuard guard = buffer_pool_manager_->NewPageGuarded(&page_id);
+    if (!guard.IsValid()) {
+      throw std::bad_alloc();
+    }
+    auto *internal = guard.AsMut<InternalPage>();
+    internal->Init(page_id, INVALID_PAGE_ID, internal_max_size_);
+    internal->AppendSorted(items, size, buffer_pool_manager_);
+    if (prev_guard.IsValid()) {
+      prev_guard.AsMut<InternalPage>()->SetNextPageId(page_id);
+      prev_guard.AsMut<InternalPage>()->SetHighKey(items[0].first);
+    }
+    prev_guard = std::move(guard);
+    parents.emplace_back(items[0].first, page_id);
+  };
+  size_t next = 0;
+  PackPages<std::pair<KeyType, page_id_t>>(
+      [level, &next](std::pair<KeyType, page_id_t> *entry) {
+        if (next == level->size()) {
+          return false;
+        }
+        *entry = (*level)[next++];
+        return true;
+      },
+      BulkLoadPageSize(fill_factor, min_size, max_size), min_size, max_size, &InternalPage::FitCount, emit);
+  *level = std::move(parents);
 }
 
 /*****************************************************************************
@@ -262,44 +585,175 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
  * delete entry from leaf page.
  * Remember to call CoalesceOrRedistribute if necessary.
  * @param key                  the key to remove
- * @param transaction          the current Transaction object, use to record pages
- *                             you latch, and pages that should be deleted.
- *                             This method should unlatch and delete before returning.
+ * @param transaction          the current Transaction object
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  RemoveEntry(key, nullptr);
+}
+
+/*
+ * Delete the key & value pair, and leave the other values of the key in a
+ * non-unique tree. A unique tree only removes the key if it has this value.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Remove(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  RemoveEntry(key, &value);
+}
+
+/*
+ * Delete key with all of its values, or only value if it is not nullptr.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {}
+void BPLUSTREE_TYPE::RemoveEntry(const KeyType &key, const ValueType *value) {
+  if (b_link_) {
+    BLinkRemove(key, value);
+    return;
+  }
+  Context ctx;
+  if (!FindLeafPageForWrite(key, Operation::DELETE, &ctx)) {
+    return;
+  }
+  WritePageGuard &leaf_guard = ctx.write_set_.back();
+  ValueType existing_value;
+  if (!leaf_guard.As<LeafPage>()->Lookup(key, &existing_value, comparator_)) {
+    return;
+  }
+  auto *leaf = leaf_guard.AsMut<LeafPage>();
+  if (RemoveFromLeaf(leaf, key, existing_value, value)) {
+    CoalesceOrRedistribute(leaf, &ctx);
+  }
+}
 
 /*
- * You first need to find the sibling of input page. If sibling's size + input
- * page's size > page's max size, then redistribute. Otherwise, coalesce.
+ * Delete key, which is in leaf with existing_value, or only value of it if
+ * value is not nullptr. A key with a posting list only leaves the leaf with
+ * its last value.
+ * @return : true if the entry of key was removed from leaf
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::RemoveFromLeaf(LeafPage *leaf, const KeyType &key, ValueType existing_value,
+                                    const ValueType *value) {
+  if (!unique_keys_ && PostingList::IsReference(existing_value)) {
+    if (value == nullptr) {
+      PostingList::Delete(buffer_pool_manager_, existing_value);
+    } else {
+      if (PostingList::Remove(buffer_pool_manager_, &existing_value, *value)) {
+        leaf->SetValueAt(leaf->KeyIndex(key, comparator_), existing_value);
+      }
+      return false;
+    }
+  } else if (value != nullptr && !(existing_value == *value)) {
+    return false;
+  }
+  leaf->Remove(key, comparator_);
+  return true;
+}
+
+/*
+ * You first need to find the sibling of input page. If the entries of both
+ * pages fit into one, coalesce. Otherwise, redistribute. Since keys compress
+ * differently, neither may be possible, in which case the page stays underfull.
  * Using template BPlusTreePage to represent either internal page or leaf page.
  * @param node                 the node that had a key removed
- * @param transaction          the current Transaction object, use to record pages for deletion
+ * @param ctx                  the pages latched on the way down; the last one is node
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::CoalesceOrRedistribute(BPlusTreePage *node, Context *ctx) {
+  if (node->IsRootPage()) {
+    AdjustRoot(node, ctx);
+    return;
+  }
+  if (!IsUnderfull(node)) {
+    return;
+  }
+
+  // Keep node latched until we are done with it, but make its parent the last page of the context. The parent was not
+  // safe when we passed it, so it is still latched, and so no other writer can be working on the sibling.
+  WritePageGuard node_guard = std::move(ctx->write_set_.back());
+  ctx->write_set_.pop_back();
+  WritePageGuard &parent_guard = ctx->write_set_.back();
+  auto *parent = parent_guard.AsMut<InternalPage>();
+  if (parent->GetSize() < 2) {
+    // an underfull parent may be left with a single child, which has no sibling
+    return;
+  }
+  int index = parent->ValueIndex(node->GetPageId());
+  // The sibling is the left neighbor, unless node is the leftmost child.
+  int sibling_index = index == 0 ? 1 : index - 1;
+  WritePageGuard sibling_guard = buffer_pool_manager_->FetchPageWrite(parent->ValueAt(sibling_index));
+  auto *sibling = sibling_guard.AsMut<BPlusTreePage>();
+
+  // Always move the right one of the two into the left one.
+  if (!CanCoalesce(index == 0 ? node : sibling, index == 0 ? sibling : node, parent, index == 0 ? 1 : index)) {
+    Redistribute(sibling, node, parent, index);
+    return;
+  }
+
+  page_id_t deleted_page_id;
+  if (index == 0) {
+    Coalesce(node, sibling, parent, sibling_index);
+    deleted_page_id = sibling->GetPageId();
+    sibling_guard.Drop();
+  } else {
+    Coalesce(sibling, node, parent, index);
+    deleted_page_id = node->GetPageId();
+    node_guard.Drop();
+  }
+  buffer_pool_manager_->DeletePage(deleted_page_id);
+  CoalesceOrRedistribute(parent, ctx);
+}
+
+/*
+ * @return : true if the entries of node fit into neighbor_node, see Coalesce
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::CoalesceOrRedistribute(BPlusTreePage *node, Transaction *transaction) {}
+bool BPLUSTREE_TYPE::CanCoalesce(const BPlusTreePage *neighbor_node, const BPlusTreePage *node,
+                                 const InternalPage *parent, int index) const {
+  if (node->IsLeafPage()) {
+    return reinterpret_cast<const LeafPage *>(neighbor_node)->CanAbsorb(reinterpret_cast<const LeafPage *>(node));
+  }
+  return reinterpret_cast<const InternalPage *>(neighbor_node)
+      ->CanAbsorb(reinterpret_cast<const InternalPage *>(node), parent->KeyAt(index));
+}
 
 /*
- * Move all the key & value pairs from one page to its sibling page, and notify
- * buffer pool manager to delete this page. Parent page must be adjusted to
- * take info of deletion into account. Remember to deal with coalesce or
- * redistribute recursively if necessary.
+ * @return : true if node holds so few entries that it should be coalesced or redistributed
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::IsUnderfull(const BPlusTreePage *node) const {
+  return node->IsLeafPage() ? reinterpret_cast<const LeafPage *>(node)->IsUnderfull()
+                            : reinterpret_cast<const InternalPage *>(node)->IsUnderfull();
+}
+
+/*
+ * Move all the key & value pairs from one page to its sibling page. Parent page must be adjusted to take info of
+ * deletion into account; the caller deletes the emptied page and deals with coalesce or redistribute of the parent.
  * Using template N to represent either internal page or leaf page.
- * @param   neighbor_node      sibling page of input "node"
- * @param   node               input from method CoalesceOrRedistribute()
+ * @param   neighbor_node      left sibling page of input "node"
+ * @param   node               the page that is emptied into neighbor_node
  * @param   parent             parent page of input "node"
  * @param   index              index of pointer to "node" within "parent"
- * @param   transaction        the current Transaction object, use to record pages for deletion
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::Coalesce(BPlusTreePage *sibling, BPlusTreePage *node, InternalPage *parent, int index,
-                              Transaction *transaction) {}
+void BPLUSTREE_TYPE::Coalesce(BPlusTreePage *neighbor_node, BPlusTreePage *node, InternalPage *parent, int index) {
+  if (node->IsLeafPage()) {
+    reinterpret_cast<LeafPage *>(node)->MoveAllTo(reinterpret_cast<LeafPage *>(neighbor_node));
+    LinkPrev(neighbor_node->GetNextPageId(), neighbor_node->GetPageId());
+  } else {
+    reinterpret_cast<InternalPage *>(node)->MoveAllTo(reinterpret_cast<InternalPage *>(neighbor_node),
+                                                      parent->KeyAt(index), buffer_pool_manager_);
+  }
+  parent->Remove(index);
+}
 
 /*
  * Redistribute key & value pairs from one page to its sibling page. If index ==
  * 0, move sibling page's first key & value pair into end of input "node",
  * otherwise move sibling page's last key & value pair to the front of input
  * "node".
+ * Nothing is moved if the sibling would be emptied, or if the moved entry or
+ * the new separator key do not fit; node then stays underfull.
  * Using template N to represent either internal page or leaf page.
  * @param   sibling            sibling page of input "node"
  * @param   node               input from method CoalesceOrRedistribute()
@@ -307,7 +761,46 @@ void BPLUSTREE_TYPE::Coalesce(BPlusTreePage *sibling, BPlusTreePage *node, Inter
  * @param   index              index of pointer to "node" within "parent"
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::Redistribute(BPlusTreePage *sibling, BPlusTreePage *node, InternalPage *parent, int index) {}
+void BPLUSTREE_TYPE::Redistribute(BPlusTreePage *sibling, BPlusTreePage *node, InternalPage *parent, int index) {
+  if (sibling->GetSize() < 2) {
+    return;
+  }
+  // the entry that moves, and the key that replaces its separator in the parent
+  int moved_index = index == 0 ? 0 : sibling->GetSize() - 1;
+  int separator_index = index == 0 ? 1 : index;
+  if (node->IsLeafPage()) {
+    auto *leaf = reinterpret_cast<LeafPage *>(node);
+    auto *sibling_leaf = reinterpret_cast<LeafPage *>(sibling);
+    // the moved entry and its neighbor in the sibling end up on either side of the separator
+    int left_index = index == 0 ? 0 : moved_index - 1;
+    KeyType new_separator = ShortSeparator(sibling_leaf->KeyAt(left_index), sibling_leaf->KeyAt(left_index + 1));
+    if (!leaf->HasRoomFor(sibling_leaf->KeyAt(moved_index)) || !parent->CanSetKeyAt(separator_index, new_separator)) {
+      return;
+    }
+    if (index == 0) {
+      sibling_leaf->MoveFirstToEndOf(leaf);
+    } else {
+      sibling_leaf->MoveLastToFrontOf(leaf);
+    }
+    parent->SetKeyAt(separator_index, new_separator);
+    (index == 0 ? leaf : sibling_leaf)->SetHighKey(new_separator);
+    (index == 0 ? sibling_leaf : leaf)->SetLowKey(new_separator);
+  } else {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    auto *sibling_internal = reinterpret_cast<InternalPage *>(sibling);
+    KeyType new_separator = sibling_internal->KeyAt(index == 0 ? 1 : moved_index);
+    if (!internal->HasRoomForAny() || !parent->CanSetKeyAt(separator_index, new_separator)) {
+      return;
+    }
+    if (index == 0) {
+      sibling_internal->MoveFirstToEndOf(internal, parent->KeyAt(1), buffer_pool_manager_);
+    } else {
+      sibling_internal->MoveLastToFrontOf(internal, parent->KeyAt(index), buffer_pool_manager_);
+    }
+    parent->SetKeyAt(separator_index, new_separator);
+    (index == 0 ? internal : sibling_internal)->SetHighKey(new_separator);
+  }
+}
 
 /*
  * Update root page if necessary
@@ -316,11 +809,238 @@ void BPLUSTREE_TYPE::Redistribute(BPlusTreePage *sibling, BPlusTreePage *node, I
  * case 1: when you delete the last element in root page, but root page still
  * has one last child
  * case 2: when you delete the last element in whole b+ tree
- * @return : true means root page should be deleted, false means no deletion
- * happend
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) {}
+void BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node, Context *ctx) {
+  page_id_t new_root_page_id;
+  if (!old_root_node->IsLeafPage() && old_root_node->GetSize() == 1) {
+    new_root_page_id = reinterpret_cast<InternalPage *>(old_root_node)->ValueAt(0);
+    BasicPageGuard new_root_guard = buffer_pool_manager_->FetchPageBasic(new_root_page_id);
+    new_root_guard.AsMut<BPlusTreePage>()->SetParentPageId(INVALID_PAGE_ID);
+  } else if (old_root_node->IsLeafPage() && old_root_node->GetSize() == 0) {
+    new_root_page_id = INVALID_PAGE_ID;
+  } else {
+    return;
+  }
+  // The root was not safe, so root_latch_ is still held.
+  page_id_t old_root_page_id = old_root_node->GetPageId();
+  root_page_id_ = new_root_page_id;
+  height_--;
+  UpdateRootPageId(false);
+  ctx->write_set_.pop_back();
+  buffer_pool_manager_->DeletePage(old_root_page_id);
+}
+
+/*****************************************************************************
+ * B-LINK MODE
+ *****************************************************************************/
+/*
+ * In B-link mode (Lehman and Yao), every operation holds at most one page
+ * latch on its way down, and a split at most two, the split page and its
+ * parent. A page that has been split after its parent was read no longer
+ * covers all keys the parent sent there; they are found by following the
+ * right links, MoveRight. Parent page ids are not maintained; a split
+ * remembers the pages it came down through instead. Pages are never merged:
+ * a remove only deletes the entry from its leaf.
+ */
+
+/*
+ * Descend from the root to the page at level, where the leaves are at level
+ * 0, that covers key (or to the left most page, if leftMost flag == true).
+ * @param[out] path   the pages passed above level, from the top down
+ * @return : the page id, or INVALID_PAGE_ID if the tree is empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t BPLUSTREE_TYPE::BLinkDescend(const KeyType &key, int level, bool leftMost, std::vector<page_id_t> *path) {
+  root_latch_.RLock();
+  page_id_t page_id = root_page_id_;
+  int page_level = height_ - 1;
+  root_latch_.RUnlock();
+  if (page_id == INVALID_PAGE_ID) {
+    return INVALID_PAGE_ID;
+  }
+  // Levels are counted from the leaves, so they stay the same when the tree grows.
+  for (; page_level > level; page_level--) {
+    ReadPageGuard guard = buffer_pool_manager_->FetchPageRead(page_id);
+    if (!leftMost) {
+      MoveRight(&guard, key);
+    }
+    path->push_back(guard.PageId());
+    auto *internal = guard.As<InternalPage>();
+    page_id = leftMost ? internal->ValueAt(0) : internal->Lookup(key, comparator_);
+  }
+  return page_id;
+}
+
+/*
+ * Follow the right links from the page in guard while key is not smaller than
+ * the high key of the page. The right sibling is latched before the page is
+ * released.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+template <class Guard>
+void BPLUSTREE_TYPE::MoveRight(Guard *guard, const KeyType &key) {
+  while (true) {
+    const auto *node = guard->template As<BPlusTreePage>();
+    bool beyond = node->IsLeafPage() ? reinterpret_cast<const LeafPage *>(node)->IsBeyondHighKey(key, comparator_)
+                                     : reinterpret_cast<const InternalPage *>(node)->IsBeyondHighKey(key, comparator_);
+    if (!beyond) {
+      return;
+    }
+    if constexpr (std::is_same_v<Guard, ReadPageGuard>) {
+      *guard = buffer_pool_manager_->FetchPageRead(node->GetNextPageId());
+    } else {
+      *guard = buffer_pool_manager_->FetchPageWrite(node->GetNextPageId());
+    }
+  }
+}
+
+/*
+ * FindLeafPage in B-link mode.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+ReadPageGuard BPLUSTREE_TYPE::BLinkFindLeafPage(const KeyType &key, bool leftMost) {
+  std::vector<page_id_t> path;
+  page_id_t leaf_page_id = BLinkDescend(key, 0, leftMost, &path);
+  if (leaf_page_id == INVALID_PAGE_ID) {
+    return ReadPageGuard();
+  }
+  ReadPageGuard guard = buffer_pool_manager_->FetchPageRead(leaf_page_id);
+  if (!leftMost) {
+    MoveRight(&guard, key);
+  }
+  return guard;
+}
+
+/*
+ * Insert in B-link mode: latch only the leaf, and split it like Insert does.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::BLinkInsert(const KeyType &key, const ValueType &value) {
+  std::vector<page_id_t> path;
+  page_id_t leaf_page_id = BLinkDescend(key, 0, false, &path);
+  if (leaf_page_id == INVALID_PAGE_ID) {
+    {
+      Context ctx;
+      ctx.LockRoot(&root_latch_);
+      if (IsEmpty()) {
+        StartNewTree(key, value);
+        return true;
+      }
+    }
+    // another insert has started the tree meanwhile
+    return BLinkInsert(key, value);
+  }
+
+  WritePageGuard leaf_guard = buffer_pool_manager_->FetchPageWrite(leaf_page_id);
+  MoveRight(&leaf_guard, key);
+  ValueType existing_value;
+  if (leaf_guard.As<LeafPage>()->Lookup(key, &existing_value, comparator_)) {
+    return !unique_keys_ && InsertDuplicate(leaf_guard.AsMut<LeafPage>(), key, existing_value, value);
+  }
+  auto *leaf = leaf_guard.AsMut<LeafPage>();
+  bool has_room = leaf->HasRoomFor(key);
+  if (has_room) {
+    leaf->Insert(key, value, comparator_);
+    if (leaf->GetSize() < leaf->GetMaxSize()) {
+      return true;
+    }
+  }
+  KeyType separator;
+  BasicPageGuard new_leaf_guard = Split(leaf, &separator);
+  if (!has_room) {
+    (comparator_(key, separator) < 0 ? leaf : new_leaf_guard.AsMut<LeafPage>())->Insert(key, value, comparator_);
+  }
+  page_id_t new_page_id = new_leaf_guard.PageId();
+  new_leaf_guard.Drop();
+  BLinkInsertIntoParent(&leaf_guard, separator, new_page_id, 0, &path);
+  return true;
+}
+
+/*
+ * InsertIntoParent in B-link mode: insert key & new_page_id after the page in
+ * child_guard, which has just been split, into its parent, and split the
+ * parent in turn if necessary. The parent is latched before the child is
+ * released, so that nobody can split the new page before it is in the parent.
+ * @param   child_guard   the split page at level
+ * @param   path          the pages passed above level, from the top down
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BLinkInsertIntoParent(WritePageGuard *child_guard, KeyType key, page_id_t new_page_id, int level,
+                                           std::vector<page_id_t> *path) {
+  while (true) {
+    page_id_t child_page_id = child_guard->PageId();
+    page_id_t parent_page_id;
+    if (path->empty()) {
+      // The child was the root when we passed it. If it still is, grow the tree, otherwise find its parent from the
+      // new root.
+      root_latch_.WLock();
+      if (root_page_id_ == child_page_id) {
+        page_id_t root_page_id;
+        BasicPageGuard root_guard = buffer_pool_manager_->NewPageGuarded(&root_page_id);
+        if (!root_guard.IsValid()) {
+          root_latch_.WUnlock();
+          throw std::bad_alloc();
+        }
+        auto *root = root_guard.AsMut<InternalPage>();
+        root->Init(root_page_id, INVALID_PAGE_ID, internal_max_size_);
+        root->PopulateNewRoot(child_page_id, key, new_page_id);
+        root_page_id_ = root_page_id;
+        height_++;
+        UpdateRootPageId(false);
+        root_latch_.WUnlock();
+        return;
+      }
+      root_latch_.WUnlock();
+      parent_page_id = BLinkDescend(key, level + 1, false, path);
+    } else {
+      parent_page_id = path->back();
+      path->pop_back();
+    }
+
+    WritePageGuard parent_guard = buffer_pool_manager_->FetchPageWrite(parent_page_id);
+    MoveRight(&parent_guard, key);
+    child_guard->Drop();
+    auto *parent = parent_guard.AsMut<InternalPage>();
+    bool has_room = parent->HasRoomFor(key);
+    if (has_room) {
+      parent->InsertNodeAfter(child_page_id, key, new_page_id);
+      if (parent->GetSize() <= parent->GetMaxSize()) {
+        return;
+      }
+    }
+    KeyType separator;
+    BasicPageGuard new_parent_guard = Split(parent, &separator);
+    if (!has_room) {
+      auto *new_parent = new_parent_guard.AsMut<InternalPage>();
+      (parent->ValueIndex(child_page_id) != -1 ? parent : new_parent)->InsertNodeAfter(child_page_id, key, new_page_id);
+    }
+    new_page_id = new_parent_guard.PageId();
+    new_parent_guard.Drop();
+    *child_guard = std::move(parent_guard);
+    key = separator;
+    level++;
+  }
+}
+
+/*
+ * Remove in B-link mode: delete the entry, or value of it, from its leaf, which may become
+ * underfull or empty, but stays in the tree.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BLinkRemove(const KeyType &key, const ValueType *value) {
+  std::vector<page_id_t> path;
+  page_id_t leaf_page_id = BLinkDescend(key, 0, false, &path);
+  if (leaf_page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  WritePageGuard leaf_guard = buffer_pool_manager_->FetchPageWrite(leaf_page_id);
+  MoveRight(&leaf_guard, key);
+  ValueType existing_value;
+  if (leaf_guard.As<LeafPage>()->Lookup(key, &existing_value, comparator_)) {
+    RemoveFromLeaf(leaf_guard.AsMut<LeafPage>(), key, existing_value, value);
+  }
+}
 
 /*****************************************************************************
  * INDEX ITERATOR
@@ -331,14 +1051,15 @@ void BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) {}
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE BPLUSTREE_TYPE::begin() { 
-  KeyType temp_key; //not used
-  auto leaf_page = FindLeafPage(temp_key, true);
-  auto leaf_node = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(leaf_page->GetData());
-  auto page_id = leaf_node->GetPageId();
-  return INDEXITERATOR_TYPE(page_id, 0, buffer_pool_manager_);
-
- }
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::begin() {
+  KeyType key{};  // not used
+  ReadPageGuard leaf_guard = FindLeafPage(key, true);
+  if (!leaf_guard.IsValid()) {
+    return end();
+  }
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, std::move(leaf_guard), 0, !unique_keys_, &comparator_, nullptr, false,
+                            [this](const KeyType &high_key) { return FindLeafPage(high_key); });
+}
 
 /*
  * Input parameter is low key, find the leaf page that contains the input key
@@ -346,12 +1067,32 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::begin() {
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) { 
-  auto leaf_page = FindLeafPage(key, false);
-  auto leaf_node = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(leaf_page->GetData());
-  int index = leaf_node->KeyIndex(key, comparator_);
-  auto page_id = leaf_node->GetPageId();
-  return INDEXITERATOR_TYPE(page_id, index, buffer_pool_manager_); 
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
+  ReadPageGuard leaf_guard = FindLeafPage(key);
+  if (!leaf_guard.IsValid()) {
+    return end();
+  }
+  int index = leaf_guard.As<LeafPage>()->KeyIndex(key, comparator_);
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, std::move(leaf_guard), index, !unique_keys_, &comparator_, nullptr,
+                            false, [this](const KeyType &high_key) { return FindLeafPage(high_key); });
+}
+
+/*
+ * Input parameters are low key and end key, construct an index iterator that
+ * visits the keys from low key up to, but not including, end key. It ends
+ * without reading the leaves beyond end key, so a bounded range scan only
+ * reads the leaves it returns keys from.
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key, const KeyType &end_key) {
+  ReadPageGuard leaf_guard = FindLeafPage(key);
+  if (!leaf_guard.IsValid()) {
+    return end();
+  }
+  int index = leaf_guard.As<LeafPage>()->KeyIndex(key, comparator_);
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, std::move(leaf_guard), index, !unique_keys_, &comparator_, &end_key,
+                            false, [this](const KeyType &high_key) { return FindLeafPage(high_key); });
 }
 
 /*
@@ -360,14 +1101,136 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE BPLUSTREE_TYPE::end() { 
-  return INDEXITERATOR_TYPE(INT_MAX, INT_MAX, buffer_pool_manager_);
-  // INDEXITERATOR_TYPE end_iterator = begin();
-  // while (!end_iterator.isEnd()) {
-  //   ++end_iterator;
-  // }
-  // return ++end_iterator;
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::end() { return INDEXITERATOR_TYPE(); }
 
+/*
+ * Input parameter is void, construct an index iterator that visits the keys
+ * in descending order, from the last key of the rightmost leaf page
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::RBegin() { return ReverseBegin(nullptr, nullptr); }
+
+/*
+ * Input parameter is high key, construct an index iterator that visits the
+ * keys from high key (or the largest one below it) downwards
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::RBegin(const KeyType &key) { return ReverseBegin(&key, nullptr); }
+
+/*
+ * Input parameters are high key and end key, construct an index iterator that
+ * visits the keys from high key downwards to, but not including, end key,
+ * without reading the leaves below end key
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::RBegin(const KeyType &key, const KeyType &end_key) {
+  return ReverseBegin(&key, &end_key);
+}
+
+/*
+ * Construct a reverse index iterator, see RBegin
+ * @param key        the high key, or nullptr to start at the last key of the tree
+ * @param end_key    the key to end at, or nullptr to visit every key down to the first one
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::ReverseBegin(const KeyType *key, const KeyType *end_key) {
+  ReadPageGuard leaf_guard = key == nullptr ? FindRightmostLeafPage() : FindLeafPage(*key);
+  if (!leaf_guard.IsValid()) {
+    return end();
+  }
+  const auto *leaf = leaf_guard.As<LeafPage>();
+  int index = leaf->GetSize() - 1;
+  if (key != nullptr) {
+    // start at the last key that is not greater than key
+    index = leaf->KeyIndex(*key, comparator_);
+    if (index == leaf->GetSize() || comparator_(leaf->KeyAt(index), *key) != 0) {
+      index--;
+    }
+  }
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, std::move(leaf_guard), index, !unique_keys_, &comparator_, end_key,
+                            true, [this](const KeyType &boundary) { return FindLeafPage(boundary); });
+}
+
+/*****************************************************************************
+ * PARTITIONING
+ *****************************************************************************/
+/*
+ * Split the keys in [key, end_key) into at most parts ranges for a parallel
+ * scan. The separators come from the internal pages: descend level by level
+ * through the pages that overlap the range, collecting the keys between their
+ * children, until a level yields enough keys, and then pick evenly spaced ones
+ * among them. Subtrees on the same level hold about the same number of keys,
+ * so the ranges are of about the same size, without reading any leaf. Only one
+ * page is latched at a time, so the result is a snapshot that concurrent
+ * writers may have changed already; it only affects how even the ranges are.
+ * @return : the separators, in ascending order and within (key, end_key); at
+ * most parts - 1 of them, fewer if the range spans too few pages
+ */
+INDEX_TEMPLATE_ARGUMENTS
+std::vector<KeyType> BPLUSTREE_TYPE::SplitRange(const KeyType &key, const KeyType &end_key, int parts) {
+  std::vector<KeyType> separators;
+  root_latch_.RLock();
+  std::vector<page_id_t> level;
+  if (!IsEmpty()) {
+    level.push_back(root_page_id_);
+  }
+  root_latch_.RUnlock();
+  while (!level.empty() && static_cast<int>(separators.size()) < parts - 1) {
+    std::vector<page_id_t> children;
+    std::vector<KeyType> child_separators;
+    // Pages may have changed since their parent was read, so only keep separators that are in order and in range.
+    auto add_separator = [&](const KeyType &separator) {
+      if (comparator_(separator, key) > 0 && comparator_(separator, end_key) < 0 &&
+          (child_separators.empty() || comparator_(separator, child_separators.back()) > 0)) {
+        child_separators.push_back(separator);
+      }
+    };
+    bool leaves = false;
+    for (size_t index = 0; index < level.size(); index++) {
+      // the separator of two pages on this level separates their children on the next one
+      if (index > 0 && index - 1 < separators.size()) {
+        add_separator(separators[index - 1]);
+      }
+      ReadPageGuard guard = buffer_pool_manager_->FetchPageRead(level[index]);
+      leaves = !guard.IsValid() || guard.As<BPlusTreePage>()->IsLeafPage();
+      if (leaves) {
+        break;
+      }
+      // child i holds the keys in [KeyAt(i), KeyAt(i + 1)); keep the children that overlap the range
+      const auto *internal = guard.As<InternalPage>();
+      bool kept = false;
+      for (int i = 0; i < internal->GetSize(); i++) {
+        if (i > 0 && comparator_(internal->KeyAt(i), end_key) >= 0) {
+          break;
+        }
+        if (i + 1 < internal->GetSize() && comparator_(internal->KeyAt(i + 1), key) <= 0) {
+          continue;
+        }
+        if (kept) {
+          add_separator(internal->KeyAt(i));
+        }
+        children.push_back(internal->ValueAt(i));
+        kept = true;
+      }
+    }
+    if (leaves) {
+      break;
+    }
+    separators = std::move(child_separators);
+    level = std::move(children);
+  }
+  if (static_cast<int>(separators.size()) <= parts - 1) {
+    return separators;
+  }
+  std::vector<KeyType> result;
+  int count = static_cast<int>(separators.size());
+  for (int part = 1; part < parts; part++) {
+    result.push_back(separators[part * (count + 1) / parts - 1]);
+  }
+  return result;
 }
 
 /*****************************************************************************
@@ -375,104 +1238,222 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::end() {
  *****************************************************************************/
 /*
  * Find leaf page containing particular key, if leftMost flag == true, find
- * the left most leaf page
+ * the left most leaf page. The internal pages are read optimistically, and
+ * only the leaf is latched. After a few conflicts with writers, fall back to
+ * latch coupling: a child is latched before its parent is released.
+ * @return : the read guard of the leaf page, which guards nothing if the tree is empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+ReadPageGuard BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
+  if (b_link_) {
+    return BLinkFindLeafPage(key, leftMost);
+  }
+  for (int attempt = 0; attempt < OPTIMISTIC_DESCENT_ATTEMPTS; attempt++) {
+    page_id_t leaf_page_id;
+    Page *parent;
+    uint64_t parent_version;
+    if (!OptimisticDescent(key, leftMost, &leaf_page_id, &parent, &parent_version)) {
+      continue;
+    }
+    if (leaf_page_id == INVALID_PAGE_ID) {
+      return ReadPageGuard();
+    }
+    ReadPageGuard guard = buffer_pool_manager_->FetchPageRead(leaf_page_id);
+    if (guard.IsValid() && guard.As<BPlusTreePage>()->IsLeafPage() &&
+        ValidateDescent(leaf_page_id, parent, parent_version)) {
+      return guard;
+    }
+  }
+
+  root_latch_.RLock();
+  if (IsEmpty()) {
+    root_latch_.RUnlock();
+    return ReadPageGuard();
+  }
+  ReadPageGuard guard = buffer_pool_manager_->FetchPageRead(root_page_id_);
+  root_latch_.RUnlock();
+  while (!guard.As<BPlusTreePage>()->IsLeafPage()) {
+    auto *internal = guard.As<InternalPage>();
+    // The child is latched before the move releases the parent.
+    guard = buffer_pool_manager_->FetchPageRead(leftMost ? internal->ValueAt(0) : internal->Lookup(key, comparator_));
+  }
+  return guard;
+}
+
+/*
+ * Find the rightmost leaf page by latch coupling from the root. In B-link
+ * mode, a page may have been split off to the right of the rightmost child
+ * before its parent knows about it, so follow the right links on each level.
+ * @return : the read guard of the leaf page, which guards nothing if the tree is empty
  */
 INDEX_TEMPLATE_ARGUMENTS
-Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost, 
-                                  Transaction* transaction, Operation operation) { 
-  if(IsEmpty()) {
-    return nullptr;  
+ReadPageGuard BPLUSTREE_TYPE::FindRightmostLeafPage() {
+  root_latch_.RLock();
+  if (IsEmpty()) {
+    root_latch_.RUnlock();
+    return ReadPageGuard();
   }
-  auto page = buffer_pool_manager_->FetchPage(root_page_id_);
-  BPlusTreePage* page_node = reinterpret_cast<BPlusTreePage *>(page->GetData());
-  while(!page_node->IsLeafPage()){
-    auto internal = reinterpret_cast<InternalPage *>(page_node);
-    page_id_t child_page_id;
-    if(leftMost){
-      child_page_id = internal->ValueAt(0);
-    }else{
-      child_page_id = internal->Lookup(key, comparator_);
+  ReadPageGuard guard = buffer_pool_manager_->FetchPageRead(root_page_id_);
+  root_latch_.RUnlock();
+  while (true) {
+    while (b_link_ && guard.As<BPlusTreePage>()->GetNextPageId() != INVALID_PAGE_ID) {
+      guard = buffer_pool_manager_->FetchPageRead(guard.As<BPlusTreePage>()->GetNextPageId());
+    }
+    if (guard.As<BPlusTreePage>()->IsLeafPage()) {
+      return guard;
     }
-    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
-    page = buffer_pool_manager_->FetchPage(child_page_id); //return leaf found
-    page_node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    auto *internal = guard.As<InternalPage>();
+    guard = buffer_pool_manager_->FetchPageRead(internal->ValueAt(internal->GetSize() - 1));
   }
-  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
-  return page;
 }
 
+/*
+ * Find leaf page containing particular key for an insert or remove, and write
+ * latch it in ctx. Most operations only modify the leaf, so first descend
+ * optimistically and latch just the leaf; that is enough if the leaf is safe
+ * for the operation, i.e. it cannot split or underflow. Otherwise take the
+ * root latch and write latch every page on the way down. Whenever a page is
+ * safe, the root latch and all pages above it are released, since the
+ * operation cannot propagate further up.
+ * @return : false if the tree is empty, in which case ctx holds the root latch
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::LockPage(Page* page, Transaction* transaction, Operation op){
-    if(op == Operation::SEARCH){
-        page->RLatch();
-    }else{
-        page->WLatch();
+bool BPLUSTREE_TYPE::FindLeafPageForWrite(const KeyType &key, Operation op, Context *ctx) {
+  for (int attempt = 0; attempt < OPTIMISTIC_DESCENT_ATTEMPTS; attempt++) {
+    page_id_t leaf_page_id;
+    Page *parent;
+    uint64_t parent_version;
+    if (!OptimisticDescent(key, false, &leaf_page_id, &parent, &parent_version)) {
+      continue;
+    }
+    if (leaf_page_id == INVALID_PAGE_ID) {
+      break;
     }
-    if(transaction != nullptr)
-        transaction->GetPageSet()->push_back(page);
+    WritePageGuard guard = buffer_pool_manager_->FetchPageWrite(leaf_page_id);
+    if (!guard.IsValid() || !guard.As<BPlusTreePage>()->IsLeafPage() ||
+        !ValidateDescent(leaf_page_id, parent, parent_version)) {
+      continue;
+    }
+    if (IsSafe(guard.As<BPlusTreePage>(), op, key)) {
+      ctx->write_set_.push_back(std::move(guard));
+      return true;
+    }
+    break;
+  }
+
+  ctx->LockRoot(&root_latch_);
+  if (IsEmpty()) {
+    return false;
+  }
+  page_id_t page_id = root_page_id_;
+  while (true) {
+    ctx->write_set_.push_back(buffer_pool_manager_->FetchPageWrite(page_id));
+    WritePageGuard &guard = ctx->write_set_.back();
+    const auto *node = guard.As<BPlusTreePage>();
+    if (IsSafe(node, op, key)) {
+      ctx->ReleaseAncestors();
+    }
+    if (node->IsLeafPage()) {
+      return true;
+    }
+    page_id = reinterpret_cast<const InternalPage *>(node)->Lookup(key, comparator_);
+  }
 }
 
+/*
+ * Descend from the root towards the leaf containing particular key (or the
+ * left most leaf, if leftMost flag == true) without latching, pinning or
+ * otherwise writing to any page, so that concurrent readers do not contend.
+ * Every internal page is read optimistically: a child pointer is only
+ * followed once the version of the child has been read and the version of
+ * the page it was read from has been validated. The caller must latch the
+ * leaf, check that it is a leaf, and then call ValidateDescent.
+ * @param[out] leaf_page_id      the leaf, or INVALID_PAGE_ID if the tree is empty
+ * @param[out] parent            the frame of the page that points to the leaf, nullptr if the leaf is the root
+ * @param[out] parent_version    the version of parent the pointer to the leaf was read at
+ * @return : false if the descent conflicted with a writer or needs a page that is not resident
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::UnlockPage(Page* page, Transaction* transaction, Operation op){
-    if(page->GetPageId() == root_page_id_){
-        UnlockRoot();
+bool BPLUSTREE_TYPE::OptimisticDescent(const KeyType &key, bool leftMost, page_id_t *leaf_page_id, Page **parent,
+                                       uint64_t *parent_version) {
+  Page *page = nullptr;
+  uint64_t version = 0;
+  page_id_t page_id = root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    *leaf_page_id = INVALID_PAGE_ID;
+    return true;
+  }
+  while (true) {
+    Page *child = buffer_pool_manager_->FindResidentPage(page_id);
+    if (child == nullptr) {
+      return false;
+    }
+    uint64_t child_version = child->ReadVersion();
+    // The pointer to the child is only good if the page it was read from has not changed since.
+    if (!ValidateDescent(page_id, page, version)) {
+      return false;
+    }
+    *leaf_page_id = page_id;
+    *parent = page;
+    *parent_version = version;
+    if (child->GetPageId() != page_id) {
+      return false;
     }
-    if(op == Operation::SEARCH){
-        page->RUnlatch();
-        buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
-    }else{
-        page->WUnlatch();
-        buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+    // A write latched child cannot be read; it may as well be the leaf, which the caller is going to latch anyway.
+    if ((child_version & 1) != 0) {
+      return true;
+    }
+    const auto *node = reinterpret_cast<const BPlusTreePage *>(child->GetData());
+    if (node->IsLeafPage()) {
+      return true;
     }
-    if(transaction != nullptr)
-        transaction->GetPageSet()->pop_front();
+    // The page may be torn, so make sure the lookup stays within the page before relying on its size.
+    int size = node->GetSize();
+    if (size < 1 || size > internal_max_size_ + 1) {
+      return false;
+    }
+    auto *internal = reinterpret_cast<const InternalPage *>(node);
+    page = child;
+    version = child_version;
+    page_id = leftMost ? internal->ValueAt(0) : internal->Lookup(key, comparator_);
+  }
 }
 
+/*
+ * @return : true if the pointer to leaf_page_id that OptimisticDescent read
+ * from parent is still valid, i.e. parent has not changed since, or, if
+ * parent is nullptr, leaf_page_id is still the root. Once the leaf is
+ * latched, it cannot be split or merged anymore, so it is then known to be
+ * the right leaf.
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::UnlockAllPage(Transaction* transaction, Operation op){
-    if(transaction == nullptr) return;
-    while(!transaction->GetPageSet()->empty()){
-        auto front = transaction->GetPageSet()->front();
-        if(front->GetPageId() != INVALID_PAGE_ID){
-            if(op == Operation::SEARCH){
-                front->RUnlatch();
-                buffer_pool_manager_->UnpinPage(front->GetPageId(), false);
-            }else{
-                if(front->GetPageId() == root_page_id_){
-                    UnlockRoot();
-                }
-                front->WUnlatch(); 
-                buffer_pool_manager_->UnpinPage(front->GetPageId(), true);
-            }
-        }
-        transaction->GetPageSet()->pop_front();
-    }
-}
-
-INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::UnlockParentPage(Page* page, Transaction* transaction, Operation op){
-    if(transaction == nullptr) return;
-    if(transaction->GetPageSet()->empty()) return;
-    if(page->GetPageId() == INVALID_PAGE_ID){
-        UnlockAllPage(transaction, op);
-    }else{
-        while(!transaction->GetPageSet()->empty() && transaction->GetPageSet()->front()->GetPageId() != page->GetPageId()){
-            auto front = transaction->GetPageSet()->front();
-            if(front->GetPageId() != INVALID_PAGE_ID){
-                if(op == Operation::SEARCH){
-                    front->RUnlatch();
-                    buffer_pool_manager_->UnpinPage(front->GetPageId(), false);
-                }else{
-                    if(front->GetPageId() == root_page_id_){
-                        UnlockRoot();
-                    }
-                    front->WUnlatch(); 
-                    buffer_pool_manager_->UnpinPage(front->GetPageId(), true);
-                }
-            }
-            transaction->GetPageSet()->pop_front();
-        }
+bool BPLUSTREE_TYPE::ValidateDescent(page_id_t leaf_page_id, Page *parent, uint64_t parent_version) const {
+  return parent == nullptr ? root_page_id_ == leaf_page_id : parent->ValidateVersion(parent_version);
+}
+
+/*
+ * @return : true if op on key cannot make node split or underflow, so that
+ * op cannot modify any page above node
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::IsSafe(const BPlusTreePage *node, Operation op, const KeyType &key) const {
+  if (op == Operation::INSERT) {
+    // A leaf splits as soon as it is full, an internal page once it overflows, and both if the new key does not fit.
+    // Which key an internal page gets is not known yet.
+    if (node->IsLeafPage()) {
+      return node->GetSize() + 1 < node->GetMaxSize() && reinterpret_cast<const LeafPage *>(node)->HasRoomFor(key);
     }
+    return reinterpret_cast<const InternalPage *>(node)->HasRoomForAny();
+  }
+  if (op == Operation::DELETE) {
+    if (node->IsRootPage()) {
+      // The root only changes once the last key of a root leaf, or the second to last child of a root internal page,
+      // is removed.
+      return node->GetSize() > (node->IsLeafPage() ? 1 : 2);
+    }
+    return node->GetSize() > node->GetMinSize();
+  }
+  return true;
 }
 
 /*
@@ -485,7 +1466,8 @@ void BPLUSTREE_TYPE::UnlockParentPage(Page* page, Transaction* transaction, Oper
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::UpdateRootPageId(bool insert_record) {
-  HeaderPage *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
+  WritePageGuard header_guard = buffer_pool_manager_->FetchPageWrite(HEADER_PAGE_ID);
+  auto *header_page = static_cast<HeaderPage *>(header_guard.GetPage());
   if (insert_record) {
     // create a new record<index_name + root_page_id> in header_page
     header_page->InsertRecord(index_name_, root_page_id_);
@@ -493,7 +1475,7 @@ void BPLUSTREE_TYPE::UpdateRootPageId(bool insert_record) {
     // update root_page_id in header_page
     header_page->UpdateRecord(index_name_, root_page_id_);
   }
-  buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
+  header_guard.SetDirty();
 }
 
 /*
@@ -664,5 +1646,6 @@ template class BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTree<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTree<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTree<GenericKey<64>, RID, GenericComparator<64>>;
+template class BPlusTree<GenericKey<256>, RID, GenericComparator<256>>;
 
 }  // namespace bustub
@@ -11,6 +11,13 @@
 
 #include "storage/index/b_plus_tree_index.h"
 
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+
 namespace bustub {
 /*
  * Constructor
@@ -19,48 +26,162 @@ INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager)
     : Index(metadata),
       comparator_(metadata->GetKeySchema()),
-      container_(metadata->GetName(), buffer_pool_manager, comparator_) {}
+      container_(metadata->GetName(), buffer_pool_manager, comparator_, LEAF_PAGE_SIZE, INTERNAL_PAGE_SIZE, false,
+                 metadata->IsUnique()) {}
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct insert index key
   KeyType index_key;
-  index_key.SetFromKey(key);
+  if (!MakeKey(key, &index_key)) {
+    throw Exception(ExceptionType::OUT_OF_RANGE,
+                    "index key is longer than " + std::to_string(sizeof(KeyType)) + " bytes");
+  }
 
   container_.Insert(index_key, rid, transaction);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
-  // construct delete index key
+  // construct delete index key; a key that is too long was never inserted
   KeyType index_key;
-  index_key.SetFromKey(key);
+  if (!MakeKey(key, &index_key)) {
+    return;
+  }
 
-  container_.Remove(index_key, transaction);
+  container_.Remove(index_key, rid, transaction);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
-  // construct scan index key
+  // construct scan index key; a key that is too long was never inserted
   KeyType index_key;
-  index_key.SetFromKey(key);
+  if (!MakeKey(key, &index_key)) {
+    return;
+  }
 
   container_.GetValue(index_key, result, transaction);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::InsertEntries(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) {
+  // construct the index keys; the tree sorts them
+  std::vector<std::pair<KeyType, RID>> index_entries;
+  index_entries.reserve(entries.size());
+  for (const auto &[key, rid] : entries) {
+    KeyType index_key;
+    if (!MakeKey(key, &index_key)) {
+      throw Exception(ExceptionType::OUT_OF_RANGE,
+                      "index key is longer than " + std::to_string(sizeof(KeyType)) + " bytes");
+    }
+    index_entries.emplace_back(index_key, rid);
+  }
+
+  container_.InsertBatch(&index_entries, transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                                    Transaction *transaction) {
+  // construct the index keys; the tree looks them up in ascending order. Keys that are too long were never inserted,
+  // so they are left out and find nothing.
+  std::vector<KeyType> index_keys;
+  std::vector<size_t> positions;
+  index_keys.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    KeyType index_key;
+    if (MakeKey(keys[i], &index_key)) {
+      index_keys.push_back(index_key);
+      positions.push_back(i);
+    }
+  }
+
+  if (positions.size() == keys.size()) {
+    container_.GetValues(index_keys, results, transaction);
+    return;
+  }
+  std::vector<std::vector<RID>> found;
+  container_.GetValues(index_keys, &found, transaction);
+  results->assign(keys.size(), {});
+  for (size_t i = 0; i < positions.size(); i++) {
+    (*results)[positions[i]] = std::move(found[i]);
+  }
+}
+
+/*
+ * Build the index key of a key tuple. A key tuple that is longer than KeyType, such as one with a long string, does not
+ * fit: indexing a prefix of it instead would make a unique index reject distinct keys, and scans return the rows of
+ * other keys.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_INDEX_TYPE::MakeKey(const Tuple &key, KeyType *index_key) const {
+  if (key.GetLength() > sizeof(KeyType)) {
+    return false;
+  }
+  index_key->SetFromKey(key);
+  return true;
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator() { return container_.begin(); }
 
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &key) { return container_.Begin(key); }
 
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &key, const KeyType &end_key) {
+  return container_.Begin(key, end_key);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetReverseBeginIterator() { return container_.RBegin(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetReverseBeginIterator(const KeyType &key) { return container_.RBegin(key); }
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetReverseBeginIterator(const KeyType &key, const KeyType &end_key) {
+  return container_.RBegin(key, end_key);
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetEndIterator() { return container_.end(); }
 
+INDEX_TEMPLATE_ARGUMENTS
+std::vector<KeyType> BPLUSTREE_INDEX_TYPE::SplitRange(const KeyType &key, const KeyType &end_key, int parts) {
+  return container_.SplitRange(key, end_key, parts);
+}
+
+std::unique_ptr<Index> CreateBPlusTreeIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager) {
+  const Schema *key_schema = metadata->GetKeySchema();
+  bool has_strings = false;
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    has_strings = has_strings || !key_schema->GetColumn(i).IsInlined();
+  }
+  uint32_t length = key_schema->GetLength();
+  if (!has_strings && length <= 4) {
+    return std::make_unique<BPlusTreeIndex<GenericKey<4>, RID, GenericComparator<4>>>(metadata, buffer_pool_manager);
+  }
+  if (!has_strings && length <= 8) {
+    return std::make_unique<BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>>(metadata, buffer_pool_manager);
+  }
+  if (!has_strings && length <= 16) {
+    return std::make_unique<BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>>(metadata, buffer_pool_manager);
+  }
+  if (!has_strings && length <= 32) {
+    return std::make_unique<BPlusTreeIndex<GenericKey<32>, RID, GenericComparator<32>>>(metadata, buffer_pool_manager);
+  }
+  if (!has_strings && length <= 64) {
+    return std::make_unique<BPlusTreeIndex<GenericKey<64>, RID, GenericComparator<64>>>(metadata, buffer_pool_manager);
+  }
+  return std::make_unique<BPlusTreeIndex<GenericKey<256>, RID, GenericComparator<256>>>(metadata, buffer_pool_manager);
+}
+
 template class BPlusTreeIndex<GenericKey<4>, RID, GenericComparator<4>>;
 template class BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTreeIndex<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTreeIndex<GenericKey<64>, RID, GenericComparator<64>>;
+template class BPlusTreeIndex<GenericKey<256>, RID, GenericComparator<256>>;
 
 }  // namespace bustub
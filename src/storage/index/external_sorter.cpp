@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// external_sorter.cpp
+//
+// Identification: src/storage/index/external_sorter.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/external_sorter.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+EXTERNAL_SORTER_TYPE::ExternalSorter(const KeyComparator &comparator, size_t run_size, bool unique_keys)
+    : comparator_(comparator), run_size_(std::max<size_t>(run_size, 1)), unique_keys_(unique_keys) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+EXTERNAL_SORTER_TYPE::~ExternalSorter() {
+  for (auto &run : runs_) {
+    if (run.file_ != nullptr) {
+      std::fclose(run.file_);
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void EXTERNAL_SORTER_TYPE::Add(const KeyType &key, const ValueType &value) {
+  buffer_.emplace_back(key, value);
+  if (buffer_.size() >= run_size_) {
+    SpillRun();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void EXTERNAL_SORTER_TYPE::SortBuffer() {
+  auto less = [this](const MappingType &a, const MappingType &b) { return comparator_(a.first, b.first) < 0; };
+  if (!std::is_sorted(buffer_.begin(), buffer_.end(), less)) {
+    // stable, so that the first of equal keys stays in front
+    std::stable_sort(buffer_.begin(), buffer_.end(), less);
+  }
+  if (!unique_keys_) {
+    return;
+  }
+  auto equal = [this](const MappingType &a, const MappingType &b) { return comparator_(a.first, b.first) == 0; };
+  buffer_.erase(std::unique(buffer_.begin(), buffer_.end(), equal), buffer_.end());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void EXTERNAL_SORTER_TYPE::SpillRun() {
+  SortBuffer();
+  std::FILE *file = std::tmpfile();
+  if (file == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot create a temporary file for an external sort run");
+  }
+  runs_.push_back({file, {}});
+  if (std::fwrite(buffer_.data(), sizeof(MappingType), buffer_.size(), file) != buffer_.size()) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot write an external sort run");
+  }
+  std::rewind(file);
+  buffer_.clear();
+  spilled_runs_++;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void EXTERNAL_SORTER_TYPE::Finish() {
+  SortBuffer();
+  if (runs_.empty()) {
+    // everything fit in memory, so there is nothing to merge: Next reads buffer_ directly
+    return;
+  }
+  runs_.push_back({nullptr, {}});
+  for (size_t i = 0; i < runs_.size(); i++) {
+    if (Advance(&runs_[i])) {
+      heap_.push_back(i);
+    }
+  }
+  std::make_heap(heap_.begin(), heap_.end(), [this](size_t a, size_t b) { return HeapGreater(a, b); });
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool EXTERNAL_SORTER_TYPE::Advance(Run *run) {
+  if (run->file_ != nullptr) {
+    return std::fread(&run->head_, sizeof(MappingType), 1, run->file_) == 1;
+  }
+  if (buffer_pos_ == buffer_.size()) {
+    return false;
+  }
+  run->head_ = buffer_[buffer_pos_++];
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool EXTERNAL_SORTER_TYPE::HeapGreater(size_t a, size_t b) const {
+  int cmp = comparator_(runs_[a].head_.first, runs_[b].head_.first);
+  return cmp > 0 || (cmp == 0 && a > b);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool EXTERNAL_SORTER_TYPE::Next(MappingType *entry) {
+  auto heap_greater = [this](size_t a, size_t b) { return HeapGreater(a, b); };
+  while (true) {
+    if (runs_.empty()) {
+      // the single in-memory run has no duplicates left, unless they are kept
+      if (buffer_pos_ == buffer_.size()) {
+        return false;
+      }
+      *entry = buffer_[buffer_pos_++];
+      return true;
+    }
+    if (heap_.empty()) {
+      return false;
+    }
+    std::pop_heap(heap_.begin(), heap_.end(), heap_greater);
+    Run &run = runs_[heap_.back()];
+    *entry = run.head_;
+    if (Advance(&run)) {
+      std::push_heap(heap_.begin(), heap_.end(), heap_greater);
+    } else {
+      heap_.pop_back();
+    }
+    // a run has no duplicates, but the same key may come from several runs, the earliest one first
+    if (!unique_keys_ || !has_last_ || comparator_(entry->first, last_key_) != 0) {
+      has_last_ = true;
+      last_key_ = entry->first;
+      return true;
+    }
+  }
+}
+
+template class ExternalSorter<GenericKey<4>, RID, GenericComparator<4>>;
+template class ExternalSorter<GenericKey<8>, RID, GenericComparator<8>>;
+template class ExternalSorter<GenericKey<16>, RID, GenericComparator<16>>;
+template class ExternalSorter<GenericKey<32>, RID, GenericComparator<32>>;
+template class ExternalSorter<GenericKey<64>, RID, GenericComparator<64>>;
+template class ExternalSorter<GenericKey<256>, RID, GenericComparator<256>>;
+
+}  // namespace bustub
@@ -1,80 +1,203 @@
 /**
  * index_iterator.cpp
  */
+#include <algorithm>
 #include <cassert>
+#include <stdexcept>
+#include <utility>
 
 #include "storage/index/index_iterator.h"
+#include "storage/index/posting_list.h"
 
 namespace bustub {
 
-/*
- * NOTE: you can change the destructor/constructor method here
- * set your own input parameters
- */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::IndexIterator(page_id_t page_id, int index, BufferPoolManager* buffer_pool_manager) : 
-page_id_(page_id), index_(index), buffer_pool_manager_(buffer_pool_manager) {
-    auto leaf_page = buffer_pool_manager_->FetchPage(page_id_);
-    leaf_node_ = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(leaf_page->GetData());
+INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *buffer_pool_manager, ReadPageGuard leaf_guard, int index,
+                                  bool postings, const KeyComparator *comparator, const KeyType *end_key, bool reverse,
+                                  std::function<ReadPageGuard(const KeyType &)> find_leaf)
+    : page_id_(leaf_guard.PageId()),
+      index_(index),
+      buffer_pool_manager_(buffer_pool_manager),
+      leaf_guard_(std::move(leaf_guard)),
+      postings_enabled_(postings),
+      reverse_(reverse),
+      bounded_(end_key != nullptr),
+      comparator_(comparator),
+      find_leaf_(std::move(find_leaf)) {
+  if (bounded_) {
+    end_key_ = *end_key;
+  }
+  leaf_node_ = leaf_guard_.As<B_PLUS_TREE_LEAF_PAGE_TYPE>();
+  if (reverse_) {
+    SkipExhaustedLeavesBackward();
+  } else {
+    SkipExhaustedLeaves();
+  }
+  CheckEndKey();
+  LoadPostings();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::~IndexIterator() {
-    buffer_pool_manager_->UnpinPage(page_id_, false);
+bool INDEXITERATOR_TYPE::isEnd() { return page_id_ == INVALID_PAGE_ID; }
+
+INDEX_TEMPLATE_ARGUMENTS
+bool INDEXITERATOR_TYPE::operator==(const IndexIterator &itr) const {
+  return page_id_ == itr.page_id_ && index_ == itr.index_ && posting_index_ == itr.posting_index_;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-bool INDEXITERATOR_TYPE::isEnd() { 
-  auto next_id = leaf_node_->GetNextPageId();
-  return (leaf_node_ == nullptr || (index_ >= leaf_node_->GetSize() && next_id == INVALID_PAGE_ID));
+bool INDEXITERATOR_TYPE::operator!=(const IndexIterator &itr) const { return !(*this == itr); }
+
+INDEX_TEMPLATE_ARGUMENTS
+const MappingType &INDEXITERATOR_TYPE::operator*() {
+  if (isEnd()) {
+    throw std::out_of_range("Index_Iterator : out of range");
+  }
+  // the leaf stores its entries compressed, so decode the current one
+  item_ = leaf_node_->GetItem(index_);
+  if (!postings_.empty()) {
+    item_.second = postings_[posting_index_];
+  }
+  return item_;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-bool INDEXITERATOR_TYPE::operator==(const IndexIterator &itr) const { 
-  bool res = (index_ == itr.index_) && (page_id_ == itr.page_id_);
-  return res;
- }
+INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
+  if (reverse_) {
+    if (posting_index_ > 0) {
+      posting_index_--;
+      return *this;
+    }
+    index_--;
+    SkipExhaustedLeavesBackward();
+  } else {
+    if (posting_index_ + 1 < static_cast<int>(postings_.size())) {
+      posting_index_++;
+      return *this;
+    }
+    index_++;
+    SkipExhaustedLeaves();
+  }
+  CheckEndKey();
+  LoadPostings();
+  return *this;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-bool INDEXITERATOR_TYPE::operator!=(const IndexIterator &itr) const { 
-  bool res = (index_ != itr.index_) || (page_id_ != itr.page_id_);
-  return res;
+void INDEXITERATOR_TYPE::LoadPostings() {
+  postings_.clear();
+  posting_index_ = 0;
+  if (!postings_enabled_ || isEnd()) {
+    return;
+  }
+  // the posting list is protected by the latch on the leaf, which the iterator holds
+  ValueType value = leaf_node_->GetItem(index_).second;
+  if (PostingList::IsReference(value)) {
+    PostingList::Read(buffer_pool_manager_, value, &postings_);
+    // a reverse iterator returns the values of a key in descending order, too
+    posting_index_ = reverse_ ? static_cast<int>(postings_.size()) - 1 : 0;
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-const MappingType &INDEXITERATOR_TYPE::operator*() { 
-  if(isEnd()){
-    throw std::out_of_range("Index_Iterator : out of range");
+void INDEXITERATOR_TYPE::CheckEndKey() {
+  if (!bounded_ || isEnd()) {
+    return;
+  }
+  int cmp = (*comparator_)(leaf_node_->KeyAt(index_), end_key_);
+  if (reverse_ ? cmp <= 0 : cmp >= 0) {
+    MakeEnd();
   }
-  return leaf_node_->GetItem(index_);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
-  index_++;
-  if (index_ >= leaf_node_->GetSize()) {
-      page_id_t next = leaf_node_->GetNextPageId();
-      buffer_pool_manager_->UnpinPage(leaf_node_->GetPageId(), false);
-      if (next == INVALID_PAGE_ID) {
-        //set index to a constant
-        index_ = INT_MAX;
-        page_id_ = INT_MAX;
-        leaf_node_ = nullptr;
-      } else {
-        Page *page = buffer_pool_manager_->FetchPage(next);
-        leaf_node_ = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(page->GetData());
-        page_id_ = next;
-        index_ = 0;
+void INDEXITERATOR_TYPE::MakeEnd() {
+  leaf_guard_.Drop();
+  leaf_node_ = nullptr;
+  page_id_ = INVALID_PAGE_ID;
+  index_ = 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SkipExhaustedLeaves() {
+  while (index_ >= leaf_node_->GetSize()) {
+    page_id_t next = leaf_node_->GetNextPageId();
+    if (next == INVALID_PAGE_ID) {
+      MakeEnd();
+      return;
+    }
+    // the keys of the next leaf are at least the high key of this one, so there is no need to read it if they are all
+    // beyond the end key
+    const KeyType high_key = leaf_node_->GetHighKey();
+    if (bounded_ && (*comparator_)(end_key_, high_key) <= 0) {
+      MakeEnd();
+      return;
+    }
+    // Release the leaf before latching the next one: a remove may hold the next leaf while it latches its left sibling.
+    page_id_t page_id = page_id_;
+    leaf_guard_.Drop();
+    leaf_node_ = nullptr;
+    // leaves that were split off in key order (e.g. by appends or bulk loads) are laid out sequentially on disk,
+    // so read the following leaves ahead while this one is processed
+    if (next == page_id + 1 && next + READ_AHEAD_PAGES > read_ahead_until_) {
+      page_id_t first = std::max(next + 1, read_ahead_until_);
+      buffer_pool_manager_->PrefetchRange(first, next + READ_AHEAD_PAGES - first);
+      read_ahead_until_ = next + READ_AHEAD_PAGES;
+    }
+    leaf_guard_ = buffer_pool_manager_->FetchPageRead(next);
+    // a leaf that has been merged into this one is emptied, but keeps its links, and its page is not freed while
+    // this iterator has it pinned
+    const auto *next_leaf = leaf_guard_.IsValid() ? leaf_guard_.As<B_PLUS_TREE_LEAF_PAGE_TYPE>() : nullptr;
+    if (next_leaf == nullptr || !next_leaf->IsLeafPage() || next_leaf->GetSize() == 0 ||
+        next_leaf->GetPrevPageId() != page_id || (*comparator_)(next_leaf->GetLowKey(), high_key) != 0) {
+      // the next leaf has been merged into this one, has passed keys to it, or this one has been split, in the
+      // meantime, so find the leaf that now holds the high key
+      leaf_guard_.Drop();
+      leaf_guard_ = find_leaf_(high_key);
+      if (!leaf_guard_.IsValid()) {
+        MakeEnd();
+        return;
       }
     }
-    //if (next_page_id != INVALID_PAGE_ID) {
-      //buffer_pool_manager_->UnpinPage(page_id_, false);
-      //auto page = buffer_pool_manager_->FetchPage(next_page_id);
-      //leaf_node_ = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(page->GetData());
-      //index_ = 0;
-      //page_id_ = next_page_id;
-    //}
-  return *this;
+    page_id_ = leaf_guard_.PageId();
+    leaf_node_ = leaf_guard_.As<B_PLUS_TREE_LEAF_PAGE_TYPE>();
+    // the keys below the high key have been visited already, including any that a concurrent split or merge moved
+    index_ = leaf_node_->KeyIndex(high_key, *comparator_);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SkipExhaustedLeavesBackward() {
+  while (index_ < 0) {
+    if (leaf_node_->GetSize() > 0 && (!has_boundary_ || (*comparator_)(leaf_node_->KeyAt(0), boundary_) < 0)) {
+      boundary_ = leaf_node_->KeyAt(0);
+      has_boundary_ = true;
+    }
+    page_id_t prev = leaf_node_->GetPrevPageId();
+    // the keys of the previous leaf are smaller than the first one of this leaf, so they are all beyond the end key
+    // if that one is
+    if (prev == INVALID_PAGE_ID || !has_boundary_ || (bounded_ && (*comparator_)(boundary_, end_key_) <= 0)) {
+      MakeEnd();
+      return;
+    }
+    // Release the leaf before latching the previous one: writers latch leaves from left to right.
+    page_id_t page_id = page_id_;
+    leaf_guard_.Drop();
+    leaf_guard_ = buffer_pool_manager_->FetchPageRead(prev);
+    if (!leaf_guard_.IsValid() || !leaf_guard_.As<BPlusTreePage>()->IsLeafPage() ||
+        leaf_guard_.As<BPlusTreePage>()->GetNextPageId() != page_id) {
+      // the previous leaf has been split or merged in the meantime, so find the one that now precedes the boundary
+      leaf_guard_.Drop();
+      leaf_guard_ = find_leaf_(boundary_);
+      if (!leaf_guard_.IsValid()) {
+        MakeEnd();
+        return;
+      }
+    }
+    page_id_ = leaf_guard_.PageId();
+    leaf_node_ = leaf_guard_.As<B_PLUS_TREE_LEAF_PAGE_TYPE>();
+    index_ = leaf_node_->KeyIndex(boundary_, *comparator_) - 1;
+  }
 }
 
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
@@ -87,4 +210,6 @@ template class IndexIterator<GenericKey<32>, RID, GenericComparator<32>>;
 
 template class IndexIterator<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class IndexIterator<GenericKey<256>, RID, GenericComparator<256>>;
+
 }  // namespace bustub
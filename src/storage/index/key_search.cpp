@@ -0,0 +1,119 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// key_search.cpp
+//
+// Identification: src/storage/index/key_search.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/key_search.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define BUSTUB_KEY_SEARCH_X86
+#endif
+
+namespace bustub {
+
+namespace {
+
+/** Binary search stops once this many keys are left, which are then counted with (vector) compares. */
+constexpr int KEY_SEARCH_WINDOW = 16;
+
+/** Loads the width low-order bytes of a key; the others are zero. */
+inline int64_t LoadKey(const char *keys, size_t stride, int width, int index) {
+  int64_t key = 0;
+  memcpy(&key, keys + stride * index, width);
+  return key;
+}
+
+/** Counts the keys in [0, size) that are smaller than key (if upper: not greater than key). */
+int CountScalar(const char *keys, size_t stride, int width, int size, int64_t key, bool upper) {
+  int count = 0;
+  for (int i = 0; i < size; i++) {
+    int64_t k = LoadKey(keys, stride, width, i);
+    count += static_cast<int>(k < key || (upper && k == key));
+  }
+  return count;
+}
+
+#ifdef BUSTUB_KEY_SEARCH_X86
+
+__attribute__((target("sse4.2"))) int CountSse42(const char *keys, size_t stride, int width, int size, int64_t key,
+                                                 bool upper) {
+  // k < key is key > k; k <= key is key + 1 > k, unless key + 1 overflows, in which case every key qualifies
+  if (upper && key == INT64_MAX) {
+    return size;
+  }
+  const __m128i target = _mm_set1_epi64x(upper ? key + 1 : key);
+  int count = 0;
+  int i = 0;
+  for (; i + 2 <= size; i += 2) {
+    __m128i k = _mm_set_epi64x(LoadKey(keys, stride, width, i + 1), LoadKey(keys, stride, width, i));
+    count += __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(target, k))));
+  }
+  return count + CountScalar(keys + stride * i, stride, width, size - i, key, upper);
+}
+
+__attribute__((target("avx2"))) int CountAvx2(const char *keys, size_t stride, int width, int size, int64_t key,
+                                              bool upper) {
+  if (upper && key == INT64_MAX) {
+    return size;
+  }
+  const __m256i target = _mm256_set1_epi64x(upper ? key + 1 : key);
+  const auto s = static_cast<int64_t>(stride);
+  const __m256i offsets = _mm256_set_epi64x(3 * s, 2 * s, s, 0);
+  int count = 0;
+  int i = 0;
+  for (; i + 4 <= size; i += 4) {
+    __m256i k = _mm256_i64gather_epi64(reinterpret_cast<const long long *>(keys + stride * i), offsets, 1);  // NOLINT
+    count += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(target, k))));
+  }
+  return count + CountScalar(keys + stride * i, stride, width, size - i, key, upper);
+}
+
+#endif
+
+using CountFunction = int (*)(const char *, size_t, int, int, int64_t, bool);
+
+/** @return the widest counting kernel that the CPU supports */
+CountFunction SelectCount() {
+#ifdef BUSTUB_KEY_SEARCH_X86
+  if (__builtin_cpu_supports("avx2")) {
+    return CountAvx2;
+  }
+  if (__builtin_cpu_supports("sse4.2")) {
+    return CountSse42;
+  }
+#endif
+  return CountScalar;
+}
+
+}  // namespace
+
+int Int64KeyBound(const char *keys, size_t stride, int width, int size, int64_t key, bool upper) {
+  static const CountFunction vector_count = SelectCount();
+  // the vector kernels load whole 8-byte keys
+  CountFunction count = width == sizeof(int64_t) ? vector_count : CountScalar;
+  int lo = 0;
+  int len = size;
+  while (len > KEY_SEARCH_WINDOW) {
+    int half = len / 2;
+    int64_t k = LoadKey(keys, stride, width, lo + half);
+    if (k < key || (upper && k == key)) {
+      lo += half + 1;
+      len -= half + 1;
+    } else {
+      len = half;
+    }
+  }
+  return lo + (len > 0 ? count(keys + stride * lo, stride, width, len, key, upper) : 0);
+}
+
+}  // namespace bustub
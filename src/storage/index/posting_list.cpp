@@ -0,0 +1,175 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// posting_list.cpp
+//
+// Identification: src/storage/index/posting_list.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/posting_list.h"
+
+#include <algorithm>
+#include <new>
+#include <utility>
+
+#include "storage/page/b_plus_tree_posting_page.h"
+
+namespace bustub {
+
+namespace {
+
+bool RidLess(const RID &a, const RID &b) {
+  return BPlusTreePostingPage::SortKey(a) < BPlusTreePostingPage::SortKey(b);
+}
+
+}  // namespace
+
+RID PostingList::Create(BufferPoolManager *bpm, std::vector<RID> *rids) {
+  std::sort(rids->begin(), rids->end(), RidLess);
+  rids->erase(std::unique(rids->begin(), rids->end()), rids->end());
+  if (rids->size() == 1) {
+    return rids->front();
+  }
+  page_id_t first_page_id = INVALID_PAGE_ID;
+  BasicPageGuard prev_guard;
+  const RID *items = rids->data();
+  int remaining = static_cast<int>(rids->size());
+  while (remaining > 0) {
+    page_id_t page_id;
+    BasicPageGuard guard = bpm->NewPageGuarded(&page_id);
+    if (!guard.IsValid()) {
+      throw std::bad_alloc();
+    }
+    auto *page = guard.AsMut<BPlusTreePostingPage>();
+    page->Init();
+    int count = BPlusTreePostingPage::FitCount(items, remaining);
+    page->SetRids(items, count);
+    items += count;
+    remaining -= count;
+    if (prev_guard.IsValid()) {
+      prev_guard.AsMut<BPlusTreePostingPage>()->SetNextPageId(page_id);
+    } else {
+      first_page_id = page_id;
+    }
+    prev_guard = std::move(guard);
+  }
+  return RID(first_page_id, REFERENCE_SLOT);
+}
+
+void PostingList::Read(BufferPoolManager *bpm, const RID &reference, std::vector<RID> *result) {
+  for (page_id_t page_id = reference.GetPageId(); page_id != INVALID_PAGE_ID;) {
+    BasicPageGuard guard = bpm->FetchPageBasic(page_id);
+    const auto *page = guard.As<BPlusTreePostingPage>();
+    page->GetRids(result);
+    page_id = page->GetNextPageId();
+  }
+}
+
+bool PostingList::Insert(BufferPoolManager *bpm, const RID &reference, const RID &rid) {
+  // rid goes into the first page whose last id is not smaller, or into the last page
+  std::vector<RID> rids;
+  BasicPageGuard guard = bpm->FetchPageBasic(reference.GetPageId());
+  while (true) {
+    rids.clear();
+    guard.As<BPlusTreePostingPage>()->GetRids(&rids);
+    page_id_t next_page_id = guard.As<BPlusTreePostingPage>()->GetNextPageId();
+    if (next_page_id == INVALID_PAGE_ID || !RidLess(rids.back(), rid)) {
+      break;
+    }
+    guard = bpm->FetchPageBasic(next_page_id);
+  }
+  auto pos = std::lower_bound(rids.begin(), rids.end(), rid, RidLess);
+  if (pos != rids.end() && *pos == rid) {
+    return false;
+  }
+  rids.insert(pos, rid);
+  auto *page = guard.AsMut<BPlusTreePostingPage>();
+  int count = static_cast<int>(rids.size());
+  if (BPlusTreePostingPage::FitCount(rids.data(), count) == count) {
+    page->SetRids(rids.data(), count);
+    return true;
+  }
+  // split the page, and link the upper half in after it
+  page_id_t new_page_id;
+  BasicPageGuard new_guard = bpm->NewPageGuarded(&new_page_id);
+  if (!new_guard.IsValid()) {
+    throw std::bad_alloc();
+  }
+  auto *new_page = new_guard.AsMut<BPlusTreePostingPage>();
+  new_page->Init();
+  new_page->SetRids(rids.data() + count / 2, count - count / 2);
+  new_page->SetNextPageId(page->GetNextPageId());
+  page->SetRids(rids.data(), count / 2);
+  page->SetNextPageId(new_page_id);
+  return true;
+}
+
+bool PostingList::Remove(BufferPoolManager *bpm, RID *value, const RID &rid) {
+  std::vector<RID> rids;
+  BasicPageGuard prev_guard;
+  BasicPageGuard guard = bpm->FetchPageBasic(value->GetPageId());
+  while (true) {
+    rids.clear();
+    guard.As<BPlusTreePostingPage>()->GetRids(&rids);
+    if (!RidLess(rids.back(), rid)) {
+      break;
+    }
+    page_id_t next_page_id = guard.As<BPlusTreePostingPage>()->GetNextPageId();
+    if (next_page_id == INVALID_PAGE_ID) {
+      return false;
+    }
+    prev_guard = std::move(guard);
+    guard = bpm->FetchPageBasic(next_page_id);
+  }
+  auto pos = std::lower_bound(rids.begin(), rids.end(), rid, RidLess);
+  if (pos == rids.end() || !(*pos == rid)) {
+    return false;
+  }
+  rids.erase(pos);
+
+  auto *page = guard.AsMut<BPlusTreePostingPage>();
+  page->SetRids(rids.data(), static_cast<int>(rids.size()));
+  if (rids.empty()) {
+    // unlink the empty page; a list of two or more ids never consists of a single empty page
+    page_id_t page_id = guard.PageId();
+    page_id_t next_page_id = page->GetNextPageId();
+    if (prev_guard.IsValid()) {
+      prev_guard.AsMut<BPlusTreePostingPage>()->SetNextPageId(next_page_id);
+    } else {
+      *value = RID(next_page_id, REFERENCE_SLOT);
+    }
+    guard.Drop();
+    bpm->DeletePage(page_id);
+  }
+  prev_guard.Drop();
+  guard.Drop();
+
+  // move the last id back into the leaf
+  BasicPageGuard first_guard = bpm->FetchPageBasic(value->GetPageId());
+  const auto *first = first_guard.As<BPlusTreePostingPage>();
+  if (first->GetSize() == 1 && first->GetNextPageId() == INVALID_PAGE_ID) {
+    page_id_t page_id = first_guard.PageId();
+    rids.clear();
+    first->GetRids(&rids);
+    *value = rids[0];
+    first_guard.Drop();
+    bpm->DeletePage(page_id);
+  }
+  return true;
+}
+
+void PostingList::Delete(BufferPoolManager *bpm, const RID &reference) {
+  for (page_id_t page_id = reference.GetPageId(); page_id != INVALID_PAGE_ID;) {
+    BasicPageGuard guard = bpm->FetchPageBasic(page_id);
+    page_id_t next_page_id = guard.As<BPlusTreePostingPage>()->GetNextPageId();
+    guard.Drop();
+    bpm->DeletePage(page_id);
+    page_id = next_page_id;
+  }
+}
+
+}  // namespace bustub
@@ -11,6 +11,7 @@
 
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 #include "common/exception.h"
 #include "storage/page/b_plus_tree_internal_page.h"
@@ -30,7 +31,30 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id
   SetSize(0);
   SetPageId(page_id);
   SetParentPageId(parent_id);
+  SetNextPageId(INVALID_PAGE_ID);
   SetMaxSize(max_size);
+  entries_.Init(INTERNAL_PAGE_SPACE);
+}
+
+/*
+ * Get/set the high key, which is only valid if there is a next page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+KeyType B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetHighKey() const {
+  return high_key_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetHighKey(const KeyType &high_key) {
+  high_key_ = high_key;
+}
+
+/*
+ * @return whether key belongs to a page to my right, which happens after I have been split
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::IsBeyondHighKey(const KeyType &key, const KeyComparator &comparator) const {
+  return GetNextPageId() != INVALID_PAGE_ID && comparator(key, high_key_) >= 0;
 }
 
 /*
@@ -38,11 +62,7 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id
  */
 INDEX_TEMPLATE_ARGUMENTS
 KeyType B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const {
-  // replace with your own code (fill in the curly braces with the appropriate key value)
-  KeyType key{
-    array[index].first
-  };
-  return key;
+  return entries_.KeyAt(index);
 }
 
 /*
@@ -50,7 +70,7 @@ KeyType B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const {
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
-  array[index].first = key;
+  entries_.SetKeyAt(index, key, GetSize());
 }
 
 /*
@@ -60,7 +80,7 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const { 
   for (int i = 0; i < GetSize(); i++) {
-    if (array[i].second == value) {
+    if (entries_.ValueAt(i) == value) {
       return i;
     }
   }
@@ -72,7 +92,54 @@ int B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const {
  */
 INDEX_TEMPLATE_ARGUMENTS
 ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const { 
-  return array[index].second;
+  return entries_.ValueAt(index);
+}
+
+/*
+ * Whether key can be inserted without overflowing the page. A page that has no room is split before the insert.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::HasRoomFor(const KeyType &key) const {
+  return entries_.BytesWith(GetSize(), key) <= static_cast<int>(INTERNAL_PAGE_SPACE);
+}
+
+/*
+ * Whether any key can be inserted without a split, which is known for sure only if the entries would fit
+ * uncompressed.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::HasRoomForAny() const {
+  return GetSize() + 1 <= GetMaxSize() && GetSize() + 1 <= static_cast<int>(INTERNAL_PAGE_SLOTS);
+}
+
+/*
+ * Whether the key at index can be replaced by key without overflowing the page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::CanSetKeyAt(int index, const KeyType &key) const {
+  // the new key widens the slots at most as much as inserting it would
+  return entries_.BytesWith(GetSize() - 1, key) <= static_cast<int>(INTERNAL_PAGE_SPACE);
+}
+
+/*
+ * Whether all entries of sibling, with middle_key as the key of its first child, can be moved into me, see MoveAllTo.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::CanAbsorb(const BPlusTreeInternalPage *sibling,
+                                               const KeyType &middle_key) const {
+  // MergedBytes counts middle_key as an extra entry, which is a slight overestimate
+  return GetSize() + sibling->GetSize() <= GetMaxSize() &&
+         entries_.MergedBytes(GetSize(), sibling->entries_, sibling->GetSize(), &middle_key) <=
+             static_cast<int>(INTERNAL_PAGE_SPACE);
+}
+
+/*
+ * An internal page is underfull if it holds fewer than GetMinSize() children, unless they fill half of the page
+ * anyway, which happens when the keys do not compress well.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::IsUnderfull() const {
+  return GetSize() < GetMinSize() && entries_.Bytes(GetSize()) < static_cast<int>(INTERNAL_PAGE_SPACE) / 2;
 }
 
 /*****************************************************************************
@@ -87,19 +154,14 @@ ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const {
  */
 INDEX_TEMPLATE_ARGUMENTS
 ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const {
-  if(comparator(key, array[1].first) < 0){
-    return array[0].second;
-  } else if(comparator(key, array[GetSize()-1].first) > 0){
-    return array[GetSize()-1].second;
+  // the child is the one left of the first key that is greater than key; search and read the child with the same
+  // layout, which may be torn if the page is read optimistically
+  auto layout = entries_.GetLayout();
+  if (GetSize() <= 1) {
+    return entries_.ValueAt(0, layout);
   }
-
-  for(int i = 1; i < GetSize(); i++){
-    if(comparator(key, array[i].first) < 0){
-      return array[i-1].second;
-    }
-  }
-
-  return array[GetSize()-1].second;
+  int index = entries_.Search(layout, 1, GetSize(), INTERNAL_PAGE_SPACE, key, comparator, true);
+  return entries_.ValueAt(index - 1, layout);
 }
 
 /*****************************************************************************
@@ -117,8 +179,9 @@ ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyCo
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::PopulateNewRoot(const ValueType &old_value, const KeyType &new_key,
                                                      const ValueType &new_value) {
-  array[0].second = old_value;
-  array[1] = std::make_pair(new_key, new_value);
+  // the first key is invalid, so store new_key there as well, which compresses best
+  entries_.Insert(0, new_key, old_value, 0);
+  entries_.Insert(1, new_key, new_value, 1);
   IncreaseSize(2);
 }
 /*
@@ -131,9 +194,7 @@ int B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertNodeAfter(const ValueType &old_value,
                                                     const ValueType &new_value) {
   int size = GetSize();
   int old_index = ValueIndex(old_value);
-  memmove(array + old_index + 2, array + old_index + 1, 
-  (size - old_index - 1) * sizeof(MappingType));
-  array[old_index + 1] = std::make_pair(new_key, new_value);
+  entries_.Insert(old_index + 1, new_key, new_value, size);
   IncreaseSize(1);
   return size + 1;
 }
@@ -149,33 +210,63 @@ int B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertNodeAfter(const ValueType &old_value,
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage *recipient,
                                                 BufferPoolManager *buffer_pool_manager) {
-  int half = (GetSize() + 1)/2;
-  recipient->CopyNFrom(array + GetSize() - half, half, buffer_pool_manager);
+  int half = entries_.HalfCount(GetSize());
+  std::vector<MappingType> items(half);
+  entries_.CopyOut(GetSize() - half, half, items.data());
+  recipient->CopyNFrom(items.data(), half, buffer_pool_manager);
   IncreaseSize(-1 * half);
+  // the remaining keys may share a longer prefix
+  entries_.Recompress(GetSize());
 }
 
 /*
- * Private helper method for MoveHalfTo.
- * Copy entries into me, starting from {items} and copy {size} entries.
+ * Private helper method for MoveHalfTo and MoveAllTo.
+ * Append {size} entries, starting from {items}, to me.
  * Since it is an internal page, for all entries (pages) moved, their parents page now changes to me.
  * So I need to 'adopt' them by changing their parent page id, which needs to be persisted with BufferPoolManger
  * (i.e., fetch each child page, update the parent page id, and unpin as dirty).
- *
- * To call this from MoveHalfTo, use array + offset to get a pointer to where you want to
- * start copying (the items parameter). offset would be the middle index.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyNFrom(MappingType *items, int size, BufferPoolManager *buffer_pool_manager) {
-  memcpy(array, items, size * sizeof(MappingType));
-  for(int i = 0; i < size; i++) {
-    auto child_page = buffer_pool_manager->FetchPage(array[i].second);
-    auto child_node = reinterpret_cast<BPlusTreePage *>(child_page->GetData()); 
-    child_node->SetParentPageId(GetPageId());
-    buffer_pool_manager->UnpinPage(child_node->GetPageId(), true);
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyNFrom(const MappingType *items, int size,
+                                               BufferPoolManager *buffer_pool_manager) {
+  entries_.Append(items, size, GetSize());
+  for (int i = 0; i < size; i++) {
+    Adopt(items[i].second, buffer_pool_manager);
   }
   IncreaseSize(size);
 }
 
+/*
+ * Append {size} entries, starting from {items}, to me, and adopt their children. Used to bulk load the tree: the
+ * entries must be sorted by key and greater than all of my keys, and must fit, see FitCount.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::AppendSorted(const MappingType *items, int size,
+                                                  BufferPoolManager *buffer_pool_manager) {
+  CopyNFrom(items, size, buffer_pool_manager);
+}
+
+/*
+ * @return the number of leading entries of items, at most size, that fit into an empty internal page
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_INTERNAL_PAGE_TYPE::FitCount(const MappingType *items, int size) {
+  return PageEntries<KeyType, ValueType>::FitCount(items, size, INTERNAL_PAGE_SPACE);
+}
+
+/*
+ * Private helper method: make me the parent of the given child page.
+ * B-link trees do not keep parent page ids, and pass no buffer_pool_manager.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Adopt(page_id_t child_page_id, BufferPoolManager *buffer_pool_manager) {
+  if (buffer_pool_manager == nullptr) {
+    return;
+  }
+  BasicPageGuard child_guard = buffer_pool_manager->FetchPageBasic(child_page_id);
+  child_guard.AsMut<BPlusTreePage>()->SetParentPageId(GetPageId());
+}
+
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
@@ -186,7 +277,7 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyNFrom(MappingType *items, int size, Buf
  */
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove(int index) { 
-  memmove(array + index, array + index + 1, (GetSize()-index-1) * sizeof(MappingType));
+  entries_.Remove(index, GetSize());
   IncreaseSize(-1);
   return GetSize();
  }
@@ -195,54 +286,37 @@ int B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove(int index) {
  * MERGE
  *****************************************************************************/
 /*
- * Remove all of key & value pairs from this page to "recipient" page.
- * The middle_key is the separation key you should get from the parent. You need
- * to make sure the middle key is added to the recipient to maintain the invariant.
- * You also need to use BufferPoolManager to persist changes to the parent page id for those
- * pages that are moved to the recipient. Remember to adjust node sizes.
- * Note: you might find it helpful to assume recipient is a predecessor of this
- *       node (i.e, insert middle key at the end of it, followed by everything from this node)
- *       and then call MoveAllTo accordingly in b_plus_tree.cpp.
+ * Remove all of key & value pairs from this page to the end of "recipient" page, which must be the predecessor of
+ * this node. The middle_key is the separation key from the parent; it becomes the key of my first entry, so that the
+ * invariant holds in the recipient. The moved children are adopted by the recipient, which must have room for them,
+ * see CanAbsorb, and which takes over my right link and high key.
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
                                                BufferPoolManager *buffer_pool_manager) {
-  int size = GetSize();
-  // Update parent page
-  auto parent_page = buffer_pool_manager->FetchPage(GetParentPageId());
-  auto parent_node = reinterpret_cast<BPlusTreeInternalPage *>(parent_page->GetData());
-  // Change key in the parent page
-  SetKeyAt(0, middle_key);
-  buffer_pool_manager->UnpinPage(parent_node->GetPageId(), false); 
-  recipient->CopyNFrom(array + size, size, buffer_pool_manager); 
+  std::vector<MappingType> items(GetSize());
+  entries_.CopyOut(0, GetSize(), items.data());
+  items[0].first = middle_key;
+  recipient->CopyNFrom(items.data(), GetSize(), buffer_pool_manager);
+  recipient->SetNextPageId(GetNextPageId());
+  recipient->SetHighKey(high_key_);
   SetSize(0);
+  entries_.Init(INTERNAL_PAGE_SPACE);
 }
 
 /*****************************************************************************
  * REDISTRIBUTE
  *****************************************************************************/
 /*
- * Remove the first key & value pair from this page to tail of "recipient" page.
- *
- * The middle_key is the separation key you should get from the parent. You need
- * to make sure the middle key is added to the recipient to maintain the invariant.
- * You also need to use BufferPoolManager to persist changes to the parent page id for those
- * pages that are moved to the recipient. Remember to adjust node sizes.
+ * Remove the first key & value pair from this page to tail of "recipient" page, which must be the predecessor of this
+ * node. The middle_key is the separation key from the parent; it goes down with the moved child. The caller must
+ * replace the separation key in the parent with my new first key, KeyAt(0).
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
                                                       BufferPoolManager *buffer_pool_manager) {
-  //Construct the pair
-  auto parent_page = buffer_pool_manager->FetchPage(GetParentPageId());
-  auto parent_node = reinterpret_cast<BPlusTreeInternalPage *>(parent_page->GetData());
-  int parent_index = parent_node->ValueIndex(GetPageId());
-  MappingType first_pair = std::make_pair(middle_key, array[0].second);
-  recipient->CopyLastFrom(first_pair, buffer_pool_manager);
-  //Change parent page
-  parent_node->SetKeyAt(parent_index, array[1].first);
-  Remove(0); 
-  //Unpin pages
-  buffer_pool_manager->UnpinPage(parent_node->GetPageId(), true);
+  recipient->CopyLastFrom(std::make_pair(middle_key, ValueAt(0)), buffer_pool_manager);
+  Remove(0);
 }
 
 /*
@@ -252,29 +326,22 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeInternalPage *rec
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyLastFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager) {
-  int size = GetSize();
-  array[size] = pair;
+  entries_.Insert(GetSize(), pair.first, pair.second, GetSize());
   IncreaseSize(1);
-  // Change metadata in child page
-  auto child_page = buffer_pool_manager->FetchPage(pair.second);
-  auto child_node = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
-  child_node->SetParentPageId(GetPageId());
-  buffer_pool_manager->UnpinPage(child_page->GetPageId(), true);
+  Adopt(pair.second, buffer_pool_manager);
 }
 
 /*
- * Remove the last key & value pair from this page to head of "recipient" page.
- * You need to handle the original dummy key properly, e.g. updating recipient’s array to position the middle_key at the
- * right place.
- * You also need to use BufferPoolManager to persist changes to the parent page id for those pages that are
- * moved to the recipient
+ * Remove the last key & value pair from this page to head of "recipient" page, which must be the successor of this
+ * node. The middle_key is the separation key from the parent; it becomes the key of the recipient's old first child.
+ * The caller must replace the separation key in the parent with the moved key, recipient->KeyAt(0).
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
-                                                       BufferPoolManager *buffer_pool_manager, const int parent_index) {
-  int size = GetSize();
-  recipient->CopyFirstFrom(array[size-1], buffer_pool_manager, middle_key, parent_index);
-  IncreaseSize(-1);                                                       
+                                                       BufferPoolManager *buffer_pool_manager) {
+  recipient->SetKeyAt(0, middle_key);
+  recipient->CopyFirstFrom(std::make_pair(KeyAt(GetSize() - 1), ValueAt(GetSize() - 1)), buffer_pool_manager);
+  IncreaseSize(-1);
 }
 
 /* Append an entry at the beginning.
@@ -282,29 +349,10 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *re
  * So I need to 'adopt' it by changing its parent page id, which needs to be persisted with BufferPoolManger
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyFirstFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager, 
-                                                    const KeyType &middle_key, const int parent_index) {
-  int size = GetSize();
-
-  //Insert into the first position
-  memmove(array + 1, array, size * sizeof(MappingType));
-  array[0] = pair;
-
-  //Change parent page
-  auto parent_page = buffer_pool_manager->FetchPage(GetParentPageId());
-  auto parent_node = reinterpret_cast<BPlusTreeInternalPage *>(parent_page->GetData());
-  array[0].first = middle_key;
-  parent_node->SetKeyAt(parent_index, pair.first);
-
-  //Change child page
-  parent_page = buffer_pool_manager->FetchPage(pair.second);
-  auto child_page = reinterpret_cast<BPlusTreePage *>(parent_page->GetData());
-  child_page->SetParentPageId(GetPageId());
-
-  //unpin pages
-  buffer_pool_manager->UnpinPage(parent_node->GetPageId(), true);
-  buffer_pool_manager->UnpinPage(child_page->GetPageId(), true);
-  IncreaseSize(1); 
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyFirstFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager) {
+  entries_.Insert(0, pair.first, pair.second, GetSize());
+  IncreaseSize(1);
+  Adopt(pair.second, buffer_pool_manager);
 }
 
 // valuetype for internalNode should be page id_t
@@ -313,4 +361,5 @@ template class BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator
 template class BPlusTreeInternalPage<GenericKey<16>, page_id_t, GenericComparator<16>>;
 template class BPlusTreeInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
 template class BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+template class BPlusTreeInternalPage<GenericKey<256>, page_id_t, GenericComparator<256>>;
 }  // namespace bustub
@@ -13,6 +13,7 @@
 #include <string>
 #include <iostream>
 #include <cinttypes>
+#include <vector>
 
 #include "common/exception.h"
 #include "common/rid.h"
@@ -27,7 +28,7 @@ namespace bustub {
 /**
  * Init method after creating a new leaf page
  * Including set page type, set current size to zero, set page id/parent id, set
- * next page id and set max size
+ * next/prev page id and set max size
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
@@ -36,35 +37,74 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, in
   SetPageId(page_id);
   SetParentPageId(parent_id);
   SetNextPageId(INVALID_PAGE_ID);
+  SetPrevPageId(INVALID_PAGE_ID);
   SetMaxSize(max_size);
+  entries_.Init(LEAF_PAGE_SPACE);
 }
 
 /**
- * Methods to set/get next page id
+ * Methods to set/get the page id of the left sibling, INVALID_PAGE_ID for the leftmost leaf
  */
 INDEX_TEMPLATE_ARGUMENTS
-page_id_t B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const { 
-  return next_page_id_; 
-  }
+page_id_t B_PLUS_TREE_LEAF_PAGE_TYPE::GetPrevPageId() const {
+  return prev_page_id_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetPrevPageId(page_id_t prev_page_id) {
+  prev_page_id_ = prev_page_id;
+}
+
+/**
+ * Methods to set/get the high key, which is only valid if there is a next page
+ */
+INDEX_TEMPLATE_ARGUMENTS
+KeyType B_PLUS_TREE_LEAF_PAGE_TYPE::GetHighKey() const {
+  return high_key_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetHighKey(const KeyType &high_key) {
+  high_key_ = high_key;
+}
+
+/**
+ * Methods to set/get the low key, which is only valid if there is a previous page
+ */
+INDEX_TEMPLATE_ARGUMENTS
+KeyType B_PLUS_TREE_LEAF_PAGE_TYPE::GetLowKey() const {
+  return low_key_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetLowKey(const KeyType &low_key) {
+  low_key_ = low_key;
+}
+
+/*
+ * @return whether key belongs to a page to my right, which happens after I have been split
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::IsBeyondHighKey(const KeyType &key, const KeyComparator &comparator) const {
+  return GetNextPageId() != INVALID_PAGE_ID && comparator(key, high_key_) >= 0;
+}
 
+/*
+ * @return whether key lies between my first and last key, so that I am the leaf that holds key if it is in the tree
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
-  next_page_id_ = next_page_id;
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::Covers(const KeyType &key, const KeyComparator &comparator) const {
+  return GetSize() > 0 && comparator(key, KeyAt(0)) >= 0 && comparator(key, KeyAt(GetSize() - 1)) <= 0;
 }
 
 /**
- * Method to find the first index i so that array[i].first >= key
+ * Method to find the first index i so that array[i].first >= key, or GetSize() if all keys are smaller
  * NOTE: This method is primarily useful when constructing an index iterator
  *       that begins at a certain key.
  */
 INDEX_TEMPLATE_ARGUMENTS
-int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const { 
-  for(int i = 0; i < GetSize(); ++i){
-    if(comparator(array[i].first, key) >= 0){
-      return i;
-    }
-  }
-  return GetSize() - 1;
+int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const {
+  return entries_.Search(GetSize(), LEAF_PAGE_SPACE, key, comparator, false);
 }
 
 /*
@@ -72,20 +112,49 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator
  */
 INDEX_TEMPLATE_ARGUMENTS
 KeyType B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const {
-  // replace with your own code (fill in the curly braces with the appropriate key value)
-  KeyType key{
-    array[index].first
-  };
-  return key;
+  return entries_.KeyAt(index);
 }
 
 /*
  * Find and return the key & value pair stored at "index"
  */
 INDEX_TEMPLATE_ARGUMENTS
-const MappingType &B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) {
-  // replace with your own code
-  return array[index];
+MappingType B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) const {
+  return std::make_pair(entries_.KeyAt(index), entries_.ValueAt(index));
+}
+
+/*
+ * Replace the value stored at "index", e.g. when a key of a non-unique tree
+ * gets a posting list
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetValueAt(int index, const ValueType &value) { entries_.SetValueAt(index, value); }
+
+/*
+ * Whether key can be inserted without overflowing the page. A leaf that has no room is split before the insert.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::HasRoomFor(const KeyType &key) const {
+  return entries_.BytesWith(GetSize(), key) <= static_cast<int>(LEAF_PAGE_SPACE);
+}
+
+/*
+ * Whether all entries of sibling can be moved into me, see MoveAllTo.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::CanAbsorb(const BPlusTreeLeafPage *sibling) const {
+  return GetSize() + sibling->GetSize() < GetMaxSize() &&
+         entries_.MergedBytes(GetSize(), sibling->entries_, sibling->GetSize(), nullptr) <=
+             static_cast<int>(LEAF_PAGE_SPACE);
+}
+
+/*
+ * A leaf is underfull if it holds fewer than GetMinSize() entries, unless they fill half of the page anyway, which
+ * happens when the keys do not compress well.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::IsUnderfull() const {
+  return GetSize() < GetMinSize() && entries_.Bytes(GetSize()) < static_cast<int>(LEAF_PAGE_SPACE) / 2;
 }
 
 /*****************************************************************************
@@ -103,8 +172,8 @@ bool B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType *value, co
     return false;
   }
   int key_index = KeyIndex(key, comparator);
-  if(comparator(array[key_index].first, key) == 0){
-    *value = array[key_index].second;
+  if(comparator(KeyAt(key_index), key) == 0){
+    *value = entries_.ValueAt(key_index);
     return true;
   }
   return false;
@@ -115,25 +184,15 @@ bool B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType *value, co
  *****************************************************************************/
 /*
  * Insert key & value pair into leaf page ordered by key
+ * The page must have room for the key, see HasRoomFor.
  * @return  page size after insertion
  */
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) {
-  // Do not need to split here
   int size = GetSize();
-  MappingType new_pair = std::make_pair(key, value);
-  // bigger than the last one
-  if (size == 0 || comparator(key, array[size-1].first) > 0){
-    array[size] = new_pair;
-  } else if (comparator(key, array[0].first) < 0){ // less than the first one
-    memmove(array + 1, array, static_cast<size_t>(GetSize()*sizeof(MappingType)));
-    array[0] = new_pair;
-  } else { 
-    // in the middle of array
-    int new_index = KeyIndex(key, comparator);
-    memmove(array + new_index + 1, array + new_index, static_cast<size_t>((GetSize() - new_index) * sizeof(MappingType)));
-    array[new_index] = new_pair;
-  }
+  // appends, e.g. of increasing keys, skip the search
+  int new_index = size == 0 || comparator(key, KeyAt(size - 1)) > 0 ? size : KeyIndex(key, comparator);
+  entries_.Insert(new_index, key, value, size);
   IncreaseSize(1);
   return size + 1;
 }
@@ -148,21 +207,42 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &valu
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *recipient) {
-  int half = (GetSize() + 1)/2;
-  recipient->CopyNFrom(array + GetSize() - half, half);
+  int half = entries_.HalfCount(GetSize());
+  std::vector<MappingType> items(half);
+  entries_.CopyOut(GetSize() - half, half, items.data());
+  recipient->CopyNFrom(items.data(), half);
   IncreaseSize(-1 * half);
+  // the remaining keys may share a longer prefix
+  entries_.Recompress(GetSize());
 }
 
 /*
- * Private helper method for MoveHalfTo.
- * Copy starting from items, and copy {size} number of elements into me.
+ * Private helper method for MoveHalfTo and MoveAllTo.
+ * Append {size} entries, starting from {items}, to me.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(MappingType *items, int size) {
-  memcpy(array, items, size * sizeof(MappingType));
+void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(const MappingType *items, int size) {
+  entries_.Append(items, size, GetSize());
   IncreaseSize(size);
 }
 
+/*
+ * Append {size} entries, starting from {items}, to me. Used to bulk load the tree: the entries must be sorted by key
+ * and greater than all of my keys, and must fit, see FitCount.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::AppendSorted(const MappingType *items, int size) {
+  CopyNFrom(items, size);
+}
+
+/*
+ * @return the number of leading entries of items, at most size, that fit into an empty leaf page
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_LEAF_PAGE_TYPE::FitCount(const MappingType *items, int size) {
+  return PageEntries<KeyType, ValueType>::FitCount(items, size, LEAF_PAGE_SPACE);
+}
+
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
@@ -181,7 +261,7 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::Remove(const KeyType &key, const KeyComparator &
 
   int key_index = KeyIndex(key, comparator);
   if (comparator(key, KeyAt(key_index)) == 0) {
-    memmove(array + key_index, array + key_index + 1, (size - key_index - 1) * sizeof(MappingType));
+    entries_.Remove(key_index, size);
     IncreaseSize(-1);
     size--;
   }
@@ -195,21 +275,17 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::Remove(const KeyType &key, const KeyComparator &
 /*
  * Remove all of key & value pairs from this page to "recipient" page. Don't forget
  * to update the next_page id in the sibling page
+ * The recipient must have room for them, see CanAbsorb.
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {
-  recipient->CopyAllFrom(array, GetSize());
+  std::vector<MappingType> items(GetSize());
+  entries_.CopyOut(0, GetSize(), items.data());
+  recipient->CopyNFrom(items.data(), GetSize());
   recipient->SetNextPageId(GetNextPageId());
+  recipient->SetHighKey(high_key_);
   SetSize(0);
-}
-
-/*
- * Copy all key & value pairs from items to me
- */
-INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyAllFrom(MappingType *items, int size) {
-    memcpy(array + GetSize(), items, size * sizeof(MappingType));
-    IncreaseSize(size);
+  entries_.Init(LEAF_PAGE_SPACE);
 }
 
 /*****************************************************************************
@@ -220,14 +296,9 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyAllFrom(MappingType *items, int size) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient) {
-  recipient->CopyLastFrom(array[0]);
-  memmove(array, array + 1, (GetSize() - 1) * sizeof(MappingType));
+  recipient->CopyLastFrom(GetItem(0));
+  entries_.Remove(0, GetSize());
   IncreaseSize(-1);
-  // ask Aaron about buffer_poop_manager
-  // auto *page = buffer_pool_manager->FetchPage(GetParentPageId());
-  // auto parent_node = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *>(page->GetData());
-  // parent_node->SetKeyAt(parent_node->ValueIndex(GetPageId()), array[0].first);
-  // buffer_pool_manager->UnpinPage(parent_node->GetPageId(), true);
 }
 
 /*
@@ -235,7 +306,7 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient)
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyLastFrom(const MappingType &item) {
-  array[GetSize()] = item;
+  entries_.Insert(GetSize(), item.first, item.second, GetSize());
   IncreaseSize(1);
 }
 
@@ -244,7 +315,7 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyLastFrom(const MappingType &item) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient) {
-  recipient->CopyFirstFrom(array[GetSize()-1]);
+  recipient->CopyFirstFrom(GetItem(GetSize() - 1));
   IncreaseSize(-1);
 }
 
@@ -253,8 +324,7 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient)
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyFirstFrom(const MappingType &item) {
-  memmove(array + 1, array, GetSize() * sizeof(MappingType));
-  array[0] = item;
+  entries_.Insert(0, item.first, item.second, GetSize());
   IncreaseSize(1);
 }
 
@@ -263,4 +333,5 @@ template class BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeLeafPage<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTreeLeafPage<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTreeLeafPage<GenericKey<64>, RID, GenericComparator<64>>;
+template class BPlusTreeLeafPage<GenericKey<256>, RID, GenericComparator<256>>;
 }  // namespace bustub
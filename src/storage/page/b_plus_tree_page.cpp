@@ -37,9 +37,10 @@ void BPlusTreePage::SetMaxSize(int size) { max_size_ = size; }
 
 /*
  * Helper method to get min page size
- * Generally, min page size == max page size / 2
+ * A leaf page splits as soon as it holds max_size pairs, and an internal page once it holds more than max_size
+ * children, so these are the sizes of the smaller half of a split.
  */
-int BPlusTreePage::GetMinSize() const { return (max_size_ + 1) / 2; }
+int BPlusTreePage::GetMinSize() const { return IsLeafPage() ? max_size_ / 2 : (max_size_ + 1) / 2; }
 
 /*
  * Helper methods to get/set parent page id
@@ -53,6 +54,12 @@ void BPlusTreePage::SetParentPageId(page_id_t parent_page_id) { parent_page_id_
 page_id_t BPlusTreePage::GetPageId() const { return page_id_; }
 void BPlusTreePage::SetPageId(page_id_t page_id) { page_id_ = page_id; }
 
+/*
+ * Helper methods to get/set the page id of the right sibling
+ */
+page_id_t BPlusTreePage::GetNextPageId() const { return next_page_id_; }
+void BPlusTreePage::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
 /*
  * Helper methods to set lsn
  */
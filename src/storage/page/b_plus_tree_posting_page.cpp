@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_posting_page.cpp
+//
+// Identification: src/storage/page/b_plus_tree_posting_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_plus_tree_posting_page.h"
+
+#include <cassert>
+#include <cstring>
+
+namespace bustub {
+
+void BPlusTreePostingPage::Init() {
+  next_page_id_ = INVALID_PAGE_ID;
+  size_ = 0;
+  bytes_ = 0;
+}
+
+int BPlusTreePostingPage::VarintSize(uint64_t delta) {
+  int size = 1;
+  while (delta >= 0x80) {
+    delta >>= 7;
+    size++;
+  }
+  return size;
+}
+
+void BPlusTreePostingPage::GetRids(std::vector<RID> *result) const {
+  if (size_ == 0) {
+    return;
+  }
+  uint64_t value;
+  memcpy(&value, data_, sizeof(value));
+  result->emplace_back(static_cast<page_id_t>(value >> 32), static_cast<uint32_t>(value));
+  const auto *pos = reinterpret_cast<const uint8_t *>(data_) + sizeof(value);
+  for (int i = 1; i < size_; i++) {
+    uint64_t delta = 0;
+    for (int shift = 0;; shift += 7) {
+      uint8_t byte = *pos++;
+      delta |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        break;
+      }
+    }
+    value += delta;
+    result->emplace_back(static_cast<page_id_t>(value >> 32), static_cast<uint32_t>(value));
+  }
+}
+
+void BPlusTreePostingPage::SetRids(const RID *rids, int count) {
+  assert(FitCount(rids, count) == count);
+  size_ = count;
+  bytes_ = 0;
+  if (count == 0) {
+    return;
+  }
+  uint64_t prev = SortKey(rids[0]);
+  memcpy(data_, &prev, sizeof(prev));
+  auto *pos = reinterpret_cast<uint8_t *>(data_) + sizeof(prev);
+  for (int i = 1; i < count; i++) {
+    uint64_t value = SortKey(rids[i]);
+    uint64_t delta = value - prev;
+    while (delta >= 0x80) {
+      *pos++ = static_cast<uint8_t>(delta | 0x80);
+      delta >>= 7;
+    }
+    *pos++ = static_cast<uint8_t>(delta);
+    prev = value;
+  }
+  bytes_ = static_cast<int>(pos - reinterpret_cast<uint8_t *>(data_));
+}
+
+int BPlusTreePostingPage::FitCount(const RID *rids, int count) {
+  if (count == 0) {
+    return 0;
+  }
+  int bytes = sizeof(uint64_t);
+  for (int i = 1; i < count; i++) {
+    bytes += VarintSize(SortKey(rids[i]) - SortKey(rids[i - 1]));
+    if (bytes > static_cast<int>(POSTING_PAGE_SPACE)) {
+      return i;
+    }
+  }
+  return count;
+}
+
+}  // namespace bustub
@@ -0,0 +1,235 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_entries.cpp
+//
+// Identification: src/storage/page/compressed_entries.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/compressed_entries.h"
+
+#include "common/config.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+template <class KeyType, class ValueType>
+int CompressedEntries<KeyType, ValueType>::SignificantSize(const KeyType &key) {
+  const char *bytes = reinterpret_cast<const char *>(&key);
+  int size = KEY_SIZE;
+  while (size > 0 && bytes[size - 1] == 0) {
+    size--;
+  }
+  return size;
+}
+
+template <class KeyType, class ValueType>
+int CompressedEntries<KeyType, ValueType>::CommonPrefix(const char *a, const char *b, int limit) {
+  int size = 0;
+  while (size < limit && a[size] == b[size]) {
+    size++;
+  }
+  return size;
+}
+
+template <class KeyType, class ValueType>
+typename CompressedEntries<KeyType, ValueType>::Layout CompressedEntries<KeyType, ValueType>::LayoutWith(
+    int size, const KeyType &key) const {
+  int key_size = SignificantSize(key);
+  if (size == 0) {
+    return {key_size, key_size};
+  }
+  Layout layout = GetLayout();
+  layout.prefix_size_ = CommonPrefix(prefix_, reinterpret_cast<const char *>(&key), layout.prefix_size_);
+  layout.key_end_ = std::max(layout.key_end_, key_size);
+  return layout;
+}
+
+template <class KeyType, class ValueType>
+int CompressedEntries<KeyType, ValueType>::BytesWith(int size, const KeyType &key) const {
+  return (size + 1) * LayoutWith(size, key).Stride();
+}
+
+template <class KeyType, class ValueType>
+int CompressedEntries<KeyType, ValueType>::MergedBytes(int size, const CompressedEntries &other, int other_size,
+                                                       const KeyType *key) const {
+  // fold the prefixes and key ends of both pages and the key, starting with the first non-empty one
+  const char *prefix = nullptr;
+  Layout layout{0, 0};
+  auto fold = [&prefix, &layout](const char *other_prefix, const Layout &other_layout) {
+    if (prefix == nullptr) {
+      prefix = other_prefix;
+      layout = other_layout;
+      return;
+    }
+    int limit = std::min(layout.prefix_size_, other_layout.prefix_size_);
+    layout.prefix_size_ = CommonPrefix(prefix, other_prefix, limit);
+    layout.key_end_ = std::max(layout.key_end_, other_layout.key_end_);
+  };
+  if (size > 0) {
+    fold(prefix_, GetLayout());
+  }
+  if (other_size > 0) {
+    fold(other.prefix_, other.GetLayout());
+  }
+  if (key != nullptr) {
+    int key_size = SignificantSize(*key);
+    fold(reinterpret_cast<const char *>(key), {key_size, key_size});
+  }
+  return (size + other_size + (key != nullptr ? 1 : 0)) * layout.Stride();
+}
+
+template <class KeyType, class ValueType>
+KeyType CompressedEntries<KeyType, ValueType>::KeyAt(int index, const Layout &layout) const {
+  KeyType key;
+  char *bytes = reinterpret_cast<char *>(&key);
+  memcpy(bytes, prefix_, layout.prefix_size_);
+  memcpy(bytes + layout.prefix_size_, data_ + index * layout.Stride(), layout.key_end_ - layout.prefix_size_);
+  memset(bytes + layout.key_end_, 0, KEY_SIZE - layout.key_end_);
+  return key;
+}
+
+template <class KeyType, class ValueType>
+ValueType CompressedEntries<KeyType, ValueType>::ValueAt(int index, const Layout &layout) const {
+  ValueType value;
+  memcpy(&value, data_ + index * layout.Stride() + layout.key_end_ - layout.prefix_size_, VALUE_SIZE);
+  return value;
+}
+
+template <class KeyType, class ValueType>
+void CompressedEntries<KeyType, ValueType>::SetValueAt(int index, const ValueType &value) {
+  Layout layout = GetLayout();
+  memcpy(data_ + index * layout.Stride() + layout.key_end_ - layout.prefix_size_, &value, VALUE_SIZE);
+}
+
+template <class KeyType, class ValueType>
+void CompressedEntries<KeyType, ValueType>::Encode(int index, const Layout &layout, const KeyType &key,
+                                                   const ValueType &value) {
+  char *slot = data_ + index * layout.Stride();
+  int key_bytes = layout.key_end_ - layout.prefix_size_;
+  memcpy(slot, reinterpret_cast<const char *>(&key) + layout.prefix_size_, key_bytes);
+  memcpy(slot + key_bytes, &value, VALUE_SIZE);
+}
+
+template <class KeyType, class ValueType>
+void CompressedEntries<KeyType, ValueType>::Relayout(const Layout &layout, const char *prefix, int size) {
+  Layout old_layout = GetLayout();
+  if (layout.prefix_size_ != old_layout.prefix_size_ || layout.key_end_ != old_layout.key_end_) {
+    // Decode every entry before its slot is overwritten: walk backwards if the slots grow, forwards if they shrink.
+    bool grow = layout.Stride() > old_layout.Stride();
+    for (int i = 0; i < size; i++) {
+      int index = grow ? size - 1 - i : i;
+      KeyType key = KeyAt(index, old_layout);
+      ValueType value = ValueAt(index, old_layout);
+      Encode(index, layout, key, value);
+    }
+  }
+  memmove(prefix_, prefix, layout.prefix_size_);
+  prefix_size_ = layout.prefix_size_;
+  key_end_ = layout.key_end_;
+}
+
+template <class KeyType, class ValueType>
+void CompressedEntries<KeyType, ValueType>::SetKeyAt(int index, const KeyType &key, int size) {
+  ValueType value = ValueAt(index);
+  Layout layout = LayoutWith(size, key);
+  Relayout(layout, prefix_, size);
+  Encode(index, layout, key, value);
+}
+
+template <class KeyType, class ValueType>
+void CompressedEntries<KeyType, ValueType>::Insert(int index, const KeyType &key, const ValueType &value, int size) {
+  Layout layout = LayoutWith(size, key);
+  Relayout(layout, size == 0 ? reinterpret_cast<const char *>(&key) : prefix_, size);
+  int stride = layout.Stride();
+  memmove(data_ + (index + 1) * stride, data_ + index * stride, (size - index) * stride);
+  Encode(index, layout, key, value);
+}
+
+template <class KeyType, class ValueType>
+void CompressedEntries<KeyType, ValueType>::Remove(int index, int size) {
+  int stride = GetLayout().Stride();
+  memmove(data_ + index * stride, data_ + (index + 1) * stride, (size - index - 1) * stride);
+}
+
+template <class KeyType, class ValueType>
+void CompressedEntries<KeyType, ValueType>::Append(const std::pair<KeyType, ValueType> *items, int count, int size) {
+  if (count == 0) {
+    return;
+  }
+  const char *prefix = size == 0 ? reinterpret_cast<const char *>(&items[0].first) : prefix_;
+  Layout layout = size == 0 ? Layout{KEY_SIZE, 0} : GetLayout();
+  for (int i = 0; i < count; i++) {
+    layout.prefix_size_ = CommonPrefix(prefix, reinterpret_cast<const char *>(&items[i].first), layout.prefix_size_);
+    layout.key_end_ = std::max(layout.key_end_, SignificantSize(items[i].first));
+  }
+  layout.prefix_size_ = std::min(layout.prefix_size_, layout.key_end_);
+  Relayout(layout, prefix, size);
+  for (int i = 0; i < count; i++) {
+    Encode(size + i, layout, items[i].first, items[i].second);
+  }
+}
+
+template <class KeyType, class ValueType>
+void CompressedEntries<KeyType, ValueType>::CopyOut(int from, int count, std::pair<KeyType, ValueType> *items) const {
+  Layout layout = GetLayout();
+  for (int i = 0; i < count; i++) {
+    items[i].first = KeyAt(from + i, layout);
+    items[i].second = ValueAt(from + i, layout);
+  }
+}
+
+template <class KeyType, class ValueType>
+void CompressedEntries<KeyType, ValueType>::Recompress(int size) {
+  if (size == 0) {
+    Init();
+    return;
+  }
+  Layout old_layout = GetLayout();
+  KeyType first_key = KeyAt(0, old_layout);
+  const char *prefix = reinterpret_cast<const char *>(&first_key);
+  Layout layout{KEY_SIZE, 0};
+  for (int i = 0; i < size; i++) {
+    KeyType key = KeyAt(i, old_layout);
+    layout.prefix_size_ = CommonPrefix(prefix, reinterpret_cast<const char *>(&key), layout.prefix_size_);
+    layout.key_end_ = std::max(layout.key_end_, SignificantSize(key));
+  }
+  layout.prefix_size_ = std::min(layout.prefix_size_, layout.key_end_);
+  Relayout(layout, prefix, size);
+}
+
+template <class KeyType, class ValueType>
+int CompressedEntries<KeyType, ValueType>::FitCount(const std::pair<KeyType, ValueType> *items, int count,
+                                                    int space) {
+  if (count == 0) {
+    return 0;
+  }
+  const char *prefix = reinterpret_cast<const char *>(&items[0].first);
+  Layout layout{KEY_SIZE, 0};
+  for (int i = 0; i < count; i++) {
+    layout.prefix_size_ = CommonPrefix(prefix, reinterpret_cast<const char *>(&items[i].first), layout.prefix_size_);
+    layout.key_end_ = std::max(layout.key_end_, SignificantSize(items[i].first));
+    Layout clamped{std::min(layout.prefix_size_, layout.key_end_), layout.key_end_};
+    if ((i + 1) * clamped.Stride() > space) {
+      return i;
+    }
+  }
+  return count;
+}
+
+template class CompressedEntries<GenericKey<4>, RID>;
+template class CompressedEntries<GenericKey<8>, RID>;
+template class CompressedEntries<GenericKey<16>, RID>;
+template class CompressedEntries<GenericKey<32>, RID>;
+template class CompressedEntries<GenericKey<64>, RID>;
+template class CompressedEntries<GenericKey<4>, page_id_t>;
+template class CompressedEntries<GenericKey<8>, page_id_t>;
+template class CompressedEntries<GenericKey<16>, page_id_t>;
+template class CompressedEntries<GenericKey<32>, page_id_t>;
+template class CompressedEntries<GenericKey<64>, page_id_t>;
+
+}  // namespace bustub
@@ -11,36 +11,70 @@
 //===----------------------------------------------------------------------===//
 
 #include "storage/page/hash_table_block_page.h"
+
+#include <algorithm>
+
 #include "storage/index/generic_key.h"
 
 namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 KeyType HASH_TABLE_BLOCK_TYPE::KeyAt(slot_offset_t bucket_ind) const {
-  return {};
+  return array_[bucket_ind].first;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 ValueType HASH_TABLE_BLOCK_TYPE::ValueAt(slot_offset_t bucket_ind) const {
-  return {};
+  return array_[bucket_ind].second;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-bool HASH_TABLE_BLOCK_TYPE::Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value) {
-  return false;
+bool HASH_TABLE_BLOCK_TYPE::Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value,
+                                   uint8_t tag) {
+  const char bit = static_cast<char>(1 << (bucket_ind % 8));
+  if ((occupied_[bucket_ind / 8].fetch_or(bit) & bit) != 0) {
+    return false;
+  }
+  array_[bucket_ind] = MappingType(key, value);
+  tags_[bucket_ind] = tag;
+  readable_[bucket_ind / 8].fetch_or(bit);
+  return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BLOCK_TYPE::Remove(slot_offset_t bucket_ind) {}
+bool HASH_TABLE_BLOCK_TYPE::Reuse(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value,
+                                  uint8_t tag) {
+  if (tags_[bucket_ind] != TOMBSTONE_TAG) {
+    return false;
+  }
+  array_[bucket_ind] = MappingType(key, value);
+  tags_[bucket_ind] = tag;
+  readable_[bucket_ind / 8].fetch_or(static_cast<char>(1 << (bucket_ind % 8)));
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BLOCK_TYPE::Remove(slot_offset_t bucket_ind) {
+  readable_[bucket_ind / 8].fetch_and(static_cast<char>(~(1 << (bucket_ind % 8))));
+  tags_[bucket_ind] = TOMBSTONE_TAG;
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_BLOCK_TYPE::IsOccupied(slot_offset_t bucket_ind) const {
-  return false;
+  return (occupied_[bucket_ind / 8] & (1 << (bucket_ind % 8))) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_BLOCK_TYPE::IsReadable(slot_offset_t bucket_ind) const {
-  return false;
+  return (readable_[bucket_ind / 8] & (1 << (bucket_ind % 8))) != 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_BLOCK_TYPE::MatchTag(slot_offset_t bucket_ind, uint8_t tag, uint32_t *empty) const {
+  const size_t count = std::min<size_t>(GROUP_SIZE, BLOCK_ARRAY_SIZE - bucket_ind);
+  const uint32_t valid = (1U << count) - 1;
+  *empty = MatchTags(tags_ + bucket_ind, EMPTY_TAG) & valid;
+  return MatchTags(tags_ + bucket_ind, tag) & valid;
 }
 
 // DO NOT REMOVE ANYTHING BELOW THIS LINE
@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_bucket_page.cpp
+//
+// Identification: src/storage/page/hash_table_bucket_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/hash_table_bucket_page.h"
+
+#include <algorithm>
+
+#include "common/rid.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <class MatchFunction>
+bool HASH_TABLE_BUCKET_TYPE::ForEachTag(uint8_t tag, MatchFunction &&on_match) const {
+  for (uint32_t group = 0; group < size_; group += TAG_GROUP_SIZE) {
+    uint32_t match = MatchTags(tags_ + group, tag);
+    // the tags behind the last pair are stale or zero
+    const uint32_t count = std::min<uint32_t>(TAG_GROUP_SIZE, size_ - group);
+    match &= static_cast<uint32_t>((uint64_t{1} << count) - 1);
+    for (; match != 0; match &= match - 1) {
+      if (!on_match(group + __builtin_ctz(match))) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_BUCKET_TYPE::GetValue(const KeyType &key, uint8_t tag, KeyComparator comparator,
+                                      std::vector<ValueType> *result) const {
+  bool found = false;
+  ForEachTag(tag, [&](uint32_t index) {
+    if (comparator(array_[index].first, key) == 0) {
+      result->push_back(array_[index].second);
+      found = true;
+    }
+    return true;
+  });
+  return found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+int HASH_TABLE_BUCKET_TYPE::Find(const KeyType &key, const ValueType &value, uint8_t tag,
+                                 KeyComparator comparator) const {
+  int found = -1;
+  ForEachTag(tag, [&](uint32_t index) {
+    if (comparator(array_[index].first, key) == 0 && array_[index].second == value) {
+      found = static_cast<int>(index);
+      return false;
+    }
+    return true;
+  });
+  return found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BUCKET_TYPE::Append(const KeyType &key, const ValueType &value, uint8_t tag) {
+  array_[size_] = MappingType(key, value);
+  tags_[size_] = tag;
+  size_++;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BUCKET_TYPE::RemoveAt(uint32_t index) {
+  size_--;
+  array_[index] = array_[size_];
+  tags_[index] = tags_[size_];
+}
+
+template class HashTableBucketPage<int, int, IntComparator>;
+template class HashTableBucketPage<GenericKey<4>, RID, GenericComparator<4>>;
+template class HashTableBucketPage<GenericKey<8>, RID, GenericComparator<8>>;
+template class HashTableBucketPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class HashTableBucketPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class HashTableBucketPage<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
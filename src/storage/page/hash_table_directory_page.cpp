@@ -0,0 +1,39 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_directory_page.cpp
+//
+// Identification: src/storage/page/hash_table_directory_page.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/hash_table_directory_page.h"
+
+#include <cassert>
+#include <cstring>
+
+namespace bustub {
+
+void HashTableDirectoryPage::IncrGlobalDepth() {
+  assert(global_depth_ < MAX_DEPTH);
+  const uint32_t size = Size();
+  memcpy(local_depths_ + size, local_depths_, size * sizeof(local_depths_[0]));
+  memcpy(bucket_page_ids_ + size, bucket_page_ids_, size * sizeof(bucket_page_ids_[0]));
+  global_depth_++;
+}
+
+void HashTableDirectoryPage::SplitBucket(uint32_t slot, uint32_t local_depth, page_id_t image_page_id) {
+  const uint32_t low_mask = (1U << local_depth) - 1;
+  const uint32_t split_bit = 1U << local_depth;
+  for (uint32_t i = slot & low_mask; i < Size(); i += split_bit) {
+    local_depths_[i] = static_cast<uint8_t>(local_depth + 1);
+    if ((i & split_bit) != 0) {
+      bucket_page_ids_[i] = image_page_id;
+    }
+  }
+}
+
+}  // namespace bustub
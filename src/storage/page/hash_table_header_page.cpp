@@ -13,22 +13,33 @@
 #include "storage/page/hash_table_header_page.h"
 
 namespace bustub {
-page_id_t HashTableHeaderPage::GetBlockPageId(size_t index) { return 0; }
+page_id_t HashTableHeaderPage::GetBlockPageId(size_t index) {
+  assert(index < next_ind_);
+  return block_page_ids_[index].load();
+}
 
-page_id_t HashTableHeaderPage::GetPageId() const { return 0; }
+bool HashTableHeaderPage::ReplaceBlockPageId(size_t index, page_id_t expected, page_id_t page_id) {
+  assert(index < next_ind_);
+  return block_page_ids_[index].compare_exchange_strong(expected, page_id);
+}
 
-void HashTableHeaderPage::SetPageId(bustub::page_id_t page_id) {}
+page_id_t HashTableHeaderPage::GetPageId() const { return page_id_; }
 
-lsn_t HashTableHeaderPage::GetLSN() const { return 0; }
+void HashTableHeaderPage::SetPageId(bustub::page_id_t page_id) { page_id_ = page_id; }
 
-void HashTableHeaderPage::SetLSN(lsn_t lsn) {}
+lsn_t HashTableHeaderPage::GetLSN() const { return lsn_; }
 
-void HashTableHeaderPage::AddBlockPageId(page_id_t page_id) {}
+void HashTableHeaderPage::SetLSN(lsn_t lsn) { lsn_ = lsn; }
 
-size_t HashTableHeaderPage::NumBlocks() { return 0; }
+void HashTableHeaderPage::AddBlockPageId(page_id_t page_id) {
+  assert(next_ind_ < MAX_BLOCKS);
+  block_page_ids_[next_ind_++].store(page_id);
+}
 
-void HashTableHeaderPage::SetSize(size_t size) {}
+size_t HashTableHeaderPage::NumBlocks() { return next_ind_; }
 
-size_t HashTableHeaderPage::GetSize() const { return 0; }
+void HashTableHeaderPage::SetSize(size_t size) { size_ = size; }
+
+size_t HashTableHeaderPage::GetSize() const { return size_; }
 
 }  // namespace bustub
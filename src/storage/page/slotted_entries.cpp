@@ -0,0 +1,178 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// slotted_entries.cpp
+//
+// Identification: src/storage/page/slotted_entries.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/slotted_entries.h"
+
+#include <cstring>
+
+#include "common/config.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+template <class KeyType, class ValueType>
+int SlottedEntries<KeyType, ValueType>::SignificantSize(const KeyType &key) {
+  const char *bytes = reinterpret_cast<const char *>(&key);
+  int size = KEY_SIZE;
+  while (size > 0 && bytes[size - 1] == 0) {
+    size--;
+  }
+  return size;
+}
+
+template <class KeyType, class ValueType>
+std::pair<int, int> SlottedEntries<KeyType, ValueType>::KeyExtent(int index) const {
+  uint16_t offset;
+  uint16_t length;
+  memcpy(&offset, Slot(index), sizeof(offset));
+  memcpy(&length, Slot(index) + sizeof(offset), sizeof(length));
+  int space = space_;
+  int clamped_offset = std::min<int>(offset, space);
+  return {clamped_offset, std::min({static_cast<int>(length), KEY_SIZE, space - clamped_offset})};
+}
+
+template <class KeyType, class ValueType>
+KeyType SlottedEntries<KeyType, ValueType>::KeyAt(int index, const Layout &layout) const {
+  auto [offset, length] = KeyExtent(index);
+  KeyType key;
+  char *bytes = reinterpret_cast<char *>(&key);
+  memcpy(bytes, data_ + offset, length);
+  memset(bytes + length, 0, KEY_SIZE - length);
+  return key;
+}
+
+template <class KeyType, class ValueType>
+ValueType SlottedEntries<KeyType, ValueType>::ValueAt(int index, const Layout &layout) const {
+  ValueType value;
+  memcpy(&value, Slot(index) + 4, VALUE_SIZE);
+  return value;
+}
+
+template <class KeyType, class ValueType>
+void SlottedEntries<KeyType, ValueType>::SetValueAt(int index, const ValueType &value) {
+  memcpy(Slot(index) + 4, &value, VALUE_SIZE);
+}
+
+template <class KeyType, class ValueType>
+void SlottedEntries<KeyType, ValueType>::StoreKey(int index, const KeyType &key, int size) {
+  auto length = static_cast<uint16_t>(SignificantSize(key));
+  if (heap_start_ - size * SLOT_SIZE < length) {
+    Compact(size);
+  }
+  heap_start_ -= length;
+  heap_bytes_ += length;
+  memcpy(data_ + heap_start_, &key, length);
+  memcpy(Slot(index), &heap_start_, sizeof(heap_start_));
+  memcpy(Slot(index) + sizeof(heap_start_), &length, sizeof(length));
+}
+
+template <class KeyType, class ValueType>
+void SlottedEntries<KeyType, ValueType>::Compact(int size) {
+  char heap[PAGE_SIZE];
+  int start = space_;
+  for (int i = 0; i < size; i++) {
+    auto [offset, length] = KeyExtent(i);
+    start -= length;
+    memcpy(heap + start, data_ + offset, length);
+    auto new_offset = static_cast<uint16_t>(start);
+    memcpy(Slot(i), &new_offset, sizeof(new_offset));
+  }
+  memcpy(data_ + start, heap + start, space_ - start);
+  heap_start_ = start;
+  heap_bytes_ = space_ - start;
+}
+
+template <class KeyType, class ValueType>
+void SlottedEntries<KeyType, ValueType>::SetKeyAt(int index, const KeyType &key, int size) {
+  heap_bytes_ -= KeyExtent(index).second;
+  uint16_t length = 0;
+  memcpy(Slot(index) + sizeof(heap_start_), &length, sizeof(length));
+  StoreKey(index, key, size);
+}
+
+template <class KeyType, class ValueType>
+void SlottedEntries<KeyType, ValueType>::Insert(int index, const KeyType &key, const ValueType &value, int size) {
+  if (heap_start_ < (size + 1) * SLOT_SIZE) {
+    Compact(size);
+  }
+  memmove(Slot(index + 1), Slot(index), (size - index) * SLOT_SIZE);
+  uint16_t length = 0;
+  memcpy(Slot(index) + sizeof(heap_start_), &length, sizeof(length));
+  SetValueAt(index, value);
+  StoreKey(index, key, size + 1);
+}
+
+template <class KeyType, class ValueType>
+void SlottedEntries<KeyType, ValueType>::Remove(int index, int size) {
+  if (size == 1) {
+    Init(space_);
+    return;
+  }
+  heap_bytes_ -= KeyExtent(index).second;
+  memmove(Slot(index), Slot(index + 1), (size - index - 1) * SLOT_SIZE);
+}
+
+template <class KeyType, class ValueType>
+void SlottedEntries<KeyType, ValueType>::Append(const std::pair<KeyType, ValueType> *items, int count, int size) {
+  for (int i = 0; i < count; i++) {
+    Insert(size + i, items[i].first, items[i].second, size + i);
+  }
+}
+
+template <class KeyType, class ValueType>
+void SlottedEntries<KeyType, ValueType>::CopyOut(int from, int count, std::pair<KeyType, ValueType> *items) const {
+  for (int i = 0; i < count; i++) {
+    items[i].first = KeyAt(from + i);
+    items[i].second = ValueAt(from + i);
+  }
+}
+
+template <class KeyType, class ValueType>
+void SlottedEntries<KeyType, ValueType>::Recompress(int size) {
+  if (size == 0) {
+    Init(space_);
+    return;
+  }
+  Compact(size);
+}
+
+template <class KeyType, class ValueType>
+int SlottedEntries<KeyType, ValueType>::HalfCount(int size) const {
+  if (size <= 1) {
+    return size;
+  }
+  int total = Bytes(size);
+  int moved = 0;
+  int count = 0;
+  while (count < size - 1 && 2 * moved < total) {
+    moved += SLOT_SIZE + KeyExtent(size - 1 - count).second;
+    count++;
+  }
+  return count;
+}
+
+template <class KeyType, class ValueType>
+int SlottedEntries<KeyType, ValueType>::FitCount(const std::pair<KeyType, ValueType> *items, int count, int space) {
+  int bytes = 0;
+  for (int i = 0; i < count; i++) {
+    bytes += SLOT_SIZE + SignificantSize(items[i].first);
+    if (bytes > space) {
+      return i;
+    }
+  }
+  return count;
+}
+
+template class SlottedEntries<GenericKey<256>, RID>;
+template class SlottedEntries<GenericKey<256>, page_id_t>;
+
+}  // namespace bustub
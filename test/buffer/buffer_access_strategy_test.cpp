@@ -0,0 +1,169 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_access_strategy_test.cpp
+//
+// Identification: test/buffer/buffer_access_strategy_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "concurrency/transaction.h"
+#include "gtest/gtest.h"
+#include "logging/common.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+/** @return true if page_id is resident in one of the pool_size frames starting at pages */
+bool IsResident(Page *pages, size_t pool_size, page_id_t page_id) {
+  for (size_t i = 0; i < pool_size; i++) {
+    if (pages[i].GetPageId() == page_id) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferAccessStrategyTest, ScanKeepsWorkingSetTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  const page_id_t table_pages = 40;
+  const page_id_t hot_pages = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+
+  // Pages [0, table_pages) are a table that gets scanned, the pages after it are the working set of other queries.
+  page_id_t page_id_temp;
+  for (page_id_t i = 0; i < table_pages + hot_pages; i++) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    ASSERT_EQ(i, page_id_temp);
+    snprintf(page->GetData(), PAGE_SIZE, "%d", i);
+    EXPECT_TRUE(bpm->UnpinPage(i, true));
+  }
+
+  // Scenario: a scan with a ring of two frames only ever uses two frames of the pool, so the working set survives.
+  BufferAccessStrategy strategy(2);
+  for (page_id_t i = 0; i < table_pages; i++) {
+    auto *page = bpm->FetchPage(i, &strategy);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(std::to_string(i), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+  for (page_id_t i = table_pages; i < table_pages + hot_pages; i++) {
+    EXPECT_TRUE(IsResident(bpm->GetPages(), buffer_pool_size, i));
+  }
+
+  // Scenario: pinned ring frames are not reused; the scan falls back to the shared pool instead.
+  std::vector<Page *> pinned;
+  for (page_id_t i = 0; i < 4; i++) {
+    pinned.push_back(bpm->FetchPage(i, &strategy));
+    ASSERT_NE(nullptr, pinned.back());
+    EXPECT_EQ(std::to_string(i), std::string(pinned.back()->GetData()));
+  }
+  for (page_id_t i = 0; i < 4; i++) {
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+
+  // Scenario: the same scan without a strategy evicts the working set.
+  for (page_id_t i = 0; i < table_pages; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(i));
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+  for (page_id_t i = table_pages; i < table_pages + hot_pages; i++) {
+    EXPECT_FALSE(IsResident(bpm->GetPages(), buffer_pool_size, i));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferAccessStrategyTest, ParallelBufferPoolManagerTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 5;
+  const size_t num_instances = 2;
+  const page_id_t table_pages = 40;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  for (page_id_t i = 0; i < table_pages; i++) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Ring frames belong to the instance that read the page; every instance only reuses its own frames.
+  BufferAccessStrategy strategy(4);
+  for (int round = 0; round < 2; round++) {
+    for (page_id_t i = 0; i < table_pages; i++) {
+      auto *page = bpm->FetchPage(i, &strategy);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(std::to_string(i), std::string(page->GetData()));
+      EXPECT_TRUE(bpm->UnpinPage(i, false));
+    }
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferAccessStrategyTest, TableHeapScanTest) {
+  Column col1{"a", TypeId::VARCHAR, 20};
+  Column col2{"b", TypeId::BIGINT};
+  std::vector<Column> cols{col1, col2};
+  Schema schema{cols};
+  Tuple tuple = ConstructTuple(&schema);
+
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+  auto *table = new TableHeap(bpm, nullptr, nullptr, transaction);
+
+  const int num_tuples = 5000;
+  for (int i = 0; i < num_tuples; ++i) {
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(tuple, &rid, transaction));
+  }
+
+  // A scan with a ring sees every tuple, just like a scan through the shared pool, also while it reads ahead.
+  bpm->RunPrefetchThreads(2);
+  BufferAccessStrategy strategy(4);
+  int count = 0;
+  for (auto itr = table->Begin(transaction, &strategy); itr != table->End(); ++itr) {
+    count++;
+  }
+  EXPECT_EQ(num_tuples, count);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete table;
+  delete bpm;
+  delete disk_manager;
+  delete transaction;
+}
+
+}  // namespace bustub
@@ -11,9 +11,14 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/buffer_pool_manager.h"
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <iostream>
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 #include "gtest/gtest.h"
 
 namespace bustub {
@@ -161,4 +166,386 @@ TEST(BufferPoolManagerTest, ConcurrentSimplePageTest) {
   }
 }
 
+/** @return true if page_id becomes resident in bpm within a second */
+bool WaitUntilResident(BufferPoolManager *bpm, page_id_t page_id) {
+  for (int i = 0; i < 1000; i++) {
+    for (size_t frame_id = 0; frame_id < bpm->GetPoolSize(); frame_id++) {
+      if (bpm->GetPages()[frame_id].GetPageId() == page_id) {
+        return true;
+      }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return false;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ConcurrentMissTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 8;
+  const int num_threads = 8;
+  const int num_pages = 32;
+  const int num_ops = 2000;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  page_id_t page_id_temp;
+  for (int i = 0; i < num_pages; i++) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // All threads share all pages, so several threads often miss on the same page at once, or fetch a page while its
+  // frame is still being written back or read in. Every page keeps a counter that is only updated under its write
+  // latch; a fetch that returns a frame before its read completed, or that reads a page before its write-back
+  // completed, shows up as a counter that does not match the expected one.
+  std::vector<std::atomic<int>> counts(num_pages);
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([bpm, &counts, tid] {
+      std::mt19937 rng(tid);
+      std::uniform_int_distribution<page_id_t> dist(0, num_pages - 1);
+      for (int i = 0; i < num_ops; i++) {
+        page_id_t page_id = dist(rng);
+        Page *page = nullptr;
+        while ((page = bpm->FetchPage(page_id)) == nullptr) {
+          std::this_thread::yield();
+        }
+        auto *count = reinterpret_cast<int *>(page->GetData());
+        bool is_dirty = i % 4 == 0;
+        if (is_dirty) {
+          page->WLatch();
+          EXPECT_EQ(counts[page_id], *count);
+          *count = ++counts[page_id];
+          page->WUnlatch();
+        } else {
+          page->RLatch();
+          EXPECT_EQ(counts[page_id], *count);
+          page->RUnlatch();
+        }
+        EXPECT_TRUE(bpm->UnpinPage(page_id, is_dirty));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, ConcurrentHitTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 16;
+  const int num_threads = 8;
+  const int num_pages = 20;
+  const int num_ops = 5000;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  page_id_t page_id_temp;
+  for (int i = 0; i < num_pages; i++) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    *reinterpret_cast<page_id_t *>(page->GetData()) = page_id_temp;
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Most fetches are hits, which pin the page without the buffer pool latch, while the misses keep handing frames
+  // over to other pages. A hit that pins a frame just as it is handed over must not return the frame's new page.
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([bpm, tid] {
+      std::mt19937 rng(tid);
+      std::uniform_int_distribution<page_id_t> dist(0, num_pages - 1);
+      for (int i = 0; i < num_ops; i++) {
+        page_id_t page_id = dist(rng);
+        Page *page = nullptr;
+        while ((page = bpm->FetchPage(page_id)) == nullptr) {
+          std::this_thread::yield();
+        }
+        EXPECT_EQ(page_id, page->GetPageId());
+        EXPECT_EQ(page_id, *reinterpret_cast<page_id_t *>(page->GetData()));
+        EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Every frame was unpinned, so every frame can be handed over to a new page.
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    EXPECT_EQ(0, bpm->GetPages()[i].GetPinCount());
+  }
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, PrefetchTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  const page_id_t num_pages = 20;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+
+  // Scenario: prefetch requests are ignored while the prefetch threads are not running.
+  EXPECT_FALSE(bpm->PrefetchPage(0));
+
+  // Write twice as many pages as fit into the pool, so that the first half is evicted.
+  page_id_t page_id_temp;
+  for (page_id_t i = 0; i < num_pages; i++) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+
+  bpm->RunPrefetchThreads(2);
+
+  // Scenario: prefetched pages are read into the pool without being pinned, and have the right contents.
+  bpm->PrefetchRange(0, 5);
+  for (page_id_t i = 0; i < 5; i++) {
+    EXPECT_TRUE(WaitUntilResident(bpm, i));
+  }
+  for (page_id_t i = 0; i < 5; i++) {
+    auto *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(1, page->GetPinCount());
+    EXPECT_EQ(std::to_string(i), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+
+  // Scenario: pages that were never allocated are not prefetched.
+  EXPECT_TRUE(bpm->PrefetchPage(num_pages * 10));
+  EXPECT_FALSE(WaitUntilResident(bpm, num_pages * 10));
+
+  // Scenario: prefetching never takes pinned frames.
+  for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size); i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(i));
+  }
+  bpm->PrefetchRange(buffer_pool_size, 5);
+  bpm->StopPrefetchThreads();
+  for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size); i++) {
+    auto *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(2, page->GetPinCount());
+    EXPECT_EQ(std::to_string(i), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, BackgroundWriterTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "%d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: the background writer cleans the next victims, but no more than it was asked to.
+  bpm->RunBackgroundWriter(buffer_pool_size / 2);
+  for (int i = 0; i < 1000 && bpm->GetNumBackgroundWrites() < buffer_pool_size / 2; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  bpm->StopBackgroundWriter();
+  EXPECT_EQ(buffer_pool_size / 2, bpm->GetNumBackgroundWrites());
+  EXPECT_EQ(0, bpm->GetNumForegroundWrites());
+
+  // Scenario: new pages take the clean frames first, without writing anything.
+  for (size_t i = 0; i < buffer_pool_size / 2; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  }
+  EXPECT_EQ(0, bpm->GetNumForegroundWrites());
+
+  // Scenario: the pages the background writer wrote back can be read back.
+  for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size / 2); i++) {
+    auto *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(std::to_string(i), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+  EXPECT_EQ(buffer_pool_size / 2, bpm->GetNumForegroundWrites());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, BackgroundWriterConcurrentTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 16;
+  const int num_threads = 4;
+  const int num_pages = 64;
+  const int num_ops = 2000;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  page_id_t page_id_temp;
+  for (int i = 0; i < num_pages; i++) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+  bpm->RunBackgroundWriter(buffer_pool_size / 2);
+
+  // Every thread owns the pages congruent to its id and keeps a counter in each of them. The background writer writes
+  // the pages back while they are evicted and dirtied again, so any lost or reordered write shows up as a wrong count.
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([bpm, tid] {
+      std::vector<int> counts(num_pages, 0);
+      std::mt19937 rng(tid);
+      std::uniform_int_distribution<int> dist(0, num_pages / num_threads - 1);
+      for (int i = 0; i < num_ops; i++) {
+        page_id_t page_id = dist(rng) * num_threads + tid;
+        Page *page = nullptr;
+        while ((page = bpm->FetchPage(page_id)) == nullptr) {
+          std::this_thread::yield();
+        }
+        auto *count = reinterpret_cast<int *>(page->GetData());
+        EXPECT_EQ(counts[page_id], *count);
+        *count = ++counts[page_id];
+        EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  bpm->StopBackgroundWriter();
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// Foreground vs. background writes of an update-heavy workload; run with --gtest_also_run_disabled_tests.
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, DISABLED_BackgroundWriterBenchmark) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 256;
+  const int num_pages = 1024;
+  const int num_ops = 20000;
+
+  // Between page accesses, a transaction does some work of its own, during which the background writer can run.
+  for (bool background_writer : {false, true}) {
+    auto *disk_manager = new DiskManager(db_name);
+    auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+    page_id_t page_id_temp;
+    for (int i = 0; i < num_pages; i++) {
+      ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+      EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+    }
+    size_t initial_foreground_writes = bpm->GetNumForegroundWrites();
+    if (background_writer) {
+      bpm->RunBackgroundWriter(buffer_pool_size / 4);
+    }
+
+    std::mt19937 rng(15445);
+    std::uniform_int_distribution<page_id_t> dist(0, num_pages - 1);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_ops; i++) {
+      page_id_t page_id = dist(rng);
+      ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+      EXPECT_TRUE(bpm->UnpinPage(page_id, i % 4 == 0));
+      std::this_thread::sleep_for(std::chrono::microseconds(10));
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    bpm->StopBackgroundWriter();
+
+    std::cout << (background_writer ? "with" : "without") << " background writer: "
+              << bpm->GetNumForegroundWrites() - initial_foreground_writes << " foreground writes, "
+              << bpm->GetNumBackgroundWrites() << " background writes, " << num_ops / elapsed.count() << " ops/s"
+              << std::endl;
+
+    disk_manager->ShutDown();
+    remove("test.db");
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+
+// Cost of a buffer hit (FetchPage + UnpinPage) of resident pages, per replacer and number of threads; run with
+// --gtest_also_run_disabled_tests.
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerTest, DISABLED_HitBenchmark) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 64;
+  const int num_ops = 1000000;
+
+  for (ReplacerPolicy policy : {ReplacerPolicy::LRU, ReplacerPolicy::CLOCK}) {
+    for (int num_threads : {1, 4}) {
+      auto *disk_manager = new DiskManager(db_name);
+      auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, nullptr, policy);
+      page_id_t page_id_temp;
+      for (size_t i = 0; i < buffer_pool_size; i++) {
+        ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+        EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+      }
+
+      auto start = std::chrono::steady_clock::now();
+      std::vector<std::thread> threads;
+      for (int tid = 0; tid < num_threads; tid++) {
+        threads.emplace_back([bpm, tid, num_threads, buffer_pool_size, num_ops] {
+          for (int i = tid; i < num_ops; i += num_threads) {
+            auto page_id = static_cast<page_id_t>(i % buffer_pool_size);
+            bpm->FetchPage(page_id);
+            bpm->UnpinPage(page_id, false);
+          }
+        });
+      }
+      for (auto &thread : threads) {
+        thread.join();
+      }
+      std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+      std::cout << (policy == ReplacerPolicy::LRU ? "LRU" : "CLOCK") << ", " << num_threads
+                << " threads: " << elapsed.count() / num_ops << " ns per hit" << std::endl;
+
+      disk_manager->ShutDown();
+      remove("test.db");
+      delete bpm;
+      delete disk_manager;
+    }
+  }
+}
+
 }  // namespace bustub
@@ -0,0 +1,159 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// clock_replacer_test.cpp
+//
+// Identification: test/buffer/clock_replacer_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/clock_replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(ClockReplacerTest, SampleTest) {
+  ClockReplacer clock_replacer(7);
+
+  // Scenario: unpin six elements, i.e. add them to the replacer.
+  clock_replacer.Unpin(1);
+  clock_replacer.Unpin(2);
+  clock_replacer.Unpin(3);
+  clock_replacer.Unpin(4);
+  clock_replacer.Unpin(5);
+  clock_replacer.Unpin(6);
+  clock_replacer.Unpin(1);
+  EXPECT_EQ(6, clock_replacer.Size());
+
+  // Scenario: get three victims from the clock.
+  int value;
+  clock_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  clock_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+  clock_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+
+  // Scenario: pin elements in the replacer.
+  // Note that 3 has already been victimized, so pinning 3 should have no effect.
+  clock_replacer.Pin(3);
+  clock_replacer.Pin(4);
+  EXPECT_EQ(2, clock_replacer.Size());
+
+  // Scenario: unpin 4. We expect that the reference bit of 4 will be set to 1.
+  clock_replacer.Unpin(4);
+
+  // Scenario: continue looking for victims. We expect these victims.
+  clock_replacer.Victim(&value);
+  EXPECT_EQ(5, value);
+  clock_replacer.Victim(&value);
+  EXPECT_EQ(6, value);
+  clock_replacer.Victim(&value);
+  EXPECT_EQ(4, value);
+  EXPECT_FALSE(clock_replacer.Victim(&value));
+  EXPECT_EQ(0, clock_replacer.Size());
+}
+
+TEST(ClockReplacerTest, PeekVictimsTest) {
+  ClockReplacer clock_replacer(4);
+  clock_replacer.Unpin(0);
+  clock_replacer.Unpin(1);
+  clock_replacer.Unpin(2);
+  clock_replacer.Unpin(3);
+
+  // Sweeping the clock once clears every reference bit and takes frame 0; referencing 2 again gives it a second
+  // chance, so it is peeked last.
+  int value;
+  ASSERT_TRUE(clock_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+  clock_replacer.Unpin(2);
+  EXPECT_EQ((std::vector<frame_id_t>{1, 3, 2}), clock_replacer.PeekVictims(4));
+  EXPECT_EQ((std::vector<frame_id_t>{1}), clock_replacer.PeekVictims(1));
+  EXPECT_EQ(3, clock_replacer.Size());
+}
+
+TEST(ClockReplacerTest, ConcurrentTest) {
+  const int num_frames = 64;
+  const int num_threads = 4;
+  const int num_rounds = 1000;
+  ClockReplacer clock_replacer(num_frames);
+
+  // Every thread owns a disjoint set of frames that it unpins and pins concurrently with the others. In the end every
+  // frame is unpinned, so the clock must hand out each of them exactly once.
+  std::vector<std::thread> threads;
+  std::vector<int> victims(num_frames, 0);
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid] {
+      for (int round = 0; round < num_rounds; round++) {
+        for (int frame_id = tid; frame_id < num_frames; frame_id += num_threads) {
+          clock_replacer.Unpin(frame_id);
+          if (round % 2 == 0) {
+            clock_replacer.Pin(frame_id);
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(num_frames, clock_replacer.Size());
+  int value;
+  while (clock_replacer.Victim(&value)) {
+    victims[value]++;
+  }
+  EXPECT_EQ(0, clock_replacer.Size());
+  for (int frame_id = 0; frame_id < num_frames; frame_id++) {
+    EXPECT_EQ(1, victims[frame_id]);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(ClockReplacerTest, BufferPoolManagerTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, nullptr, ReplacerPolicy::CLOCK);
+
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "%d", page_id_temp);
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+
+  // Scenario: once pages are unpinned, the clock hands their frames out again and their contents survive eviction.
+  for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size); ++i) {
+    EXPECT_TRUE(bpm->UnpinPage(i, true));
+  }
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  }
+  for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size); ++i) {
+    auto *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(std::to_string(i), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
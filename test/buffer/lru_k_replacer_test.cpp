@@ -0,0 +1,200 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer_test.cpp
+//
+// Identification: test/buffer/lru_k_replacer_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(LRUKReplacerTest, SampleTest) {
+  LRUKReplacer lru_k_replacer(7, 2);
+
+  // Scenario: access six frames once, and frame 1 a second time.
+  for (frame_id_t frame_id = 1; frame_id <= 6; frame_id++) {
+    lru_k_replacer.Pin(frame_id);
+    lru_k_replacer.Unpin(frame_id);
+  }
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Unpin(1);
+  EXPECT_EQ(6, lru_k_replacer.Size());
+
+  // Scenario: frames with a single access have an infinite backward k-distance, so they go first, in LRU order,
+  // even though frame 1 was accessed before all of them.
+  int value;
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(4, value);
+
+  // Scenario: pinning frame 5 accesses it a second time and makes it unevictable.
+  lru_k_replacer.Pin(5);
+  EXPECT_EQ(2, lru_k_replacer.Size());
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(6, value);
+
+  // Scenario: frames 1 and 5 both have two accesses. The 2nd most recent access of frame 1 is older than that of
+  // frame 5, so frame 1 is evicted first.
+  lru_k_replacer.Unpin(5);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(5, value);
+  EXPECT_FALSE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(0, lru_k_replacer.Size());
+
+  // Scenario: a victimized frame starts over with an empty history.
+  lru_k_replacer.Pin(2);
+  lru_k_replacer.Unpin(2);
+  lru_k_replacer.Pin(5);
+  lru_k_replacer.Unpin(5);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+
+  // Scenario: removing a frame forgets it.
+  lru_k_replacer.Remove(5);
+  EXPECT_EQ(0, lru_k_replacer.Size());
+  EXPECT_FALSE(lru_k_replacer.Victim(&value));
+}
+
+TEST(LRUKReplacerTest, PeekVictimsTest) {
+  LRUKReplacer lru_k_replacer(4, 2);
+  for (frame_id_t frame_id : {0, 1, 0, 2}) {
+    lru_k_replacer.Pin(frame_id);
+    lru_k_replacer.Unpin(frame_id);
+  }
+
+  // Frames with fewer than k accesses come first.
+  EXPECT_EQ((std::vector<frame_id_t>{1, 2, 0}), lru_k_replacer.PeekVictims(4));
+  EXPECT_EQ((std::vector<frame_id_t>{1, 2}), lru_k_replacer.PeekVictims(2));
+  EXPECT_EQ(3, lru_k_replacer.Size());
+}
+
+// NOLINTNEXTLINE
+TEST(LRUKReplacerTest, BufferPoolManagerTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 3;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager, nullptr, ReplacerPolicy::LRU_K);
+
+  // Scenario: page 0 is fetched twice, pages 1 and 2 only once.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+  ASSERT_NE(nullptr, bpm->FetchPage(0));
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+
+  // Scenario: new pages evict the pages that were only accessed once, so page 0 stays resident.
+  for (size_t i = 0; i < buffer_pool_size - 1; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  }
+  EXPECT_EQ(0, bpm->GetPages()[0].GetPageId());
+
+  // Scenario: deleted pages give their frame back without leaving any history behind.
+  EXPECT_TRUE(bpm->DeletePage(page_id_temp));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+/**
+ * Replays a page access trace against a buffer pool of pool_size frames managed by replacer, the way
+ * BufferPoolManager drives its replacer: every access pins and then unpins the page's frame.
+ * @return the fraction of accesses that hit in the pool
+ */
+double SimulateHitRate(Replacer *replacer, size_t pool_size, const std::vector<page_id_t> &trace) {
+  std::unordered_map<page_id_t, frame_id_t> page_table;
+  std::vector<page_id_t> frame_to_page(pool_size, INVALID_PAGE_ID);
+  std::list<frame_id_t> free_list;
+  for (size_t i = 0; i < pool_size; i++) {
+    free_list.push_back(static_cast<frame_id_t>(i));
+  }
+
+  size_t hits = 0;
+  for (page_id_t page_id : trace) {
+    frame_id_t frame_id;
+    auto it = page_table.find(page_id);
+    if (it != page_table.end()) {
+      hits++;
+      frame_id = it->second;
+    } else {
+      if (!free_list.empty()) {
+        frame_id = free_list.front();
+        free_list.pop_front();
+      } else {
+        EXPECT_TRUE(replacer->Victim(&frame_id));
+        page_table.erase(frame_to_page[frame_id]);
+      }
+      page_table[page_id] = frame_id;
+      frame_to_page[frame_id] = page_id;
+    }
+    replacer->Pin(frame_id);
+    replacer->Unpin(frame_id);
+  }
+  return static_cast<double>(hits) / trace.size();
+}
+
+// Hit rate of an OLTP working set under periodic sequential scans; run with --gtest_also_run_disabled_tests.
+TEST(LRUKReplacerTest, DISABLED_ScanResistanceBenchmark) {
+  const size_t pool_size = 1000;
+  const page_id_t hot_pages = 800;
+  const page_id_t table_pages = 100000;
+  const int num_accesses = 1000000;
+  const int lookups_per_scan_page = 4;
+
+  // Point lookups hit a hot set that fits in the pool; in between, a scan walks sequentially over a large table.
+  std::mt19937 rng(15445);
+  std::uniform_int_distribution<page_id_t> hot_dist(0, hot_pages - 1);
+  std::vector<page_id_t> trace;
+  trace.reserve(num_accesses);
+  page_id_t scan_position = 0;
+  for (int i = 0; i < num_accesses; i++) {
+    if (i % (lookups_per_scan_page + 1) == lookups_per_scan_page) {
+      trace.push_back(hot_pages + scan_position);
+      scan_position = (scan_position + 1) % table_pages;
+    } else {
+      trace.push_back(hot_dist(rng));
+    }
+  }
+
+  LRUReplacer lru_replacer(pool_size);
+  ClockReplacer clock_replacer(pool_size);
+  LRUKReplacer lru_k_replacer(pool_size, 2);
+  std::cout << "policy, hit rate" << std::endl;
+  std::cout << "LRU, " << SimulateHitRate(&lru_replacer, pool_size, trace) << std::endl;
+  std::cout << "CLOCK, " << SimulateHitRate(&clock_replacer, pool_size, trace) << std::endl;
+  std::cout << "LRU-2, " << SimulateHitRate(&lru_k_replacer, pool_size, trace) << std::endl;
+}
+
+}  // namespace bustub
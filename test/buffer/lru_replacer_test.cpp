@@ -10,7 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <iostream>
+#include <random>
 #include <thread>  // NOLINT
 #include <vector>
 
@@ -63,4 +66,98 @@ TEST(LRUReplacerTest, SampleTest) {
   EXPECT_EQ(4, value);
 }
 
+TEST(LRUReplacerTest, PinUnpinOrderTest) {
+  const int num_frames = 1000;
+  LRUReplacer lru_replacer(num_frames);
+
+  for (int i = 0; i < num_frames; i++) {
+    lru_replacer.Unpin(i);
+  }
+  EXPECT_EQ(num_frames, lru_replacer.Size());
+
+  // Scenario: pinning and unpinning the even frames moves them behind the odd ones.
+  for (int i = 0; i < num_frames; i += 2) {
+    lru_replacer.Pin(i);
+  }
+  EXPECT_EQ(num_frames / 2, lru_replacer.Size());
+  for (int i = 0; i < num_frames; i += 2) {
+    lru_replacer.Unpin(i);
+  }
+
+  int value;
+  for (int i = 1; i < num_frames; i += 2) {
+    ASSERT_TRUE(lru_replacer.Victim(&value));
+    EXPECT_EQ(i, value);
+  }
+  for (int i = 0; i < num_frames; i += 2) {
+    ASSERT_TRUE(lru_replacer.Victim(&value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_FALSE(lru_replacer.Victim(&value));
+  EXPECT_EQ(0, lru_replacer.Size());
+
+  // Scenario: pinning a frame the replacer has never seen has no effect.
+  lru_replacer.Pin(num_frames * 2);
+  EXPECT_EQ(0, lru_replacer.Size());
+}
+
+TEST(LRUReplacerTest, PeekVictimsTest) {
+  LRUReplacer lru_replacer(10);
+  lru_replacer.Unpin(3);
+  lru_replacer.Unpin(1);
+  lru_replacer.Unpin(2);
+  lru_replacer.Pin(1);
+
+  EXPECT_EQ((std::vector<frame_id_t>{3}), lru_replacer.PeekVictims(1));
+  EXPECT_EQ((std::vector<frame_id_t>{3, 2}), lru_replacer.PeekVictims(10));
+  // Peeking does not remove anything.
+  EXPECT_EQ(2, lru_replacer.Size());
+}
+
+TEST(LRUReplacerTest, RemoveTest) {
+  LRUReplacer lru_replacer(10);
+  lru_replacer.Unpin(1);
+  lru_replacer.Unpin(2);
+  lru_replacer.Unpin(3);
+
+  // Scenario: removing frames that are not in the list, pinned or never unpinned, has no effect.
+  lru_replacer.Remove(5);
+  lru_replacer.Remove(20);
+  lru_replacer.Pin(2);
+  lru_replacer.Remove(2);
+  EXPECT_EQ(2, lru_replacer.Size());
+
+  // Scenario: removing a frame in the list only takes that frame out.
+  lru_replacer.Remove(1);
+  EXPECT_EQ(1, lru_replacer.Size());
+  int value;
+  EXPECT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(3, value);
+  EXPECT_FALSE(lru_replacer.Victim(&value));
+  EXPECT_EQ(0, lru_replacer.Size());
+}
+
+// Cost of a buffer hit (Pin + Unpin) as the pool grows; run with --gtest_also_run_disabled_tests.
+TEST(LRUReplacerTest, DISABLED_PinUnpinBenchmark) {
+  const int num_ops = 2000000;
+  for (int num_frames : {1000, 100000, 1000000}) {
+    LRUReplacer lru_replacer(num_frames);
+    for (int i = 0; i < num_frames; i++) {
+      lru_replacer.Unpin(i);
+    }
+
+    std::mt19937 rng(num_frames);
+    std::uniform_int_distribution<frame_id_t> dist(0, num_frames - 1);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_ops; i++) {
+      frame_id_t frame_id = dist(rng);
+      lru_replacer.Pin(frame_id);
+      lru_replacer.Unpin(frame_id);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(num_frames, lru_replacer.Size());
+    std::cout << num_frames << " frames: " << elapsed.count() / num_ops << " ns per Pin/Unpin" << std::endl;
+  }
+}
+
 }  // namespace bustub
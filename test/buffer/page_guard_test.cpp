@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_guard_test.cpp
+//
+// Identification: test/buffer/page_guard_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/page_guard.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(PageGuardTest, BasicGuardTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+
+  page_id_t page_id;
+  Page *page;
+  {
+    BasicPageGuard guard = bpm->NewPageGuarded(&page_id);
+    ASSERT_TRUE(guard.IsValid());
+    page = guard.GetPage();
+    EXPECT_EQ(page_id, guard.PageId());
+    EXPECT_EQ(1, page->GetPinCount());
+    std::strcpy(guard.GetDataMut(), "Hello");  // NOLINT
+
+    // Moving the guard moves the pin, it does not take another one.
+    BasicPageGuard moved = std::move(guard);
+    EXPECT_FALSE(guard.IsValid());  // NOLINT
+    EXPECT_EQ(1, page->GetPinCount());
+  }
+  // The guard unpinned the page as dirty when it went out of scope.
+  EXPECT_EQ(0, page->GetPinCount());
+  EXPECT_TRUE(page->IsDirty());
+
+  {
+    BasicPageGuard guard = bpm->FetchPageBasic(page_id);
+    EXPECT_EQ(1, page->GetPinCount());
+    EXPECT_EQ(0, std::strcmp(guard.GetData(), "Hello"));
+
+    // Assigning to a guard releases the pin it held before.
+    guard = bpm->FetchPageBasic(page_id);
+    EXPECT_EQ(1, page->GetPinCount());
+    guard.Drop();
+    EXPECT_EQ(0, page->GetPinCount());
+    guard.Drop();
+    EXPECT_EQ(0, page->GetPinCount());
+  }
+
+  // Every frame can be reused once the guards are gone.
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    page_id_t temp_page_id;
+    EXPECT_TRUE(bpm->NewPageGuarded(&temp_page_id).IsValid());
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(PageGuardTest, LatchGuardTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+
+  page_id_t page_id;
+  Page *page = bpm->NewPage(&page_id);
+  bpm->UnpinPage(page_id, false);
+
+  {
+    WritePageGuard guard = bpm->FetchPageWrite(page_id);
+    EXPECT_EQ(1, page->GetPinCount());
+    std::strcpy(guard.GetDataMut(), "Hello");  // NOLINT
+  }
+  EXPECT_EQ(0, page->GetPinCount());
+  EXPECT_TRUE(page->IsDirty());
+
+  {
+    // Read latches are shared.
+    ReadPageGuard guard1 = bpm->FetchPageRead(page_id);
+    ReadPageGuard guard2 = bpm->FetchPageRead(page_id);
+    EXPECT_EQ(2, page->GetPinCount());
+    EXPECT_EQ(0, std::strcmp(guard1.As<char>(), "Hello"));
+
+    // Moving onto a guard releases the latch and pin it held before.
+    guard1 = std::move(guard2);
+    EXPECT_EQ(1, page->GetPinCount());
+  }
+  EXPECT_EQ(0, page->GetPinCount());
+
+  {
+    BasicPageGuard basic_guard = bpm->FetchPageBasic(page_id);
+    WritePageGuard guard = basic_guard.UpgradeWrite();
+    EXPECT_FALSE(basic_guard.IsValid());  // NOLINT
+    EXPECT_EQ(1, page->GetPinCount());
+  }
+  EXPECT_EQ(0, page->GetPinCount());
+
+  // The guards released the write latch, so it can be taken again.
+  page->WLatch();
+  page->WUnlatch();
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
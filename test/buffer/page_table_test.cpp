@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table_test.cpp
+//
+// Identification: test/buffer/page_table_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <random>
+#include <unordered_map>
+
+#include "buffer/page_table.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(PageTableTest, SampleTest) {
+  PageTable page_table(4);
+  frame_id_t frame_id;
+
+  // Scenario: an empty table finds nothing.
+  EXPECT_FALSE(page_table.Find(0, &frame_id));
+
+  // Scenario: insert a few pages and find them again.
+  page_table.Insert(0, 3);
+  page_table.Insert(7, 1);
+  page_table.Insert(42, 0);
+  EXPECT_TRUE(page_table.Find(7, &frame_id));
+  EXPECT_EQ(1, frame_id);
+  EXPECT_TRUE(page_table.Find(42, &frame_id));
+  EXPECT_EQ(0, frame_id);
+  EXPECT_FALSE(page_table.Find(1, &frame_id));
+
+  // Scenario: inserting a page again remaps it.
+  page_table.Insert(7, 2);
+  EXPECT_TRUE(page_table.Find(7, &frame_id));
+  EXPECT_EQ(2, frame_id);
+
+  // Scenario: erase pages, including one that is not in the table.
+  page_table.Erase(7);
+  page_table.Erase(8);
+  EXPECT_FALSE(page_table.Find(7, &frame_id));
+  EXPECT_TRUE(page_table.Find(0, &frame_id));
+  EXPECT_EQ(3, frame_id);
+  EXPECT_TRUE(page_table.Find(42, &frame_id));
+  EXPECT_EQ(0, frame_id);
+}
+
+TEST(PageTableTest, RandomTest) {
+  // A full table whose entries keep being replaced, as in a buffer pool that keeps evicting pages, so that erases
+  // have to shift entries back across the end of the slot array.
+  const size_t capacity = 64;
+  PageTable page_table(capacity);
+  std::unordered_map<page_id_t, frame_id_t> expected;
+  std::mt19937 rng(15445);
+  std::uniform_int_distribution<page_id_t> dist(0, 1000);
+
+  for (int i = 0; i < 100000; i++) {
+    page_id_t page_id = dist(rng);
+    if (expected.count(page_id) > 0) {
+      page_table.Erase(page_id);
+      expected.erase(page_id);
+    } else if (expected.size() < capacity) {
+      page_table.Insert(page_id, i);
+      expected[page_id] = i;
+    }
+    if (i % 100 == 0) {
+      for (page_id_t other = 0; other <= 1000; other++) {
+        frame_id_t frame_id;
+        ASSERT_EQ(expected.count(other) > 0, page_table.Find(other, &frame_id));
+        if (expected.count(other) > 0) {
+          ASSERT_EQ(expected[other], frame_id);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,195 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager_test.cpp
+//
+// Identification: test/buffer/parallel_buffer_pool_manager_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, SampleTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 5;
+  const size_t num_instances = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+  EXPECT_EQ(buffer_pool_size * num_instances, bpm->GetPoolSize());
+
+  // Scenario: The buffer pool is empty. We should be able to create a new page, and new pages are handed out round
+  // robin, so every instance gets one before any instance gets a second one.
+  page_id_t page_id_temp;
+  auto *page0 = bpm->NewPage(&page_id_temp);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, page_id_temp);
+  snprintf(page0->GetData(), PAGE_SIZE, "Hello");
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+
+  // Scenario: We should be able to create new pages until we fill up the buffer pool.
+  for (size_t i = 1; i < buffer_pool_size * num_instances; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(static_cast<page_id_t>(i), page_id_temp);
+  }
+
+  // Scenario: Once the buffer pool is full, we should not be able to create any new pages.
+  for (size_t i = 0; i < buffer_pool_size * num_instances; ++i) {
+    EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  // Scenario: After unpinning the pages of one instance, only that instance can create new pages, and every page it
+  // creates maps back to it.
+  for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size * num_instances); i += num_instances) {
+    EXPECT_TRUE(bpm->UnpinPage(i, true));
+  }
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, page_id_temp % static_cast<page_id_t>(num_instances));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  }
+
+  // Scenario: We should be able to fetch the data we wrote a while ago.
+  page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+  EXPECT_TRUE(bpm->UnpinPage(0, true));
+
+  // Scenario: Pages that do not exist in any instance cannot be unpinned.
+  EXPECT_FALSE(bpm->UnpinPage(1000, false));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, ConcurrentTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 8;
+  const size_t num_instances = 4;
+  const int num_threads = 8;
+  const int pages_per_thread = 50;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+
+  // Every thread writes its own pages, forcing evictions in every instance, and then reads them all back.
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([bpm, tid] {
+      std::vector<page_id_t> page_ids;
+      for (int i = 0; i < pages_per_thread; i++) {
+        page_id_t page_id;
+        Page *page = nullptr;
+        while ((page = bpm->NewPage(&page_id)) == nullptr) {
+          std::this_thread::yield();
+        }
+        snprintf(page->GetData(), PAGE_SIZE, "%d:%d", tid, page_id);
+        EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+        page_ids.push_back(page_id);
+      }
+      for (auto page_id : page_ids) {
+        Page *page = nullptr;
+        while ((page = bpm->FetchPage(page_id)) == nullptr) {
+          std::this_thread::yield();
+        }
+        EXPECT_EQ(std::to_string(tid) + ":" + std::to_string(page_id), std::string(page->GetData()));
+        EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+/**
+ * Runs num_threads threads that each do num_ops random FetchPage/UnpinPage pairs over num_pages resident pages.
+ * @return the aggregate throughput in operations per second
+ */
+double FetchUnpinThroughput(BufferPoolManager *bpm, int num_pages, int num_threads, int num_ops) {
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  auto start = std::chrono::steady_clock::now();
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([bpm, num_pages, num_ops, tid] {
+      std::mt19937 rng(tid);
+      std::uniform_int_distribution<page_id_t> dist(0, num_pages - 1);
+      for (int i = 0; i < num_ops; i++) {
+        page_id_t page_id = dist(rng);
+        Page *page = bpm->FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        bpm->UnpinPage(page_id, false);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return static_cast<double>(num_threads) * num_ops / elapsed.count();
+}
+
+// Point-lookup throughput of a single latch vs. a sharded pool; run with --gtest_also_run_disabled_tests.
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, DISABLED_FetchUnpinScalingBenchmark) {
+  const std::string db_name = "test.db";
+  const int num_pages = 1024;
+  const size_t num_instances = 16;
+  const int num_ops = 200000;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *single = new BufferPoolManager(num_pages, disk_manager);
+  auto *sharded = new ParallelBufferPoolManager(num_instances, num_pages / num_instances, disk_manager);
+  // Populate both pools so that every fetch is a hit.
+  for (auto *bpm : std::vector<BufferPoolManager *>{single, sharded}) {
+    for (int i = 0; i < num_pages; i++) {
+      page_id_t page_id;
+      ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+      bpm->UnpinPage(page_id, false);
+    }
+  }
+
+  std::cout << "threads, single latch (ops/s), " << num_instances << " instances (ops/s)" << std::endl;
+  for (int num_threads = 1; num_threads <= 32; num_threads *= 2) {
+    double single_ops = FetchUnpinThroughput(single, num_pages, num_threads, num_ops);
+    double sharded_ops = FetchUnpinThroughput(sharded, num_pages, num_threads, num_ops);
+    std::cout << num_threads << ", " << static_cast<uint64_t>(single_ops) << ", " << static_cast<uint64_t>(sharded_ops)
+              << std::endl;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete single;
+  delete sharded;
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -0,0 +1,161 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_util_test.cpp
+//
+// Identification: test/common/hash_util_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <bitset>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+namespace {
+
+/** The shift/xor hash that HashBytes used before, to compare against. */
+hash_t ShiftXorHashBytes(const char *bytes, size_t length) {
+  hash_t hash = length;
+  for (size_t i = 0; i < length; ++i) {
+    hash = ((hash << 5) ^ (hash >> 27)) ^ bytes[i];
+  }
+  return hash;
+}
+
+/** @return the most keys in any of num_buckets buckets, when each key goes to the bucket of bits of its hash */
+size_t MaxBucketLoad(const std::vector<hash_t> &hashes, size_t num_buckets, int shift) {
+  std::vector<size_t> loads(num_buckets);
+  for (hash_t hash : hashes) {
+    loads[(hash >> shift) % num_buckets]++;
+  }
+  return *std::max_element(loads.begin(), loads.end());
+}
+
+std::vector<std::string> EmailKeys(size_t count) {
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < count; i++) {
+    keys.push_back("customer" + std::to_string(i) + "@example.com");
+  }
+  return keys;
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(HashUtilTest, DistributionTest) {
+  const size_t num_keys = 65536;
+  const size_t num_buckets = 1024;
+  // 64 keys per bucket on average; a uniform hash keeps all buckets well below twice that
+  const size_t max_load = 2 * num_keys / num_buckets;
+
+  std::vector<hash_t> integer_hashes;
+  for (size_t i = 0; i < num_keys; i++) {
+    Value value(TypeId::BIGINT, static_cast<int64_t>(i));
+    integer_hashes.push_back(HashUtil::HashValue(&value));
+  }
+  std::vector<hash_t> string_hashes;
+  for (const auto &key : EmailKeys(num_keys)) {
+    Value value(TypeId::VARCHAR, key);
+    string_hashes.push_back(HashUtil::HashValue(&value));
+  }
+  // both the low bits, which pick the buckets of hash tables, and the high bits, which pick their tags
+  for (int shift : {0, 54}) {
+    EXPECT_LT(MaxBucketLoad(integer_hashes, num_buckets, shift), max_load) << "shift " << shift;
+    EXPECT_LT(MaxBucketLoad(string_hashes, num_buckets, shift), max_load) << "shift " << shift;
+  }
+
+  // distinct values of different types combine into distinct hashes
+  std::sort(integer_hashes.begin(), integer_hashes.end());
+  EXPECT_EQ(integer_hashes.end(), std::adjacent_find(integer_hashes.begin(), integer_hashes.end()));
+  EXPECT_NE(HashUtil::CombineHashes(1, 2), HashUtil::CombineHashes(2, 1));
+}
+
+// NOLINTNEXTLINE
+TEST(HashUtilTest, AvalancheTest) {
+  // flipping one bit of the input flips about half of the bits of the hash
+  std::mt19937_64 rng(15445);
+  auto average_flips = [&rng](size_t length, const std::function<hash_t(const char *, size_t)> &hash) {
+    size_t flips = 0;
+    size_t trials = 0;
+    for (int i = 0; i < 200; i++) {
+      std::string bytes(length, 0);
+      for (auto &byte : bytes) {
+        byte = static_cast<char>(rng());
+      }
+      hash_t original = hash(bytes.data(), length);
+      for (size_t bit = 0; bit < 8 * length; bit++) {
+        bytes[bit / 8] ^= static_cast<char>(1 << (bit % 8));
+        flips += std::bitset<64>(original ^ hash(bytes.data(), length)).count();
+        bytes[bit / 8] ^= static_cast<char>(1 << (bit % 8));
+        trials++;
+      }
+    }
+    return static_cast<double>(flips) / trials;
+  };
+  auto hash_word = [](const char *bytes, size_t length) {
+    uint64_t word;
+    memcpy(&word, bytes, sizeof(word));
+    return HashUtil::HashWord(word);
+  };
+  EXPECT_NEAR(32, average_flips(8, hash_word), 1);
+  for (size_t length : {3, 16, 45}) {
+    EXPECT_NEAR(32, average_flips(length, HashUtil::HashBytes), 1) << "length " << length;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(HashUtilTest, DISABLED_HashBytesBenchmark) {
+  // throughput on keys of several lengths
+  for (size_t length : {8, 16, 64, 256}) {
+    std::vector<std::string> keys(4096);
+    std::mt19937 rng(15445);
+    for (auto &key : keys) {
+      for (size_t i = 0; i < length; i++) {
+        key.push_back(static_cast<char>('a' + rng() % 26));
+      }
+    }
+    for (bool murmur : {false, true}) {
+      const int rounds = 1000;
+      hash_t sum = 0;
+      auto start = std::chrono::steady_clock::now();
+      for (int round = 0; round < rounds; round++) {
+        for (const auto &key : keys) {
+          sum += murmur ? HashUtil::HashBytes(key.data(), length) : ShiftXorHashBytes(key.data(), length);
+        }
+      }
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      std::cout << (murmur ? "murmur3" : "shift/xor") << ", " << length << " bytes: "
+                << rounds * keys.size() * length / elapsed.count() / (1 << 20) << " MB/s ("
+                << elapsed.count() * 1e9 / rounds / keys.size() << " ns/key, checksum " << sum % 10 << ")" << std::endl;
+    }
+  }
+
+  // collisions of similar string keys, as a GROUP BY on them meets them in its hash table
+  const size_t num_keys = 1 << 20;
+  const size_t num_buckets = 1 << 16;
+  std::vector<hash_t> shift_xor_hashes;
+  std::vector<hash_t> murmur_hashes;
+  for (const auto &key : EmailKeys(num_keys)) {
+    shift_xor_hashes.push_back(ShiftXorHashBytes(key.data(), key.size()));
+    murmur_hashes.push_back(HashUtil::HashBytes(key.data(), key.size()));
+  }
+  std::cout << "max keys per bucket, " << num_keys / num_buckets << " on average: shift/xor "
+            << MaxBucketLoad(shift_xor_hashes, num_buckets, 0) << ", murmur3 "
+            << MaxBucketLoad(murmur_hashes, num_buckets, 0) << std::endl;
+}
+
+}  // namespace bustub
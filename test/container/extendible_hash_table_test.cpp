@@ -0,0 +1,274 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table_test.cpp
+//
+// Identification: test/container/extendible_hash_table_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/logger.h"
+#include "container/hash/extendible_hash_table.h"
+#include "gtest/gtest.h"
+#include "storage/b_plus_tree_test_util.h"  // NOLINT
+#include "storage/index/extendible_hash_table_index.h"
+#include "storage/index/linear_probe_hash_table_index.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, SampleTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // insert a few values
+  for (int i = 0; i < 5; i++) {
+    ht.Insert(nullptr, i, i);
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(1, res.size()) << "Failed to insert " << i << std::endl;
+    EXPECT_EQ(i, res[0]);
+  }
+
+  // insert one more value for each key
+  for (int i = 0; i < 5; i++) {
+    if (i == 0) {
+      // duplicate values for the same key are not allowed
+      EXPECT_FALSE(ht.Insert(nullptr, i, 2 * i));
+    } else {
+      EXPECT_TRUE(ht.Insert(nullptr, i, 2 * i));
+    }
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    std::sort(res.begin(), res.end());
+    if (i == 0) {
+      EXPECT_EQ((std::vector<int>{0}), res);
+    } else {
+      EXPECT_EQ((std::vector<int>{i, 2 * i}), res);
+    }
+  }
+
+  // look for a key that does not exist
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, 20, &res));
+  EXPECT_EQ(0, res.size());
+
+  // delete some values
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    EXPECT_FALSE(ht.Remove(nullptr, i, i));
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    if (i == 0) {
+      EXPECT_EQ(0, res.size());
+    } else {
+      EXPECT_EQ((std::vector<int>{2 * i}), res);
+    }
+  }
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, SplitTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // two values per key, so that buckets split many times
+  const int num_keys = 20000;
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    EXPECT_TRUE(ht.Insert(nullptr, i, -i - 1));
+  }
+  EXPECT_GT(ht.GetGlobalDepth(), 5);
+
+  for (int i = 0; i < num_keys; i += 2) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    std::sort(res.begin(), res.end());
+    if (i % 2 == 0) {
+      EXPECT_EQ((std::vector<int>{-i - 1}), res);
+    } else {
+      EXPECT_EQ((std::vector<int>{-i - 1, i}), res);
+    }
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, OverflowTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // the values of one key outgrow a bucket many times over, and cannot be split apart, so its bucket overflows, while
+  // the other keys still split their buckets
+  const int num_values = 3000;
+  const int num_keys = 1000;
+  for (int i = 0; i < num_values; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, -1, i));
+    if (i < num_keys) {
+      EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    }
+  }
+  EXPECT_LT(ht.GetGlobalDepth(), 5);
+
+  std::vector<int> res;
+  EXPECT_TRUE(ht.GetValue(nullptr, -1, &res));
+  std::sort(res.begin(), res.end());
+  EXPECT_EQ(num_values, res.size());
+  for (int i = 0; i < static_cast<int>(res.size()); i++) {
+    EXPECT_EQ(i, res[i]);
+  }
+  // duplicates are found in any page of the bucket
+  for (int i = 0; i < num_values; i += 100) {
+    EXPECT_FALSE(ht.Insert(nullptr, -1, i));
+  }
+  for (int i = 0; i < num_keys; i++) {
+    res.clear();
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ((std::vector<int>{i}), res);
+  }
+
+  // removing the values empties the overflow pages, which are unlinked
+  for (int i = 0; i < num_values; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, -1, i));
+    EXPECT_FALSE(ht.Remove(nullptr, -1, i));
+  }
+  res.clear();
+  EXPECT_FALSE(ht.GetValue(nullptr, -1, &res));
+  EXPECT_TRUE(ht.Insert(nullptr, -1, 0));
+  res.clear();
+  EXPECT_TRUE(ht.GetValue(nullptr, -1, &res));
+  EXPECT_EQ((std::vector<int>{0}), res);
+  for (int i = 0; i < num_keys; i++) {
+    res.clear();
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ((std::vector<int>{i}), res);
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, ConcurrentInsertTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // every thread inserts all keys, and exactly one insert of each pair succeeds
+  const int num_threads = 4;
+  const int num_keys = 10000;
+  std::vector<int> inserted(num_threads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&ht, &inserted, t] {
+      for (int i = 0; i < num_keys; i++) {
+        int key = (i * 7 + t * 1000) % num_keys;
+        inserted[t] += static_cast<int>(ht.Insert(nullptr, key, key));
+        std::vector<int> res;
+        EXPECT_TRUE(ht.GetValue(nullptr, key, &res));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  int total = 0;
+  for (int count : inserted) {
+    total += count;
+  }
+  EXPECT_EQ(num_keys, total);
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ((std::vector<int>{i}), res);
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, DISABLED_ConcurrentInsertBenchmark) {
+  Schema *tuple_schema = ParseCreateStatement("a bigint");
+  // as many keys as both tables hold, given the sizes of their directory and header pages
+  const int64_t num_keys = 60000;
+
+  for (size_t num_threads = 1; num_threads <= 8; num_threads *= 2) {
+    for (bool extendible : {false, true}) {
+      auto *disk_manager = new DiskManager("test.db");
+      auto *bpm = new BufferPoolManager(2000, disk_manager);
+      auto *metadata = new IndexMetadata("foo_idx", "foo", tuple_schema, {0});
+      std::unique_ptr<Index> index;
+      if (extendible) {
+        index = std::make_unique<ExtendibleHashTableIndex<GenericKey<8>, RID, GenericComparator<8>>>(
+            metadata, bpm, HashFunction<GenericKey<8>>());
+      } else {
+        index = std::make_unique<LinearProbeHashTableIndex<GenericKey<8>, RID, GenericComparator<8>>>(
+            metadata, bpm, 1000, HashFunction<GenericKey<8>>());
+      }
+      std::vector<Tuple> keys;
+      for (int64_t key = 0; key < num_keys; key++) {
+        keys.emplace_back(std::vector<Value>{Value(TypeId::BIGINT, key)}, index->GetKeySchema());
+      }
+
+      auto start = std::chrono::steady_clock::now();
+      std::vector<std::thread> threads;
+      for (size_t t = 0; t < num_threads; t++) {
+        threads.emplace_back([&index, &keys, t, num_threads] {
+          for (size_t i = t; i < keys.size(); i += num_threads) {
+            index->InsertEntry(keys[i], RID(0, i), nullptr);
+          }
+        });
+      }
+      for (auto &thread : threads) {
+        thread.join();
+      }
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      std::cout << (extendible ? "extendible" : "linear probe") << ", " << num_threads
+                << " threads: " << num_keys / elapsed.count() << " inserts/s" << std::endl;
+
+      index.reset();
+      disk_manager->ShutDown();
+      remove("test.db");
+      delete disk_manager;
+      delete bpm;
+    }
+  }
+  delete tuple_schema;
+}
+
+}  // namespace bustub
@@ -23,7 +23,7 @@
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_HeaderPageSampleTest) {
+TEST(HashTablePageTest, HeaderPageSampleTest) {
   DiskManager *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(5, disk_manager);
 
@@ -61,7 +61,7 @@ TEST(HashTablePageTest, DISABLED_HeaderPageSampleTest) {
 }
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_BlockPageSampleTest) {
+TEST(HashTablePageTest, BlockPageSampleTest) {
   DiskManager *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(5, disk_manager);
 
@@ -111,4 +111,60 @@ TEST(HashTablePageTest, DISABLED_BlockPageSampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, BlockPageTagTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(5, disk_manager);
+
+  page_id_t block_page_id = INVALID_PAGE_ID;
+  using BlockPage = HashTableBlockPage<int, int, IntComparator>;
+  auto block_page = reinterpret_cast<BlockPage *>(bpm->NewPage(&block_page_id)->GetData());
+
+  // a new block is all empty
+  uint32_t empty;
+  EXPECT_EQ(0, block_page->MatchTag(0, BlockPage::TagOf(0), &empty));
+  EXPECT_EQ(0xffff, empty);
+
+  // tag 0x81 in slots 1 and 3, tag 0x82 in slot 2, and slot 3 removed
+  block_page->Insert(1, 1, 1, 0x81);
+  block_page->Insert(2, 2, 2, 0x82);
+  block_page->Insert(3, 3, 3, 0x81);
+  block_page->Remove(3);
+  EXPECT_EQ(0b10, block_page->MatchTag(0, 0x81, &empty));
+  EXPECT_EQ(0xfff1, empty);
+  EXPECT_EQ(0b100, block_page->MatchTag(0, 0x82, &empty));
+  EXPECT_EQ(0b1, block_page->MatchTag(1, 0x81, &empty));
+
+  // the removed slot can be found by its tombstone and reused, but only once
+  EXPECT_EQ(0b1000, block_page->MatchTag(0, BlockPage::TOMBSTONE_TAG, &empty));
+  EXPECT_FALSE(block_page->Reuse(2, 5, 5, 0x81));
+  EXPECT_TRUE(block_page->Reuse(3, 5, 5, 0x81));
+  EXPECT_FALSE(block_page->Reuse(3, 6, 6, 0x81));
+  EXPECT_TRUE(block_page->IsReadable(3));
+  EXPECT_EQ(5, block_page->KeyAt(3));
+  EXPECT_EQ(0b1010, block_page->MatchTag(0, 0x81, &empty));
+  EXPECT_EQ(0, block_page->MatchTag(0, BlockPage::TOMBSTONE_TAG, &empty));
+
+  // groups at the end of the block hold no slots past it
+  using KeyType = int;
+  using ValueType = int;
+  const size_t last = BLOCK_ARRAY_SIZE - 1;
+  block_page->Insert(last, 4, 4, 0x83);
+  EXPECT_EQ(0b1, block_page->MatchTag(last, 0x83, &empty));
+  EXPECT_EQ(0, empty);
+  EXPECT_EQ(0b10, block_page->MatchTag(last - 1, 0x83, &empty));
+  EXPECT_EQ(0b1, empty);
+
+  // the tag takes the top bits of the hash, which the bucket hardly depends on
+  EXPECT_EQ(0x81, BlockPage::TagOf(0x0200000000000000));
+  EXPECT_EQ(0x80, BlockPage::TagOf(1));
+  EXPECT_EQ(0xff, BlockPage::TagOf(UINT64_MAX));
+
+  bpm->UnpinPage(block_page_id, true);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
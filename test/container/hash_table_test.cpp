@@ -10,6 +10,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <random>
 #include <thread>  // NOLINT
 #include <vector>
 
@@ -17,11 +22,13 @@
 #include "container/hash/linear_probe_hash_table.h"
 #include "gtest/gtest.h"
 #include "murmur3/MurmurHash3.h"
+#include "storage/b_plus_tree_test_util.h"  // NOLINT
+#include "storage/index/b_plus_tree.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(HashTableTest, DISABLED_SampleTest) {
+TEST(HashTableTest, SampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(50, disk_manager);
 
@@ -104,4 +111,357 @@ TEST(HashTableTest, DISABLED_SampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTableTest, GrowTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 10, HashFunction<int>());
+  size_t initial_size = ht.GetSize();
+
+  // three values per key, so that the table grows several times
+  const int num_keys = 5000;
+  for (int i = 0; i < num_keys; i++) {
+    for (int j = 0; j < 3; j++) {
+      EXPECT_TRUE(ht.Insert(nullptr, i, 3 * i + j));
+    }
+  }
+  EXPECT_FALSE(ht.Insert(nullptr, 7, 22));
+  EXPECT_GE(ht.GetSize(), 3 * num_keys);
+  EXPECT_GT(ht.GetSize(), initial_size);
+
+  // remove the middle value of each key, which leaves tombstones between the others
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, 3 * i + 1));
+    EXPECT_FALSE(ht.Remove(nullptr, i, 3 * i + 1));
+  }
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    std::sort(res.begin(), res.end());
+    EXPECT_EQ((std::vector<int>{3 * i, 3 * i + 2}), res);
+  }
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, num_keys, &res));
+
+  // an explicit resize keeps all pairs, and drops the tombstones
+  size_t size = ht.GetSize();
+  ht.Resize(size);
+  EXPECT_GE(ht.GetSize(), 2 * size);
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ(2, res.size());
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, TombstoneTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+  size_t initial_size = ht.GetSize();
+  const int num_stable_keys = 100;
+  for (int i = 0; i < num_stable_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+
+  // inserts and removes that keep the number of pairs steady reuse the tombstones, or rebuild the table at its size
+  const int num_keys = 50000;
+  for (int i = num_stable_keys; i < num_stable_keys + num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  EXPECT_EQ(initial_size, ht.GetSize());
+
+  // a key that is removed and inserted again takes its own tombstone
+  for (int j = 0; j < num_keys; j++) {
+    EXPECT_TRUE(ht.Remove(nullptr, 7, 7));
+    EXPECT_TRUE(ht.Insert(nullptr, 7, 7));
+  }
+  EXPECT_EQ(initial_size, ht.GetSize());
+
+  for (int i = 0; i < num_stable_keys + num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_EQ(i < num_stable_keys, ht.GetValue(nullptr, i, &res));
+    if (i < num_stable_keys) {
+      EXPECT_EQ((std::vector<int>{i}), res);
+    }
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, PoolExhaustionTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(10, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+
+  // pin all frames but one, which the header page takes, so that there is none for the first block page
+  std::vector<page_id_t> pinned_page_ids;
+  page_id_t page_id;
+  while (bpm->NewPage(&page_id) != nullptr) {
+    pinned_page_ids.push_back(page_id);
+  }
+  ASSERT_FALSE(pinned_page_ids.empty());
+  bpm->UnpinPage(pinned_page_ids.back(), false);
+  pinned_page_ids.pop_back();
+  EXPECT_FALSE(ht.Insert(nullptr, 1, 1));
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, 1, &res));
+
+  // the failed insert left the table unlatched, so that a resize, which takes the table latch in write mode, goes on
+  for (page_id_t pinned_page_id : pinned_page_ids) {
+    bpm->UnpinPage(pinned_page_id, false);
+  }
+  EXPECT_TRUE(ht.Insert(nullptr, 1, 1));
+  ht.Resize(ht.GetSize());
+  EXPECT_TRUE(ht.Insert(nullptr, 2, 2));
+  for (int i = 1; i <= 2; i++) {
+    res.clear();
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ((std::vector<int>{i}), res);
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, IncrementalResizeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+  const int num_keys = 1000;
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+
+  // the pairs stay where they are until the following writes move them
+  size_t size = ht.GetSize();
+  ht.Resize(size);
+  EXPECT_TRUE(ht.IsResizing());
+  EXPECT_GE(ht.GetSize(), 2 * size);
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ((std::vector<int>{i}), res);
+  }
+
+  // writes during the resize see the pairs of both tables
+  int i = 0;
+  for (; ht.IsResizing(); i++) {
+    EXPECT_FALSE(ht.Insert(nullptr, i, i));
+    EXPECT_TRUE(ht.Insert(nullptr, i, -i - 1));
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ((std::vector<int>{-i - 1}), res);
+  }
+  // each write moves a few groups, so the resize is done after a fraction of the table
+  EXPECT_LT(i, num_keys / 2);
+  EXPECT_GT(i, 0);
+
+  for (int j = 0; j < num_keys; j++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, j, &res));
+    EXPECT_EQ((std::vector<int>{j < i ? -j - 1 : j}), res);
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, ConcurrentInsertLookupTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(200, disk_manager);
+
+  // the table starts out small, so that the inserts resize it several times while the lookups run
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 10, HashFunction<int>());
+  const int num_stable_keys = 500;
+  for (int i = 0; i < num_stable_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+
+  // every writer inserts all new keys, and exactly one insert of each pair succeeds; the readers always find each of
+  // the stable pairs once, also while it moves to a new table
+  const int num_writers = 16;
+  const int num_readers = 4;
+  const int num_keys = 3000;
+  std::vector<int> inserted(num_writers);
+  std::atomic<int> writers_done{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_writers; t++) {
+    threads.emplace_back([&ht, &inserted, &writers_done, t] {
+      for (int i = 0; i < num_keys; i++) {
+        int key = num_stable_keys + (i * 7 + t * 100) % num_keys;
+        inserted[t] += static_cast<int>(ht.Insert(nullptr, key, key));
+        std::vector<int> res;
+        EXPECT_TRUE(ht.GetValue(nullptr, key, &res));
+      }
+      writers_done++;
+    });
+  }
+  for (int t = 0; t < num_readers; t++) {
+    threads.emplace_back([&ht, &writers_done, t] {
+      for (int i = t; writers_done < num_writers; i++) {
+        int key = i % num_stable_keys;
+        std::vector<int> res;
+        EXPECT_TRUE(ht.GetValue(nullptr, key, &res));
+        EXPECT_EQ((std::vector<int>{key}), res);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  int total = 0;
+  for (int count : inserted) {
+    total += count;
+  }
+  EXPECT_EQ(num_keys, total);
+  for (int i = 0; i < num_stable_keys + num_keys; i++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ((std::vector<int>{i}), res);
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_InsertLatencyBenchmark) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(1000, disk_manager);
+
+  // grows from one block to several hundred
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1, HashFunction<int>());
+  const int num_keys = 300000;
+  std::vector<double> latencies;
+  latencies.reserve(num_keys);
+  for (int i = 0; i < num_keys; i++) {
+    auto start = std::chrono::steady_clock::now();
+    ht.Insert(nullptr, i, i);
+    latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+  }
+  std::sort(latencies.begin(), latencies.end());
+  std::cout << "insert latency: p50 " << latencies[num_keys / 2] << " us, p99.9 " << latencies[num_keys * 999 / 1000]
+            << " us, max " << latencies.back() << " us" << std::endl;
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_LookupBenchmark) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(5000, disk_manager);
+
+  // the tree keeps its root in the first page
+  page_id_t page_id;
+  bpm->NewPage(&page_id);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator);
+  // about as many keys as the header page of the hash table has room for at half load
+  const int64_t num_keys = 100000;
+  LinearProbeHashTable<GenericKey<8>, RID, GenericComparator<8>> ht("foo_pk", bpm, comparator, 2 * num_keys,
+                                                                     HashFunction<GenericKey<8>>());
+  std::vector<std::pair<GenericKey<8>, RID>> entries;
+  for (int64_t key = 0; key < num_keys; key++) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(key);
+    entries.emplace_back(index_key, RID(0, key));
+    ht.Insert(nullptr, index_key, RID(0, key));
+  }
+  tree.BulkLoad(entries.begin(), entries.end());
+
+  // look up random keys, half of which do not exist
+  std::mt19937 rng(15445);
+  std::vector<GenericKey<8>> keys(num_keys);
+  for (auto &key : keys) {
+    key.SetFromInteger(static_cast<int64_t>(rng() % (2 * num_keys)));
+  }
+  auto run = [&keys](const char *name, auto lookup) {
+    size_t found = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &key : keys) {
+      std::vector<RID> result;
+      found += static_cast<size_t>(lookup(key, &result));
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << name << ": " << keys.size() / elapsed.count() << " lookups/s, " << found << " found" << std::endl;
+  };
+  run("hash table", [&ht](const GenericKey<8> &key, std::vector<RID> *result) {
+    return ht.GetValue(nullptr, key, result);
+  });
+  run("b+ tree", [&tree](const GenericKey<8> &key, std::vector<RID> *result) {
+    return tree.GetValue(key, result);
+  });
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_ConcurrentBenchmark) {
+  // each thread inserts its share of the keys, and looks up four keys per insert
+  const int num_keys = 200000;
+  for (int num_threads = 1; num_threads <= 16; num_threads *= 2) {
+    auto *disk_manager = new DiskManager("test.db");
+    auto *bpm = new BufferPoolManager(1000, disk_manager);
+    LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < num_threads; t++) {
+      threads.emplace_back([&ht, num_threads, t] {
+        std::mt19937 rng(t);
+        for (int key = t; key < num_keys; key += num_threads) {
+          ht.Insert(nullptr, key, key);
+          for (int j = 0; j < 4; j++) {
+            std::vector<int> res;
+            ht.GetValue(nullptr, static_cast<int>(rng() % (key + 1)), &res);
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << num_threads << " threads: " << 5 * num_keys / elapsed.count() << " operations/s" << std::endl;
+
+    disk_manager->ShutDown();
+    remove("test.db");
+    delete disk_manager;
+    delete bpm;
+  }
+}
+
 }  // namespace bustub
@@ -2,9 +2,14 @@
  * b_plus_tree_test.cpp
  */
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>  // NOLINT
 #include <cstdio>
 #include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
 #include <thread>                   // NOLINT
 #include "b_plus_tree_test_util.h"  // NOLINT
 
@@ -330,4 +335,606 @@ TEST(BPlusTreeConcurrentTest, MixTest) {
   remove("test.log");
 }
 
+TEST(BPlusTreeConcurrentTest, OptimisticReadTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(100, disk_manager);
+  // create b+ tree with small pages, so that the writers keep splitting and merging pages under the readers
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // the even keys stay in the tree, while the writers keep inserting and removing the odd keys around them
+  const int64_t num_keys = 400;
+  std::vector<int64_t> keys;
+  for (int64_t key = 2; key <= num_keys; key += 2) {
+    keys.push_back(key);
+  }
+  InsertHelper(&tree, keys);
+
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int tid = 0; tid < 3; tid++) {
+    readers.emplace_back([&tree, &done, tid] {
+      std::mt19937 rng(tid);
+      std::uniform_int_distribution<int64_t> dist(1, num_keys / 2);
+      GenericKey<8> index_key;
+      std::vector<RID> rids;
+      while (!done) {
+        int64_t key = 2 * dist(rng);
+        rids.clear();
+        index_key.SetFromInteger(key);
+        EXPECT_TRUE(tree.GetValue(index_key, &rids));
+        ASSERT_EQ(1, rids.size());
+        EXPECT_EQ(key, rids[0].GetSlotNum());
+      }
+    });
+  }
+  std::vector<int64_t> odd_keys;
+  for (int64_t key = 1; key < num_keys; key += 2) {
+    odd_keys.push_back(key);
+  }
+  for (int round = 0; round < 5; round++) {
+    LaunchParallelTest(2, InsertHelperSplit, &tree, odd_keys, 2);
+    LaunchParallelTest(2, DeleteHelperSplit, &tree, odd_keys, 2);
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  int64_t current_key = 2;
+  for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+    EXPECT_EQ(current_key, (*iterator).second.GetSlotNum());
+    current_key += 2;
+  }
+  EXPECT_EQ(num_keys + 2, current_key);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeConcurrentTest, BatchTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(100, disk_manager);
+  // create b+ tree with small pages, so that batches keep splitting the leaves they hold
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 8, 8);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // every thread inserts every fourth key in batches of shuffled keys, so that the batches share leaves
+  const int64_t num_keys = 2000;
+  LaunchParallelTest(4, [&tree](uint64_t thread_itr) {
+    std::mt19937 rng(thread_itr);
+    std::vector<std::pair<GenericKey<8>, RID>> batch;
+    for (int64_t key = 1 + thread_itr; key <= num_keys; key += 4) {
+      GenericKey<8> index_key;
+      index_key.SetFromInteger(key);
+      batch.emplace_back(index_key, RID(0, key));
+      if (batch.size() == 50) {
+        std::shuffle(batch.begin(), batch.end(), rng);
+        EXPECT_EQ(50, tree.InsertBatch(&batch));
+        batch.clear();
+      }
+    }
+    EXPECT_EQ(batch.size(), tree.InsertBatch(&batch));
+  });
+
+  // a batch with keys that are there twice, or not at all
+  std::vector<GenericKey<8>> keys;
+  for (int64_t key = 0; key <= num_keys + 1; key++) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(key % 3 == 0 ? key / 3 : key);
+    keys.push_back(index_key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  std::vector<std::vector<RID>> results;
+  tree.GetValues(keys, &results);
+  ASSERT_EQ(keys.size(), results.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    int64_t key = keys[i].ToValue(key_schema, 0).GetAs<int64_t>();
+    if (key < 1 || key > num_keys) {
+      EXPECT_TRUE(results[i].empty());
+      continue;
+    }
+    ASSERT_EQ(1, results[i].size());
+    EXPECT_EQ(key, results[i][0].GetSlotNum());
+  }
+
+  // readers look up batches of even keys while the odd ones are removed around them
+  std::vector<int64_t> odd_keys;
+  for (int64_t key = 1; key <= num_keys; key += 2) {
+    odd_keys.push_back(key);
+  }
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int tid = 0; tid < 2; tid++) {
+    readers.emplace_back([&tree, &done, tid] {
+      std::mt19937 rng(tid);
+      std::uniform_int_distribution<int64_t> dist(1, num_keys / 2 - 20);
+      std::vector<GenericKey<8>> batch(20);
+      std::vector<std::vector<RID>> batch_results;
+      while (!done) {
+        int64_t first = dist(rng);
+        for (int64_t i = 0; i < 20; i++) {
+          batch[i].SetFromInteger(2 * (first + i));
+        }
+        batch_results.clear();
+        tree.GetValues(batch, &batch_results);
+        for (int64_t i = 0; i < 20; i++) {
+          ASSERT_EQ(1, batch_results[i].size());
+          EXPECT_EQ(2 * (first + i), batch_results[i][0].GetSlotNum());
+        }
+      }
+    });
+  }
+  LaunchParallelTest(2, DeleteHelperSplit, &tree, odd_keys, 2);
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  int64_t current_key = 2;
+  for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+    EXPECT_EQ(current_key, (*iterator).second.GetSlotNum());
+    current_key += 2;
+  }
+  EXPECT_EQ(num_keys + 2, current_key);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeConcurrentTest, ReverseScanTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(100, disk_manager);
+  // create b+ tree with small pages, so that the writers keep splitting and merging the leaves under the scans
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // the even keys stay in the tree, while the writers keep inserting and removing the odd keys around them
+  const int64_t num_keys = 400;
+  std::vector<int64_t> keys;
+  for (int64_t key = 2; key <= num_keys; key += 2) {
+    keys.push_back(key);
+  }
+  InsertHelper(&tree, keys);
+
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int tid = 0; tid < 2; tid++) {
+    readers.emplace_back([&tree, &done] {
+      while (!done) {
+        // every scan sees each even key exactly once, in descending order
+        int64_t expected = num_keys;
+        for (auto iterator = tree.RBegin(); iterator != tree.end(); ++iterator) {
+          int64_t key = (*iterator).second.GetSlotNum();
+          if (key % 2 == 0) {
+            ASSERT_EQ(expected, key);
+            expected -= 2;
+          }
+        }
+        EXPECT_EQ(0, expected);
+      }
+    });
+  }
+  std::vector<int64_t> odd_keys;
+  for (int64_t key = 1; key < num_keys; key += 2) {
+    odd_keys.push_back(key);
+  }
+  for (int round = 0; round < 5; round++) {
+    LaunchParallelTest(2, InsertHelperSplit, &tree, odd_keys, 2);
+    LaunchParallelTest(2, DeleteHelperSplit, &tree, odd_keys, 2);
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeConcurrentTest, ForwardScanTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(100, disk_manager);
+  // create b+ tree with small pages, so that the writers keep splitting and merging the leaves under the scans
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // the even keys stay in the tree, while the writers keep inserting and removing the odd keys around them
+  const int64_t num_keys = 400;
+  std::vector<int64_t> keys;
+  for (int64_t key = 2; key <= num_keys; key += 2) {
+    keys.push_back(key);
+  }
+  InsertHelper(&tree, keys);
+
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int tid = 0; tid < 2; tid++) {
+    readers.emplace_back([&tree, &done] {
+      while (!done) {
+        // every scan sees each even key exactly once, in ascending order, although the removes keep merging the leaf
+        // after the one a scan holds into it
+        int64_t expected = 2;
+        for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+          int64_t key = (*iterator).second.GetSlotNum();
+          if (key % 2 == 0) {
+            ASSERT_EQ(expected, key);
+            expected += 2;
+          }
+        }
+        EXPECT_EQ(num_keys + 2, expected);
+      }
+    });
+  }
+  std::vector<int64_t> odd_keys;
+  for (int64_t key = 1; key < num_keys; key += 2) {
+    odd_keys.push_back(key);
+  }
+  for (int round = 0; round < 5; round++) {
+    LaunchParallelTest(2, InsertHelperSplit, &tree, odd_keys, 2);
+    LaunchParallelTest(2, DeleteHelperSplit, &tree, odd_keys, 2);
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeConcurrentTest, ParallelScanTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(100, disk_manager);
+  // create b+ tree with small pages, so that it has a few internal levels to take the separators from
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 16, 8);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int64_t num_keys = 10000;
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= num_keys; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  InsertHelper(&tree, keys);
+
+  GenericKey<8> low;
+  GenericKey<8> high;
+  low.SetFromInteger(100);
+  high.SetFromInteger(9000);
+  const int parts = 4;
+  std::vector<GenericKey<8>> separators = tree.SplitRange(low, high, parts);
+  ASSERT_EQ(parts - 1, separators.size());
+  for (size_t i = 0; i < separators.size(); i++) {
+    EXPECT_LT(0, comparator(separators[i], i == 0 ? low : separators[i - 1]));
+    EXPECT_GT(0, comparator(separators[i], high));
+  }
+
+  // the parts cover the range without overlap, and are about equally large
+  std::vector<std::vector<int64_t>> scanned(parts);
+  tree.ParallelScan(low, high, parts, [&scanned](size_t part, auto iterator) {
+    for (; !iterator.isEnd(); ++iterator) {
+      scanned[part].push_back((*iterator).second.GetSlotNum());
+    }
+  });
+  int64_t current_key = 100;
+  for (const auto &part : scanned) {
+    EXPECT_LT(9000 / parts / 4, part.size());
+    for (auto key : part) {
+      EXPECT_EQ(current_key, key);
+      current_key++;
+    }
+  }
+  EXPECT_EQ(9000, current_key);
+
+  // a range within a single leaf cannot be split
+  high.SetFromInteger(102);
+  EXPECT_TRUE(tree.SplitRange(low, high, parts).empty());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeConcurrentTest, DISABLED_ParallelScanBenchmark) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(5000, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int64_t num_keys = 2000000;
+  std::vector<std::pair<GenericKey<8>, RID>> entries;
+  for (int64_t key = 1; key <= num_keys; key++) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(key);
+    entries.emplace_back(index_key, RID(0, key));
+  }
+  tree.BulkLoad(entries.begin(), entries.end());
+
+  // sum up the values of a range, as a range aggregate does
+  GenericKey<8> low;
+  GenericKey<8> high;
+  low.SetFromInteger(1);
+  high.SetFromInteger(num_keys + 1);
+  for (size_t num_threads = 1; num_threads <= std::thread::hardware_concurrency(); num_threads *= 2) {
+    std::atomic<int64_t> sum{0};
+    auto start = std::chrono::steady_clock::now();
+    tree.ParallelScan(low, high, num_threads, [&sum](size_t part, auto iterator) {
+      int64_t part_sum = 0;
+      for (; !iterator.isEnd(); ++iterator) {
+        part_sum += (*iterator).second.GetSlotNum();
+      }
+      sum += part_sum;
+    });
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(num_keys * (num_keys + 1) / 2, sum);
+    std::cout << num_threads << " threads: " << num_keys / elapsed.count() << " keys/s" << std::endl;
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeConcurrentTest, DISABLED_ReadScalingBenchmark) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(1000, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int64_t num_keys = 100000;
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= num_keys; key++) {
+    keys.push_back(key);
+  }
+  InsertHelper(&tree, keys);
+
+  // point lookups with a trickle of updates, as in a read-mostly index
+  const int num_ops = 200000;
+  for (size_t num_threads = 1; num_threads <= std::thread::hardware_concurrency(); num_threads *= 2) {
+    auto start = std::chrono::steady_clock::now();
+    LaunchParallelTest(num_threads, [&tree](uint64_t thread_itr) {
+      std::mt19937 rng(thread_itr);
+      std::uniform_int_distribution<int64_t> dist(1, num_keys);
+      GenericKey<8> index_key;
+      RID rid;
+      std::vector<RID> rids;
+      for (int i = 0; i < num_ops; i++) {
+        int64_t key = dist(rng);
+        index_key.SetFromInteger(key);
+        if (i % 100 == 0) {
+          tree.Remove(index_key);
+          rid.Set(0, key);
+          tree.Insert(index_key, rid);
+        } else {
+          rids.clear();
+          tree.GetValue(index_key, &rids);
+        }
+      }
+    });
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << num_threads << " threads: " << num_threads * num_ops / elapsed.count() << " ops/s" << std::endl;
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeConcurrentTest, BLinkTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(100, disk_manager);
+  // create b-link tree with small pages, so that the readers keep running into pages that are being split
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4, true);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // the even keys are inserted first, the odd keys by the writers while the readers look up the even keys
+  const int64_t num_keys = 2000;
+  std::vector<int64_t> keys;
+  for (int64_t key = 2; key <= num_keys; key += 2) {
+    keys.push_back(key);
+  }
+  LaunchParallelTest(2, InsertHelperSplit, &tree, keys, 2);
+
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int tid = 0; tid < 2; tid++) {
+    readers.emplace_back([&tree, &done, tid] {
+      std::mt19937 rng(tid);
+      std::uniform_int_distribution<int64_t> dist(1, num_keys / 2);
+      GenericKey<8> index_key;
+      std::vector<RID> rids;
+      while (!done) {
+        int64_t key = 2 * dist(rng);
+        rids.clear();
+        index_key.SetFromInteger(key);
+        EXPECT_TRUE(tree.GetValue(index_key, &rids));
+        ASSERT_EQ(1, rids.size());
+        EXPECT_EQ(key, rids[0].GetSlotNum());
+      }
+    });
+  }
+  std::vector<int64_t> odd_keys;
+  for (int64_t key = 1; key < num_keys; key += 2) {
+    odd_keys.push_back(key);
+  }
+  LaunchParallelTest(4, InsertHelperSplit, &tree, odd_keys, 4);
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  int64_t current_key = 1;
+  for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+    EXPECT_EQ(current_key, (*iterator).second.GetSlotNum());
+    current_key++;
+  }
+  EXPECT_EQ(num_keys + 1, current_key);
+  for (auto iterator = tree.RBegin(); iterator != tree.end(); ++iterator) {
+    current_key--;
+    EXPECT_EQ(current_key, (*iterator).second.GetSlotNum());
+  }
+  EXPECT_EQ(1, current_key);
+
+  // duplicate keys are rejected
+  GenericKey<8> index_key;
+  RID rid;
+  index_key.SetFromInteger(num_keys / 2);
+  rid.Set(0, num_keys / 2);
+  EXPECT_FALSE(tree.Insert(index_key, rid));
+
+  // removes empty the leaves, but leave them in the tree
+  LaunchParallelTest(4, DeleteHelperSplit, &tree, odd_keys, 4);
+  current_key = 2;
+  for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+    EXPECT_EQ(current_key, (*iterator).second.GetSlotNum());
+    current_key += 2;
+  }
+  EXPECT_EQ(num_keys + 2, current_key);
+  std::vector<RID> rids;
+  for (auto key : odd_keys) {
+    index_key.SetFromInteger(key);
+    EXPECT_FALSE(tree.GetValue(index_key, &rids));
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeConcurrentTest, DISABLED_BLinkAppendBenchmark) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  // increasing keys from several threads all split the right most leaf, the worst case for latch crabbing
+  const int64_t num_keys = 200000;
+  for (bool b_link : {false, true}) {
+    for (size_t num_threads = 1; num_threads <= std::thread::hardware_concurrency(); num_threads *= 2) {
+      DiskManager *disk_manager = new DiskManager("test.db");
+      BufferPoolManager *bpm = new BufferPoolManager(5000, disk_manager);
+      // full size pages: the tree clamps the max sizes to what fits into a page
+      BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, std::numeric_limits<int>::max(),
+                                                              std::numeric_limits<int>::max(), b_link);
+      page_id_t page_id;
+      auto header_page = bpm->NewPage(&page_id);
+      (void)header_page;
+
+      std::atomic<int64_t> next_key{1};
+      auto start = std::chrono::steady_clock::now();
+      LaunchParallelTest(num_threads, [&tree, &next_key](uint64_t thread_itr) {
+        GenericKey<8> index_key;
+        RID rid;
+        for (int64_t key = next_key++; key <= num_keys; key = next_key++) {
+          index_key.SetFromInteger(key);
+          rid.Set(0, key);
+          tree.Insert(index_key, rid);
+        }
+      });
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      std::cout << (b_link ? "b-link, " : "crabbing, ") << num_threads
+                << " threads: " << num_keys / elapsed.count() << " inserts/s" << std::endl;
+
+      bpm->UnpinPage(HEADER_PAGE_ID, true);
+      delete disk_manager;
+      delete bpm;
+      remove("test.db");
+      remove("test.log");
+    }
+  }
+  delete key_schema;
+}
+
 }  // namespace bustub
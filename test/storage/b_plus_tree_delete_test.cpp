@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <random>
 
 #include "b_plus_tree_test_util.h"  // NOLINT
 #include "buffer/buffer_pool_manager.h"
@@ -170,4 +171,243 @@ TEST(BPlusTreeTests, DeleteTest2) {
   remove("test.db");
   remove("test.log");
 }
+TEST(BPlusTreeTests, DeleteTest3) {
+  // create KeyComparator and index schema
+  std::string createStmt = "a bigint";
+  Schema *key_schema = ParseCreateStatement(createStmt);
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree with tiny pages, so that every insert and remove splits, merges or redistributes
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 3);
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= 1000; key++) {
+    keys.push_back(key);
+  }
+  std::mt19937 rng(15445);
+  std::shuffle(keys.begin(), keys.end(), rng);
+  for (auto key : keys) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, rid, transaction));
+  }
+
+  // remove every odd key in random order
+  std::shuffle(keys.begin(), keys.end(), rng);
+  for (auto key : keys) {
+    if (key % 2 == 1) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key, transaction);
+    }
+  }
+
+  std::vector<RID> rids;
+  for (int64_t key = 1; key <= 1000; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(key % 2 == 0, tree.GetValue(index_key, &rids));
+  }
+  int64_t current_key = 2;
+  for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key = current_key + 2;
+  }
+  EXPECT_EQ(current_key, 1002);
+
+  // remove the rest, which empties the tree
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+  EXPECT_TRUE(tree.begin() == tree.end());
+
+  // no page of the tree is left pinned
+  for (int i = 1; i < 50; i++) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id));
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, NonUniqueDeleteTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_idx", bpm, comparator, 4, 4, false, false);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // key k has the values (0, k) ... (num_values - 1, k)
+  const int64_t num_keys = 20;
+  const int64_t num_values = 1000;
+  GenericKey<8> index_key;
+  for (int64_t value = 0; value < num_values; value++) {
+    for (int64_t key = 0; key < num_keys; key++) {
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, RID(value, key));
+    }
+  }
+
+  // remove the values of every key in random order, down to a single one; a value that is gone already is
+  // ignored
+  std::vector<int64_t> values;
+  for (int64_t value = 0; value < num_values; value++) {
+    values.push_back(value);
+  }
+  std::shuffle(values.begin(), values.end(), std::mt19937(0));
+  for (size_t i = 0; i + 1 < values.size(); i++) {
+    for (int64_t key = 0; key < num_keys; key++) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key, RID(values[i], key));
+      tree.Remove(index_key, RID(values[i], key));
+    }
+  }
+
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < num_keys; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.GetValue(index_key, &rids));
+    ASSERT_EQ(1, rids.size());
+    EXPECT_EQ(RID(values.back(), key), rids[0]);
+  }
+
+  // removing a key without a value removes all of its values
+  for (int64_t key = 0; key < num_keys; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(num_values, key));
+    tree.Remove(index_key);
+    EXPECT_FALSE(tree.GetValue(index_key, &rids));
+  }
+  for (int64_t key = 1; key < num_keys; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, RID(values.back(), key));
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, RangeIteratorTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // small pages, so that the removes keep merging leaves, which must keep their links in both directions
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int64_t num_keys = 1000;
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= num_keys; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  GenericKey<8> index_key;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, key));
+  }
+  std::vector<int64_t> remaining;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    if (key % 3 == 0) {
+      tree.Remove(index_key);
+    } else {
+      remaining.push_back(key);
+    }
+  }
+  std::sort(remaining.begin(), remaining.end());
+
+  // collects the keys up to the end of an iterator
+  auto collect = [&tree](IndexIterator<GenericKey<8>, RID, GenericComparator<8>> iterator) {
+    std::vector<int64_t> result;
+    for (; iterator != tree.end(); ++iterator) {
+      result.push_back((*iterator).second.GetSlotNum());
+    }
+    return result;
+  };
+  auto key_of = [](int64_t key) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(key);
+    return index_key;
+  };
+
+  EXPECT_EQ(std::vector<int64_t>(remaining.rbegin(), remaining.rend()), collect(tree.RBegin()));
+  // a reverse scan starts at the largest key that is not greater than the start key
+  for (int64_t start : std::vector<int64_t>{1, 2, 3, 300, 301, num_keys, num_keys + 10}) {
+    std::vector<int64_t> expected;
+    for (auto key = remaining.rbegin(); key != remaining.rend(); ++key) {
+      if (*key <= start) {
+        expected.push_back(*key);
+      }
+    }
+    EXPECT_EQ(expected, collect(tree.RBegin(key_of(start))));
+  }
+  // bounded scans return the keys in [low, high) forwards, and in (low, high] backwards
+  for (auto [low, high] : std::vector<std::pair<int64_t, int64_t>>{{1, 2}, {10, 100}, {299, 301}, {500, num_keys}}) {
+    std::vector<int64_t> expected;
+    std::vector<int64_t> expected_reverse;
+    for (auto key : remaining) {
+      if (key >= low && key < high) {
+        expected.push_back(key);
+      }
+      if (key > low && key <= high) {
+        expected_reverse.insert(expected_reverse.begin(), key);
+      }
+    }
+    EXPECT_EQ(expected, collect(tree.Begin(key_of(low), key_of(high))));
+    EXPECT_EQ(expected_reverse, collect(tree.RBegin(key_of(high), key_of(low))));
+  }
+
+  // a bulk loaded tree links its leaves in both directions as well
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> loaded_tree("bar_pk", bpm, comparator, 4, 4);
+  std::vector<std::pair<GenericKey<8>, RID>> entries;
+  for (auto key : remaining) {
+    entries.emplace_back(key_of(key), RID(0, key));
+  }
+  EXPECT_TRUE(loaded_tree.BulkLoad(entries.begin(), entries.end()));
+  std::vector<int64_t> loaded;
+  for (auto iterator = loaded_tree.RBegin(); iterator != loaded_tree.end(); ++iterator) {
+    loaded.push_back((*iterator).second.GetSlotNum());
+  }
+  EXPECT_EQ(std::vector<int64_t>(remaining.rbegin(), remaining.rend()), loaded);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
 }  // namespace bustub
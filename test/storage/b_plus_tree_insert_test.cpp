@@ -3,15 +3,57 @@
  */
 
 #include <algorithm>
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "b_plus_tree_test_util.h"  // NOLINT
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
 #include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_index.h"
 
 namespace bustub {
 
+namespace {
+
+/** @return the index key of a single VARCHAR column */
+template <size_t KeySize = 64>
+GenericKey<KeySize> StringKey(const std::string &value, Schema *key_schema) {
+  Tuple tuple({Value(TypeId::VARCHAR, value)}, key_schema);
+  GenericKey<KeySize> index_key;
+  index_key.SetFromKey(tuple);
+  return index_key;
+}
+
+/** @return the number of levels of the tree index_name, read from its pages */
+int TreeHeight(BufferPoolManager *bpm, const std::string &index_name) {
+  page_id_t page_id;
+  auto header_page = reinterpret_cast<HeaderPage *>(bpm->FetchPage(HEADER_PAGE_ID)->GetData());
+  header_page->GetRootId(index_name, &page_id);
+  bpm->UnpinPage(HEADER_PAGE_ID, false);
+  int height = 1;
+  while (true) {
+    auto node = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(page_id)->GetData());
+    if (node->IsLeafPage()) {
+      bpm->UnpinPage(page_id, false);
+      return height;
+    }
+    page_id_t child_page_id =
+        reinterpret_cast<BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>> *>(node)->ValueAt(0);
+    bpm->UnpinPage(page_id, false);
+    page_id = child_page_id;
+    height++;
+  }
+}
+
+}  // namespace
+
 TEST(BPlusTreeTests, InsertTest1) {
   // create KeyComparator and index schema
   Schema *key_schema = ParseCreateStatement("a bigint");
@@ -139,4 +181,489 @@ TEST(BPlusTreeTests, InsertTest2) {
   remove("test.db");
   remove("test.log");
 }
+TEST(BPlusTreeTests, BulkLoadTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  // as many entries as fit into a page
+  const int page_max_size = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<GenericKey<8>, RID>);
+  for (auto [leaf_max_size, internal_max_size] : {std::make_pair(2, 3), std::make_pair(3, 3), std::make_pair(5, 4),
+                                                  std::make_pair(page_max_size, page_max_size)}) {
+    for (double fill_factor : {1.0, 0.7, 0.0}) {
+      for (int64_t num_keys : {0, 1, 2, 7, 1000}) {
+        DiskManager *disk_manager = new DiskManager("test.db");
+        BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+        BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, leaf_max_size,
+                                                                 internal_max_size);
+        page_id_t page_id;
+        auto header_page = bpm->NewPage(&page_id);
+        (void)header_page;
+
+        // the keys in random order, followed by duplicates of some keys, which must not be loaded
+        std::vector<int64_t> keys;
+        for (int64_t key = 1; key <= num_keys; key++) {
+          keys.push_back(key);
+        }
+        std::shuffle(keys.begin(), keys.end(), std::mt19937(num_keys));
+        std::vector<std::pair<GenericKey<8>, RID>> entries;
+        GenericKey<8> index_key;
+        for (size_t i = 0; i < keys.size() + keys.size() / 3; i++) {
+          int64_t key = keys[i % keys.size()];
+          index_key.SetFromInteger(key);
+          entries.emplace_back(index_key, RID(i < keys.size() ? 0 : 1, key));
+        }
+        ASSERT_TRUE(tree.BulkLoad(entries.begin(), entries.end(), fill_factor));
+        EXPECT_EQ(num_keys == 0, tree.IsEmpty());
+
+        int64_t current_key = 1;
+        for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+          EXPECT_EQ(current_key, (*iterator).first.ToInt64());
+          EXPECT_EQ(0, (*iterator).second.GetPageId());
+          EXPECT_EQ(current_key, (*iterator).second.GetSlotNum());
+          current_key++;
+        }
+        EXPECT_EQ(num_keys + 1, current_key);
+
+        // the loaded tree splits and merges like any other
+        std::vector<RID> rids;
+        for (int64_t key = num_keys + 1; key <= num_keys + 50; key++) {
+          index_key.SetFromInteger(key);
+          EXPECT_TRUE(tree.Insert(index_key, RID(0, key)));
+        }
+        for (int64_t key = num_keys + 50; key >= 1; key--) {
+          rids.clear();
+          index_key.SetFromInteger(key);
+          EXPECT_TRUE(tree.GetValue(index_key, &rids));
+          tree.Remove(index_key);
+        }
+        EXPECT_TRUE(tree.IsEmpty());
+
+        bpm->UnpinPage(HEADER_PAGE_ID, true);
+        delete disk_manager;
+        delete bpm;
+        remove("test.db");
+        remove("test.log");
+      }
+    }
+  }
+  delete key_schema;
+}
+
+TEST(BPlusTreeTests, BulkLoadExternalSortTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // runs of 100 entries, each key twice, in two different runs
+  const int64_t num_keys = 5000;
+  ExternalSorter<GenericKey<8>, RID, GenericComparator<8>> sorter(comparator, 100);
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= num_keys; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  GenericKey<8> index_key;
+  for (int round = 0; round < 2; round++) {
+    for (auto key : keys) {
+      index_key.SetFromInteger(key);
+      sorter.Add(index_key, RID(round, key));
+    }
+  }
+  sorter.Finish();
+  EXPECT_EQ(2 * num_keys / 100, sorter.SpilledRuns());
+  ASSERT_TRUE(tree.BulkLoad(&sorter));
+
+  int64_t current_key = 1;
+  for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+    EXPECT_EQ(current_key, (*iterator).first.ToInt64());
+    EXPECT_EQ(0, (*iterator).second.GetPageId());
+    current_key++;
+  }
+  EXPECT_EQ(num_keys + 1, current_key);
+
+  // only an empty tree can be bulk loaded
+  std::vector<std::pair<GenericKey<8>, RID>> entries(1);
+  EXPECT_FALSE(tree.BulkLoad(entries.begin(), entries.end()));
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, NonUniqueKeyTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(100, disk_manager);
+  // a non-unique tree, and a bulk loaded one to compare with
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_idx", bpm, comparator, 4, 4, false, false);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> loaded_tree("bar_idx", bpm, comparator, 4, 4, false, false);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // a low-cardinality column: row i has key i % num_keys, and a record on table page i, so that the posting lists
+  // compress badly and span several pages
+  const int64_t num_keys = 10;
+  const int64_t num_rows = 20000;
+  std::vector<int64_t> rows;
+  for (int64_t row = 0; row < num_rows; row++) {
+    rows.push_back(row);
+  }
+  std::shuffle(rows.begin(), rows.end(), std::mt19937(0));
+  std::vector<std::pair<GenericKey<8>, RID>> entries;
+  GenericKey<8> index_key;
+  for (auto row : rows) {
+    index_key.SetFromInteger(row % num_keys);
+    EXPECT_TRUE(tree.Insert(index_key, RID(row, 0)));
+    entries.emplace_back(index_key, RID(row, 0));
+  }
+  // a key & value pair is only stored once
+  index_key.SetFromInteger(3);
+  EXPECT_FALSE(tree.Insert(index_key, RID(3, 0)));
+  EXPECT_TRUE(tree.Insert(index_key, RID(3, 1)));
+  tree.Remove(index_key, RID(3, 1));
+  ASSERT_TRUE(loaded_tree.BulkLoad(entries.begin(), entries.end()));
+
+  std::vector<RID> rids;
+  for (auto *index : {&tree, &loaded_tree}) {
+    for (int64_t key = 0; key < num_keys; key++) {
+      rids.clear();
+      index_key.SetFromInteger(key);
+      EXPECT_TRUE(index->GetValue(index_key, &rids));
+      ASSERT_EQ(num_rows / num_keys, rids.size());
+      for (size_t i = 0; i < rids.size(); i++) {
+        EXPECT_EQ(static_cast<page_id_t>(key + i * num_keys), rids[i].GetPageId());
+      }
+    }
+
+    // the iterator returns every value of a key, in order
+    int64_t count = 0;
+    for (auto iterator = index->begin(); iterator != index->end(); ++iterator) {
+      EXPECT_EQ(count / (num_rows / num_keys), (*iterator).first.ToInt64());
+      EXPECT_EQ(count / (num_rows / num_keys), (*iterator).second.GetPageId() % num_keys);
+      count++;
+    }
+    EXPECT_EQ(num_rows, count);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, StringKeyTest) {
+  Schema *key_schema = ParseCreateStatement("a varchar(40)");
+  GenericComparator<64> comparator(key_schema);
+
+  // keys of random length with a common prefix, some of which do not compress well and fill a page before its max size
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<int> length_dist(1, 30);
+  std::uniform_int_distribution<int> char_dist('a', 'z');
+  std::map<std::string, int64_t> keys;
+  while (keys.size() < 3000) {
+    std::string key = "key-";
+    for (int length = length_dist(rng); length > 0; length--) {
+      key += static_cast<char>(char_dist(rng));
+    }
+    keys.emplace(key, keys.size());
+  }
+  std::vector<std::pair<std::string, int64_t>> shuffled(keys.begin(), keys.end());
+  std::shuffle(shuffled.begin(), shuffled.end(), rng);
+
+  // tiny pages, and the largest pages, which the tree clamps to what its pages can hold
+  for (auto [leaf_max_size, internal_max_size] : {std::make_pair(3, 3), std::make_pair(INT32_MAX, INT32_MAX)}) {
+    for (bool bulk_load : {false, true}) {
+      DiskManager *disk_manager = new DiskManager("test.db");
+      BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+      BPlusTree<GenericKey<64>, RID, GenericComparator<64>> tree("foo_pk", bpm, comparator, leaf_max_size,
+                                                                 internal_max_size);
+      page_id_t page_id;
+      auto header_page = bpm->NewPage(&page_id);
+      (void)header_page;
+
+      if (bulk_load) {
+        std::vector<std::pair<GenericKey<64>, RID>> entries;
+        for (const auto &[key, value] : shuffled) {
+          entries.emplace_back(StringKey(key, key_schema), RID(0, value));
+        }
+        ASSERT_TRUE(tree.BulkLoad(entries.begin(), entries.end()));
+      } else {
+        for (const auto &[key, value] : shuffled) {
+          EXPECT_TRUE(tree.Insert(StringKey(key, key_schema), RID(0, value)));
+        }
+      }
+
+      std::vector<RID> rids;
+      for (const auto &[key, value] : shuffled) {
+        rids.clear();
+        ASSERT_TRUE(tree.GetValue(StringKey(key, key_schema), &rids));
+        EXPECT_EQ(value, rids[0].GetSlotNum());
+      }
+      auto expected = keys.begin();
+      for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator, ++expected) {
+        ASSERT_NE(keys.end(), expected);
+        EXPECT_EQ(expected->first, (*iterator).first.ToValue(key_schema, 0).ToString());
+        EXPECT_EQ(expected->second, (*iterator).second.GetSlotNum());
+      }
+      EXPECT_EQ(keys.end(), expected);
+
+      // remove every other key, then the rest, which merges and redistributes pages of different layouts
+      for (size_t i = 0; i < shuffled.size(); i += 2) {
+        tree.Remove(StringKey(shuffled[i].first, key_schema));
+      }
+      for (size_t i = 0; i < shuffled.size(); i++) {
+        rids.clear();
+        EXPECT_EQ(i % 2 == 1, tree.GetValue(StringKey(shuffled[i].first, key_schema), &rids));
+      }
+      for (size_t i = 1; i < shuffled.size(); i += 2) {
+        tree.Remove(StringKey(shuffled[i].first, key_schema));
+      }
+      EXPECT_TRUE(tree.IsEmpty());
+
+      bpm->UnpinPage(HEADER_PAGE_ID, true);
+      delete disk_manager;
+      delete bpm;
+      remove("test.db");
+      remove("test.log");
+    }
+  }
+  delete key_schema;
+}
+
+TEST(BPlusTreeTests, VarcharKeyTest) {
+  Schema *key_schema = ParseCreateStatement("a varchar(250)");
+  GenericComparator<256> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  BPlusTree<GenericKey<256>, RID, GenericComparator<256>> tree("foo_pk", bpm, comparator);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // mostly short e-mail addresses, and now and then a long URL
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<int> char_dist('a', 'z');
+  auto random_string = [&rng, &char_dist](int length) {
+    std::string str;
+    for (; length > 0; length--) {
+      str += static_cast<char>(char_dist(rng));
+    }
+    return str;
+  };
+  std::map<std::string, int64_t> keys;
+  while (keys.size() < 5000) {
+    std::string key = keys.size() % 20 == 0 ? "https://example.com/" + random_string(100 + rng() % 120)
+                                            : random_string(4 + rng() % 12) + "@example.com";
+    keys.emplace(key, keys.size());
+  }
+  std::vector<std::string> order;
+  for (const auto &[key, id] : keys) {
+    order.push_back(key);
+  }
+  std::shuffle(order.begin(), order.end(), rng);
+  for (const auto &key : order) {
+    EXPECT_TRUE(tree.Insert(StringKey<256>(key, key_schema), RID(0, keys[key])));
+  }
+
+  std::vector<RID> rids;
+  for (const auto &[key, id] : keys) {
+    rids.clear();
+    EXPECT_TRUE(tree.GetValue(StringKey<256>(key, key_schema), &rids));
+    ASSERT_EQ(1, rids.size());
+    EXPECT_EQ(id, rids[0].GetSlotNum());
+  }
+  auto expected = keys.begin();
+  for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator, ++expected) {
+    ASSERT_NE(keys.end(), expected);
+    EXPECT_EQ(expected->first, (*iterator).first.ToValue(key_schema, 0).ToString());
+  }
+  EXPECT_EQ(keys.end(), expected);
+
+  // removes keep the heaps of the pages compact enough to merge them
+  for (size_t i = 0; i < order.size(); i += 2) {
+    tree.Remove(StringKey<256>(order[i], key_schema));
+  }
+  for (size_t i = 0; i < order.size(); i++) {
+    rids.clear();
+    EXPECT_EQ(i % 2 == 1, tree.GetValue(StringKey<256>(order[i], key_schema), &rids));
+  }
+  for (size_t i = 1; i < order.size(); i += 2) {
+    tree.Remove(StringKey<256>(order[i], key_schema));
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, VarcharIndexTest) {
+  Schema *tuple_schema = ParseCreateStatement("a varchar(1000)");
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  std::unique_ptr<Index> index =
+      CreateBPlusTreeIndex(new IndexMetadata("foo_idx", "foo", tuple_schema, {0}), bpm);
+  auto key_tuple = [&index](const std::string &value) {
+    return Tuple({Value(TypeId::VARCHAR, value)}, index->GetKeySchema());
+  };
+  // keys that are too long are rejected rather than indexed by a prefix that other keys share
+  std::string prefix(300, 'x');
+  index->InsertEntry(key_tuple("short"), RID(0, 0), nullptr);
+  index->InsertEntry(key_tuple(prefix.substr(0, 200)), RID(0, 1), nullptr);
+  EXPECT_THROW(index->InsertEntry(key_tuple(prefix + "a"), RID(0, 2), nullptr), Exception);
+
+  std::vector<RID> rids;
+  index->ScanKey(key_tuple("short"), &rids, nullptr);
+  ASSERT_EQ(1, rids.size());
+  EXPECT_EQ(0, rids[0].GetSlotNum());
+  rids.clear();
+  index->ScanKey(key_tuple(prefix.substr(0, 200)), &rids, nullptr);
+  ASSERT_EQ(1, rids.size());
+  EXPECT_EQ(1, rids[0].GetSlotNum());
+  rids.clear();
+  index->ScanKey(key_tuple(prefix + "a"), &rids, nullptr);
+  EXPECT_TRUE(rids.empty());
+  index->DeleteEntry(key_tuple(prefix + "a"), RID(0, 2), nullptr);
+
+  std::vector<std::vector<RID>> results;
+  index->ScanKeys({key_tuple(prefix + "a"), key_tuple("short")}, &results, nullptr);
+  ASSERT_EQ(2, results.size());
+  EXPECT_TRUE(results[0].empty());
+  ASSERT_EQ(1, results[1].size());
+  EXPECT_EQ(0, results[1][0].GetSlotNum());
+
+  // a batch with a key that is too long is rejected as a whole
+  EXPECT_THROW(
+      index->InsertEntries({{key_tuple("batch"), RID(0, 3)}, {key_tuple(prefix + "b"), RID(0, 4)}}, nullptr),
+      Exception);
+  rids.clear();
+  index->ScanKey(key_tuple("batch"), &rids, nullptr);
+  EXPECT_TRUE(rids.empty());
+
+  // the cap counts the serialized tuple: the 12-byte inlined column, a 4-byte length and the string with its NUL
+  index->InsertEntry(key_tuple(std::string(239, 'y')), RID(0, 5), nullptr);
+  EXPECT_THROW(index->InsertEntry(key_tuple(std::string(240, 'y')), RID(0, 6), nullptr), Exception);
+  rids.clear();
+  index->ScanKey(key_tuple(std::string(239, 'y')), &rids, nullptr);
+  ASSERT_EQ(1, rids.size());
+  EXPECT_EQ(5, rids[0].GetSlotNum());
+
+  index.reset();
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete tuple_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, DISABLED_StringKeyBenchmark) {
+  Schema *key_schema = ParseCreateStatement("a varchar(40)");
+  GenericComparator<64> comparator(key_schema);
+
+  const int64_t num_keys = 200000;
+  std::vector<std::pair<GenericKey<64>, RID>> entries;
+  char key[32];
+  for (int64_t i = 0; i < num_keys; i++) {
+    snprintf(key, sizeof(key), "customer#%09ld", static_cast<long>(i * 7));  // NOLINT
+    entries.emplace_back(StringKey(key, key_schema), RID(0, i));
+  }
+  std::shuffle(entries.begin(), entries.end(), std::mt19937(0));
+
+  // as many entries as fit into a page uncompressed, which is what pages held before they were compressed
+  const int leaf_slots = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<GenericKey<64>, RID>);
+  const int internal_slots = (PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / sizeof(std::pair<GenericKey<64>, page_id_t>);
+  for (bool compressed : {false, true}) {
+    DiskManager *disk_manager = new DiskManager("test.db");
+    BufferPoolManager *bpm = new BufferPoolManager(5000, disk_manager);
+    BPlusTree<GenericKey<64>, RID, GenericComparator<64>> tree(
+        "foo_pk", bpm, comparator, compressed ? INT32_MAX : leaf_slots, compressed ? INT32_MAX : internal_slots - 1);
+    page_id_t page_id;
+    auto header_page = bpm->NewPage(&page_id);
+    (void)header_page;
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    for (const auto &entry : entries) {
+      tree.Insert(entry.first, entry.second);
+    }
+
+    std::vector<RID> rids;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &entry : entries) {
+      rids.clear();
+      tree.GetValue(entry.first, &rids);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << (compressed ? "compressed" : "uncompressed") << ": height " << TreeHeight(bpm, "foo_pk") << ", "
+              << elapsed.count() * 1e9 / num_keys << " ns/lookup" << std::endl;
+
+    delete disk_manager;
+    delete bpm;
+    remove("test.db");
+    remove("test.log");
+  }
+  delete key_schema;
+}
+
+TEST(BPlusTreeTests, DISABLED_BulkLoadBenchmark) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  const int64_t num_keys = 1000000;
+  std::vector<std::pair<GenericKey<8>, RID>> entries(num_keys);
+  for (int64_t key = 1; key <= num_keys; key++) {
+    entries[key - 1].first.SetFromInteger(key);
+    entries[key - 1].second = RID(0, key);
+  }
+  std::shuffle(entries.begin(), entries.end(), std::mt19937(0));
+
+  for (bool bulk_load : {false, true}) {
+    DiskManager *disk_manager = new DiskManager("test.db");
+    BufferPoolManager *bpm = new BufferPoolManager(1000, disk_manager);
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator);
+    page_id_t page_id;
+    auto header_page = bpm->NewPage(&page_id);
+    (void)header_page;
+
+    auto start = std::chrono::steady_clock::now();
+    if (bulk_load) {
+      tree.BulkLoad(entries.begin(), entries.end());
+    } else {
+      for (const auto &entry : entries) {
+        tree.Insert(entry.first, entry.second);
+      }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << (bulk_load ? "bulk load: " : "insert: ") << num_keys / elapsed.count() << " keys/s" << std::endl;
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete disk_manager;
+    delete bpm;
+    remove("test.db");
+    remove("test.log");
+  }
+  delete key_schema;
+}
+
 }  // namespace bustub
@@ -0,0 +1,225 @@
+/**
+ * b_plus_tree_page_test.cpp
+ */
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "gtest/gtest.h"
+#include "storage/index/key_search.h"
+#include "storage/page/b_plus_tree_internal_page.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+namespace bustub {
+
+using LeafPage = BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
+using InternalPage = BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
+
+namespace {
+
+/** Fills leaf with the given sorted keys. */
+void FillLeaf(LeafPage *leaf, const std::vector<int64_t> &keys, const GenericComparator<8> &comparator) {
+  leaf->Init(1, INVALID_PAGE_ID, static_cast<int>(keys.size()) + 1);
+  GenericKey<8> index_key;
+  RID rid;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    rid.Set(0, static_cast<uint32_t>(key));
+    leaf->Insert(index_key, rid, comparator);
+  }
+}
+
+/** @return the first index whose key is not smaller than key, found by a linear scan */
+int LinearKeyIndex(const LeafPage *leaf, const GenericKey<8> &key, const GenericComparator<8> &comparator) {
+  for (int i = 0; i < leaf->GetSize(); i++) {
+    if (comparator(leaf->KeyAt(i), key) >= 0) {
+      return i;
+    }
+  }
+  return leaf->GetSize();
+}
+
+}  // namespace
+
+TEST(BPlusTreePageTest, Int64KeyBoundTest) {
+  struct Entry {
+    int64_t key_;
+    int64_t payload_;
+  };
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<int64_t> dist(-50, 50);
+  for (int size = 0; size < 100; size++) {
+    std::vector<Entry> entries(size);
+    for (auto &entry : entries) {
+      entry.key_ = dist(rng);
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.key_ < b.key_; });
+    for (int64_t key : {INT64_MIN, int64_t{-51}, int64_t{-7}, int64_t{0}, int64_t{3}, int64_t{51}, INT64_MAX}) {
+      int lower = 0;
+      int upper = 0;
+      for (const auto &entry : entries) {
+        lower += static_cast<int>(entry.key_ < key);
+        upper += static_cast<int>(entry.key_ <= key);
+      }
+      auto keys = reinterpret_cast<const char *>(entries.data());
+      EXPECT_EQ(lower, Int64KeyBound(keys, sizeof(Entry), sizeof(int64_t), size, key, false));
+      EXPECT_EQ(upper, Int64KeyBound(keys, sizeof(Entry), sizeof(int64_t), size, key, true));
+    }
+  }
+}
+
+TEST(BPlusTreePageTest, LeafKeyIndexTest) {
+  // "a bigint" is searched with integer compares, "a integer" through the comparator
+  for (const char *create : {"a bigint", "a integer"}) {
+    Schema *key_schema = ParseCreateStatement(create);
+    GenericComparator<8> comparator(key_schema);
+    EXPECT_EQ(std::string(create) == "a bigint", comparator.IsInt64Key());
+
+    std::vector<char> data(PAGE_SIZE);
+    auto leaf = reinterpret_cast<LeafPage *>(data.data());
+    std::vector<int64_t> keys;
+    for (int64_t key = 1; key <= 200; key++) {
+      keys.push_back(key * 3);
+    }
+    FillLeaf(leaf, keys, comparator);
+    ASSERT_EQ(200, leaf->GetSize());
+
+    GenericKey<8> index_key;
+    RID rid;
+    for (int64_t key = 0; key <= 605; key++) {
+      index_key.SetFromInteger(key);
+      EXPECT_EQ(LinearKeyIndex(leaf, index_key, comparator), leaf->KeyIndex(index_key, comparator));
+      EXPECT_EQ(key % 3 == 0 && key > 0 && key <= 600, leaf->Lookup(index_key, &rid, comparator));
+    }
+    delete key_schema;
+  }
+}
+
+TEST(BPlusTreePageTest, InternalLookupTest) {
+  for (const char *create : {"a bigint", "a integer"}) {
+    Schema *key_schema = ParseCreateStatement(create);
+    GenericComparator<8> comparator(key_schema);
+
+    std::vector<char> data(PAGE_SIZE);
+    auto internal = reinterpret_cast<InternalPage *>(data.data());
+    internal->Init(1, INVALID_PAGE_ID, 200);
+    // child i covers [10 * i, 10 * (i + 1)), child 0 everything below 10
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(10);
+    internal->PopulateNewRoot(0, index_key, 1);
+    for (page_id_t child = 2; child < 150; child++) {
+      index_key.SetFromInteger(10 * child);
+      internal->InsertNodeAfter(child - 1, index_key, child);
+    }
+    ASSERT_EQ(150, internal->GetSize());
+
+    for (int64_t key = 0; key < 1600; key++) {
+      index_key.SetFromInteger(key);
+      EXPECT_EQ(std::min<int64_t>(key / 10, 149), internal->Lookup(index_key, comparator));
+    }
+    delete key_schema;
+  }
+}
+
+TEST(BPlusTreePageTest, LeafCompressionTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  // as many entries as fit into a leaf uncompressed
+  const auto slots = static_cast<int>((PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<GenericKey<8>, RID>));
+
+  // small keys leave their high-order bytes zero, which are not stored
+  std::vector<char> data(PAGE_SIZE);
+  auto leaf = reinterpret_cast<LeafPage *>(data.data());
+  leaf->Init(1, INVALID_PAGE_ID, 2 * slots);
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < 3 * slots / 2; key++) {
+    keys.push_back(key * 7);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  GenericKey<8> index_key;
+  RID rid;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(leaf->HasRoomFor(index_key));
+    rid.Set(0, static_cast<uint32_t>(key));
+    leaf->Insert(index_key, rid, comparator);
+  }
+  ASSERT_EQ(3 * slots / 2, leaf->GetSize());
+  // a key that uses all bytes widens every entry, so it no longer fits
+  index_key.SetFromInteger(INT64_MAX);
+  EXPECT_FALSE(leaf->HasRoomFor(index_key));
+  for (int i = 0; i < leaf->GetSize(); i++) {
+    EXPECT_EQ(i * 7, leaf->KeyAt(i).ToInt64());
+    EXPECT_EQ(i * 7, leaf->GetItem(i).second.GetSlotNum());
+  }
+
+  // the halves of a split and the merged page are still ordered, whatever their layouts
+  std::vector<char> recipient_data(PAGE_SIZE);
+  auto recipient = reinterpret_cast<LeafPage *>(recipient_data.data());
+  recipient->Init(2, INVALID_PAGE_ID, 2 * slots);
+  leaf->MoveHalfTo(recipient);
+  EXPECT_EQ(3 * slots / 2, leaf->GetSize() + recipient->GetSize());
+  for (int64_t key = 0; key < 3 * slots / 2 * 7; key++) {
+    index_key.SetFromInteger(key);
+    auto page = key < recipient->KeyAt(0).ToInt64() ? leaf : recipient;
+    EXPECT_EQ(key % 7 == 0, page->Lookup(index_key, &rid, comparator));
+  }
+  EXPECT_TRUE(leaf->CanAbsorb(recipient));
+  recipient->MoveAllTo(leaf);
+  EXPECT_EQ(3 * slots / 2, leaf->GetSize());
+  for (int i = 0; i < leaf->GetSize(); i++) {
+    EXPECT_EQ(i * 7, leaf->KeyAt(i).ToInt64());
+  }
+  delete key_schema;
+}
+
+TEST(BPlusTreePageTest, DISABLED_KeySearchBenchmark) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  std::vector<char> data(PAGE_SIZE);
+  auto leaf = reinterpret_cast<LeafPage *>(data.data());
+  // as many keys as a leaf holds before it splits
+  const auto num_keys = static_cast<int64_t>((PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<GenericKey<8>, RID>));
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < num_keys - 1; key++) {
+    keys.push_back(key * 2);
+  }
+  FillLeaf(leaf, keys, comparator);
+
+  const int num_searches = 200000;
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<int64_t> dist(0, 2 * static_cast<int64_t>(keys.size()));
+  std::vector<GenericKey<8>> search_keys(num_searches);
+  for (auto &search_key : search_keys) {
+    search_key.SetFromInteger(dist(rng));
+  }
+
+  auto run = [&](const char *name, auto &&search) {
+    int64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &search_key : search_keys) {
+      checksum += search(search_key);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << name << ": " << num_searches / elapsed.count() << " searches/s (checksum " << checksum << ")"
+              << std::endl;
+  };
+  std::cout << leaf->GetSize() << " keys per leaf" << std::endl;
+  run("linear scan", [&](const GenericKey<8> &key) { return LinearKeyIndex(leaf, key, comparator); });
+  run("binary search", [&](const GenericKey<8> &key) {
+    return KeyBound(leaf->GetSize(), key, comparator, false, [leaf](int index) { return leaf->KeyAt(index); });
+  });
+  run("integer search", [&](const GenericKey<8> &key) { return leaf->KeyIndex(key, comparator); });
+
+  delete key_schema;
+}
+
+}  // namespace bustub